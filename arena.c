@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file arena.c
+ *
+ * @brief A simple bump (arena) allocator for short-lived, per-frame objects
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// The block itself is aligned to a cache line so aligned requests never waste the first bytes
+#define ARENA_BLOCK_ALIGNMENT 64
+
+// Arena lifecycle management
+arena_t* arena_create(size_t capacity) {
+    arena_t* arena = (arena_t*) malloc(sizeof(arena_t));
+    if (NULL == arena) {
+        fprintf(stderr, "Failed to allocate memory for arena_t.\n");
+        return NULL;
+    }
+
+    // aligned_alloc requires the size to be a multiple of the alignment
+    size_t size = (capacity + ARENA_BLOCK_ALIGNMENT - 1) & ~((size_t) ARENA_BLOCK_ALIGNMENT - 1);
+
+    arena->base = (unsigned char*) aligned_alloc(ARENA_BLOCK_ALIGNMENT, size);
+    if (NULL == arena->base) {
+        fprintf(stderr, "Failed to allocate %zu bytes to arena->base.\n", size);
+        free(arena);
+        return NULL;
+    }
+
+    arena->capacity         = size;
+    arena->offset           = 0;
+    arena->high_water       = 0;
+    arena->allocations      = 0;
+    arena->peak_allocations = 0;
+    arena->failures         = 0;
+    arena->resets           = 0;
+
+    return arena;
+}
+
+void arena_free(arena_t* arena) {
+    if (NULL == arena) {
+        return;
+    }
+
+    free(arena->base);
+    free(arena);
+}
+
+// Arena operations
+void* arena_alloc(arena_t* arena, size_t size, size_t alignment) {
+    if (NULL == arena || 0 == alignment || 0 != (alignment & (alignment - 1))) {
+        fprintf(stderr, "Invalid arena allocation with alignment %zu.\n", alignment);
+        return NULL;
+    }
+
+    // Round the current address up to the requested alignment
+    uintptr_t address = (uintptr_t) (arena->base + arena->offset);
+    size_t    padding = (size_t) ((alignment - (address & (alignment - 1))) & (alignment - 1));
+
+    if (padding > arena->capacity - arena->offset
+        || size > arena->capacity - arena->offset - padding) {
+        arena->failures++;
+        fprintf(
+            stderr,
+            "Arena exhausted: requested %zu bytes with %zu of %zu bytes in use.\n",
+            size,
+            arena->offset,
+            arena->capacity
+        );
+        return NULL;
+    }
+
+    void* memory   = arena->base + arena->offset + padding;
+    arena->offset += padding + size;
+    arena->allocations++;
+
+    if (arena->offset > arena->high_water) {
+        arena->high_water = arena->offset;
+    }
+
+    if (arena->allocations > arena->peak_allocations) {
+        arena->peak_allocations = arena->allocations;
+    }
+
+    return memory;
+}
+
+void arena_reset(arena_t* arena) {
+    if (NULL == arena) {
+        return;
+    }
+
+    arena->offset      = 0;
+    arena->allocations = 0;
+    arena->resets++;
+}
+
+void arena_print_stats(const arena_t* arena, const char* label) {
+    if (NULL == arena) {
+        return;
+    }
+
+    fprintf(
+        stderr,
+        "%s: %zu/%zu bytes in use, high-water %zu bytes (%.1f%%), peak %zu allocations, "
+        "%zu failures, %zu resets\n",
+        label ? label : "arena",
+        arena->offset,
+        arena->capacity,
+        arena->high_water,
+        arena->capacity ? 100.0 * (double) arena->high_water / (double) arena->capacity : 0.0,
+        arena->peak_allocations,
+        arena->failures,
+        arena->resets
+    );
+}
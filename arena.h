@@ -0,0 +1,96 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file arena.h
+ *
+ * @brief A simple bump (arena) allocator for short-lived, per-frame objects
+ *
+ * An arena owns one fixed-size block of memory. Allocations bump an offset forward and are never
+ * freed individually; arena_reset() releases everything at once in O(1), typically at the end of a
+ * frame. Objects created with the *_create_in() functions live in an arena and must not be passed
+ * to their regular free functions, except vector_free(), which recognizes arena storage and does
+ * nothing.
+ *
+ * The arena tracks its high-water mark so production builds can size it from real workloads.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+
+/**
+ * @brief A fixed-capacity bump allocator.
+ *
+ * @param base             Start of the memory block owned by the arena.
+ * @param capacity         Size of the memory block in bytes.
+ * @param offset           Number of bytes currently in use.
+ * @param high_water       Largest offset reached since the arena was created.
+ * @param allocations      Number of allocations since the last reset.
+ * @param peak_allocations Largest number of allocations between two resets.
+ * @param failures         Number of allocations that did not fit since the arena was created.
+ * @param resets           Number of times the arena was reset.
+ */
+typedef struct {
+    unsigned char* base;             ///< Start of the memory block owned by the arena.
+    size_t         capacity;         ///< Size of the memory block in bytes.
+    size_t         offset;           ///< Number of bytes currently in use.
+    size_t         high_water;       ///< Largest offset reached since the arena was created.
+    size_t         allocations;      ///< Number of allocations since the last reset.
+    size_t         peak_allocations; ///< Largest number of allocations between two resets.
+    size_t         failures;         ///< Number of allocations that did not fit.
+    size_t         resets;           ///< Number of times the arena was reset.
+} arena_t;
+
+/**
+ * @brief Create a new arena with the given capacity in bytes.
+ *
+ * @param capacity Size of the memory block in bytes.
+ * @return A pointer to the newly created arena, or NULL if allocation fails.
+ */
+arena_t* arena_create(size_t capacity);
+
+/**
+ * @brief Free an arena and every object allocated from it.
+ *
+ * @param arena A pointer to the arena to be freed. If the pointer is NULL, no action is taken.
+ */
+void arena_free(arena_t* arena);
+
+/**
+ * @brief Allocate a block of memory from an arena.
+ *
+ * The memory is not initialized. Fails, rather than growing, when the arena is exhausted so that a
+ * frame never silently falls back to the heap.
+ *
+ * @param arena     Arena to allocate from.
+ * @param size      Number of bytes to allocate.
+ * @param alignment Required alignment in bytes; must be a power of two.
+ * @return A pointer to the allocated memory, or NULL if the arena is exhausted.
+ */
+void* arena_alloc(arena_t* arena, size_t size, size_t alignment);
+
+/**
+ * @brief Release every allocation in an arena at once.
+ *
+ * Runs in O(1): the offset is rewound and the memory is reused by subsequent allocations. Any
+ * object previously allocated from the arena becomes invalid.
+ *
+ * @param arena Arena to reset.
+ */
+void arena_reset(arena_t* arena);
+
+/**
+ * @brief Print the usage statistics of an arena to stderr.
+ *
+ * @param arena Arena to report on.
+ * @param label Name printed alongside the statistics.
+ */
+void arena_print_stats(const arena_t* arena, const char* label);
+
+#endif // ARENA_H
@@ -0,0 +1,315 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file batch.c
+ *
+ * @brief Structure-of-arrays storage for large sets of 2D or 3D points
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "batch.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of floats per VECTOR_ALIGNMENT bytes; each axis is padded to a multiple of this
+#define BATCH_AXIS_GRANULE (VECTOR_ALIGNMENT / sizeof(float))
+
+static bool vector_batch_dimensions_match(const vector_batch_t* batch, const vector_t* vector) {
+    if (NULL == batch || NULL == vector || batch->dimensions != vector->dimensions) {
+        fprintf(stderr, "Vector dimensions do not match the dimensions of the batch.\n");
+        return false;
+    }
+
+    return true;
+}
+
+// Reallocate every axis into one new block with room for capacity points. The x axis sits at the
+// start of the block, so batch->x doubles as the pointer that owns the allocation.
+static bool vector_batch_reserve(vector_batch_t* batch, size_t capacity) {
+    size_t stride = (capacity + BATCH_AXIS_GRANULE - 1) / BATCH_AXIS_GRANULE * BATCH_AXIS_GRANULE;
+    size_t size   = batch->dimensions * stride * sizeof(float);
+
+    float* block = (float*) aligned_alloc(VECTOR_ALIGNMENT, size > 0 ? size : VECTOR_ALIGNMENT);
+    if (NULL == block) {
+        fprintf(stderr, "Failed to allocate %zu bytes to vector_batch_t.\n", size);
+        return false;
+    }
+
+    float* previous = batch->x;
+
+    for (size_t d = 0; d < batch->dimensions; d++) {
+        float* axis = block + d * stride;
+        if (batch->axes[d]) {
+            memcpy(axis, batch->axes[d], batch->count * sizeof(float));
+        }
+        batch->axes[d] = axis;
+    }
+
+    free(previous);
+    batch->capacity = stride;
+
+    return true;
+}
+
+// Batch lifecycle management
+vector_batch_t* vector_batch_create(size_t dimensions, size_t count) {
+    if (dimensions < 2 || dimensions > VECTOR_BATCH_MAX_DIMENSIONS) {
+        fprintf(stderr, "A vector batch holds 2D or 3D points, not %zuD points.\n", dimensions);
+        return NULL;
+    }
+
+    vector_batch_t* batch = (vector_batch_t*) calloc(1, sizeof(vector_batch_t));
+    if (NULL == batch) {
+        fprintf(stderr, "Failed to allocate memory for vector_batch_t.\n");
+        return NULL;
+    }
+
+    batch->dimensions = dimensions;
+
+    if (!vector_batch_resize(batch, count)) {
+        free(batch);
+        return NULL;
+    }
+
+    return batch;
+}
+
+void vector_batch_free(vector_batch_t* batch) {
+    if (NULL == batch) {
+        return;
+    }
+
+    free(batch->x); // owns the block holding every axis
+    free(batch);
+}
+
+bool vector_batch_resize(vector_batch_t* batch, size_t count) {
+    if (NULL == batch) {
+        return false;
+    }
+
+    // Grow geometrically so repeated resizing is amortized O(1) per point
+    if (count > batch->capacity || NULL == batch->x) {
+        size_t capacity = batch->capacity * 2;
+        if (capacity < count) {
+            capacity = count;
+        }
+
+        if (!vector_batch_reserve(batch, capacity)) {
+            return false;
+        }
+    }
+
+    // New points start at the origin
+    for (size_t d = 0; count > batch->count && d < batch->dimensions; d++) {
+        memset(batch->axes[d] + batch->count, 0, (count - batch->count) * sizeof(float));
+    }
+
+    batch->count = count;
+
+    return true;
+}
+
+bool vector_batch_set(vector_batch_t* batch, size_t index, const vector_t* point) {
+    if (!vector_batch_dimensions_match(batch, point) || index >= batch->count) {
+        return false;
+    }
+
+    for (size_t d = 0; d < batch->dimensions; d++) {
+        batch->axes[d][index] = point->elements[d];
+    }
+
+    return true;
+}
+
+bool vector_batch_get(const vector_batch_t* batch, size_t index, vector_t* point) {
+    if (!vector_batch_dimensions_match(batch, point) || index >= batch->count) {
+        return false;
+    }
+
+    for (size_t d = 0; d < batch->dimensions; d++) {
+        point->elements[d] = batch->axes[d][index];
+    }
+
+    return true;
+}
+
+// Batched operations
+bool vector_batch_add(vector_batch_t* batch, const vector_t* offset) {
+    if (!vector_batch_dimensions_match(batch, offset)) {
+        return false;
+    }
+
+    for (size_t d = 0; d < batch->dimensions; d++) {
+        float* restrict axis  = batch->axes[d];
+        const float     delta = offset->elements[d];
+        for (size_t i = 0; i < batch->count; i++) {
+            axis[i] += delta;
+        }
+    }
+
+    return true;
+}
+
+void vector_batch_scale(vector_batch_t* batch, float scalar) {
+    if (NULL == batch) {
+        return;
+    }
+
+    for (size_t d = 0; d < batch->dimensions; d++) {
+        float* restrict axis = batch->axes[d];
+        for (size_t i = 0; i < batch->count; i++) {
+            axis[i] *= scalar;
+        }
+    }
+}
+
+void vector_batch_normalize(vector_batch_t* batch) {
+    if (NULL == batch) {
+        return;
+    }
+
+    float* restrict x = batch->x;
+    float* restrict y = batch->y;
+
+    // Dividing by the largest absolute component first puts the squared length in [1, 3], so it
+    // can neither overflow nor underflow. A zero-length point adds 1 to both its divisor and its
+    // squared length and stays at the origin; adding rather than branching keeps the loops
+    // vectorizable.
+    if (2 == batch->dimensions) {
+        for (size_t i = 0; i < batch->count; i++) {
+            float ax      = fabsf(x[i]);
+            float ay      = fabsf(y[i]);
+            float largest = ax > ay ? ax : ay;
+            float origin  = (float) (0.0f == largest);
+            float sx      = x[i] / (largest + origin);
+            float sy      = y[i] / (largest + origin);
+            float scale   = 1.0f / sqrtf(sx * sx + sy * sy + origin);
+            x[i]          = sx * scale;
+            y[i]          = sy * scale;
+        }
+        return;
+    }
+
+    float* restrict z = batch->z;
+    for (size_t i = 0; i < batch->count; i++) {
+        float ax      = fabsf(x[i]);
+        float ay      = fabsf(y[i]);
+        float az      = fabsf(z[i]);
+        float largest = ax > ay ? ax : ay;
+        largest       = largest > az ? largest : az;
+        float origin  = (float) (0.0f == largest);
+        float sx      = x[i] / (largest + origin);
+        float sy      = y[i] / (largest + origin);
+        float sz      = z[i] / (largest + origin);
+        float scale   = 1.0f / sqrtf(sx * sx + sy * sy + sz * sz + origin);
+        x[i]          = sx * scale;
+        y[i]          = sy * scale;
+        z[i]          = sz * scale;
+    }
+}
+
+bool vector_batch_distance(const vector_batch_t* batch, const vector_t* point, float* distances) {
+    if (!vector_batch_dimensions_match(batch, point) || NULL == distances) {
+        return false;
+    }
+
+    const float* restrict x   = batch->x;
+    const float* restrict y   = batch->y;
+    float* restrict       out = distances;
+    const float           px  = point->elements[0];
+    const float           py  = point->elements[1];
+
+    if (2 == batch->dimensions) {
+        for (size_t i = 0; i < batch->count; i++) {
+            float dx = x[i] - px;
+            float dy = y[i] - py;
+            out[i]   = sqrtf(dx * dx + dy * dy);
+        }
+        return true;
+    }
+
+    const float* restrict z  = batch->z;
+    const float           pz = point->elements[2];
+    for (size_t i = 0; i < batch->count; i++) {
+        float dx = x[i] - px;
+        float dy = y[i] - py;
+        float dz = z[i] - pz;
+        out[i]   = sqrtf(dx * dx + dy * dy + dz * dz);
+    }
+
+    return true;
+}
+
+bool vector_batch_dot(const vector_batch_t* batch, const vector_t* direction, float* products) {
+    if (!vector_batch_dimensions_match(batch, direction) || NULL == products) {
+        return false;
+    }
+
+    const float* restrict x   = batch->x;
+    const float* restrict y   = batch->y;
+    float* restrict       out = products;
+    const float           dx  = direction->elements[0];
+    const float           dy  = direction->elements[1];
+
+    if (2 == batch->dimensions) {
+        for (size_t i = 0; i < batch->count; i++) {
+            out[i] = x[i] * dx + y[i] * dy;
+        }
+        return true;
+    }
+
+    const float* restrict z  = batch->z;
+    const float           dz = direction->elements[2];
+    for (size_t i = 0; i < batch->count; i++) {
+        out[i] = x[i] * dx + y[i] * dy + z[i] * dz;
+    }
+
+    return true;
+}
+
+// SDL interoperability
+void vector_batch_to_fpoints(const vector_batch_t* batch, float* points) {
+    if (NULL == batch || NULL == points) {
+        return;
+    }
+
+    const float* restrict x   = batch->x;
+    const float* restrict y   = batch->y;
+    float* restrict       out = points;
+
+    for (size_t i = 0; i < batch->count; i++) {
+        out[2 * i + 0] = x[i];
+        out[2 * i + 1] = y[i];
+    }
+}
+
+bool vector_batch_from_fpoints(vector_batch_t* batch, const float* points, size_t count) {
+    if (NULL == batch || NULL == points || 2 != batch->dimensions) {
+        fprintf(stderr, "Interleaved points can only be loaded into a 2D batch.\n");
+        return false;
+    }
+
+    if (!vector_batch_resize(batch, count)) {
+        return false;
+    }
+
+    float* restrict       x  = batch->x;
+    float* restrict       y  = batch->y;
+    const float* restrict in = points;
+
+    for (size_t i = 0; i < count; i++) {
+        x[i] = in[2 * i + 0];
+        y[i] = in[2 * i + 1];
+    }
+
+    return true;
+}
@@ -0,0 +1,179 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file batch.h
+ *
+ * @brief Structure-of-arrays storage for large sets of 2D or 3D points
+ *
+ * A vector_batch_t stores every x coordinate in one array, every y coordinate in another, and so
+ * on, rather than one heap-allocated vector_t per point. Each batched operation walks the arrays
+ * once with unit stride, which the compiler auto-vectorizes, and millions of points cost a single
+ * allocation.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @brief Maximum number of dimensions of the points in a batch.
+ */
+#define VECTOR_BATCH_MAX_DIMENSIONS 3
+
+/**
+ * @brief A batch of 2D or 3D points stored as a structure of arrays.
+ *
+ * All axes share one allocation and each axis array starts on a VECTOR_ALIGNMENT boundary. For 2D
+ * batches z is NULL. The axes can be addressed by name (x, y, z) or by index (axes[0] to axes[2]).
+ *
+ * @param x          The x coordinate of every point.
+ * @param y          The y coordinate of every point.
+ * @param z          The z coordinate of every point, or NULL for 2D batches.
+ * @param count      The number of points in the batch.
+ * @param capacity   The number of points the arrays can hold before they must grow.
+ * @param dimensions The number of dimensions of each point (2 or 3).
+ */
+typedef struct {
+    union {
+        struct {
+            float* x; ///< The x coordinate of every point.
+            float* y; ///< The y coordinate of every point.
+            float* z; ///< The z coordinate of every point, or NULL for 2D batches.
+        };
+
+        float* axes[VECTOR_BATCH_MAX_DIMENSIONS]; ///< The coordinate arrays indexed by axis.
+    };
+
+    size_t count;      ///< The number of points in the batch.
+    size_t capacity;   ///< The number of points the arrays can hold before they must grow.
+    size_t dimensions; ///< The number of dimensions of each point (2 or 3).
+} vector_batch_t;
+
+// Batch lifecycle management
+
+/**
+ * @brief Create a batch of count points, all set to the origin.
+ *
+ * @param dimensions Number of dimensions of each point (2 or 3)
+ * @param count Number of points in the batch
+ * @return A pointer to the newly created batch, or NULL on failure
+ */
+vector_batch_t* vector_batch_create(size_t dimensions, size_t count);
+
+/**
+ * @brief Free a batch and its coordinate arrays.
+ *
+ * @param batch A pointer to the batch to be freed. If the pointer is NULL, no action is taken.
+ */
+void vector_batch_free(vector_batch_t* batch);
+
+/**
+ * @brief Change the number of points in a batch.
+ *
+ * Growing beyond the capacity reallocates the arrays geometrically, so repeated growth is amortized
+ * O(1) per point. New points are set to the origin. Shrinking keeps the capacity.
+ *
+ * @param batch Batch to resize
+ * @param count New number of points
+ * @return true on success, false if the arrays could not be grown
+ */
+bool vector_batch_resize(vector_batch_t* batch, size_t count);
+
+/**
+ * @brief Copy a point from a vector into the batch.
+ *
+ * @param batch Batch to write to
+ * @param index Index of the point
+ * @param point Vector with the same number of dimensions as the batch
+ * @return true on success, false if the index or dimensions are invalid
+ */
+bool vector_batch_set(vector_batch_t* batch, size_t index, const vector_t* point);
+
+/**
+ * @brief Copy a point from the batch into a vector.
+ *
+ * @param batch Batch to read from
+ * @param index Index of the point
+ * @param point Destination vector with the same number of dimensions as the batch
+ * @return true on success, false if the index or dimensions are invalid
+ */
+bool vector_batch_get(const vector_batch_t* batch, size_t index, vector_t* point);
+
+// Batched operations
+
+/**
+ * @brief Translate every point in the batch by an offset vector, in place.
+ *
+ * @return true on success, false if the dimensions do not match
+ */
+bool vector_batch_add(vector_batch_t* batch, const vector_t* offset);
+
+/**
+ * @brief Scale every point in the batch by a factor, in place.
+ */
+void vector_batch_scale(vector_batch_t* batch, float scalar);
+
+/**
+ * @brief Normalize every point in the batch to unit length, in place.
+ *
+ * Each point is divided by its largest absolute component before its length is taken, so any
+ * finite point, from subnormal to FLT_MAX components, normalizes without overflow or underflow.
+ * Zero-length points are left at the origin instead of failing the whole batch. Points with an
+ * infinite or NaN component are not normalized and come out with NaN components.
+ */
+void vector_batch_normalize(vector_batch_t* batch);
+
+/**
+ * @brief Distance from every point in the batch to a reference point.
+ *
+ * @param batch Input batch
+ * @param point Reference point with the same number of dimensions as the batch
+ * @param distances Output array of batch->count floats
+ * @return true on success, false if the dimensions do not match
+ */
+bool vector_batch_distance(const vector_batch_t* batch, const vector_t* point, float* distances);
+
+/**
+ * @brief Dot product of every point in the batch with a direction vector.
+ *
+ * @param batch Input batch
+ * @param direction Direction with the same number of dimensions as the batch
+ * @param products Output array of batch->count floats
+ * @return true on success, false if the dimensions do not match
+ */
+bool vector_batch_dot(const vector_batch_t* batch, const vector_t* direction, float* products);
+
+// SDL interoperability
+
+/**
+ * @brief Write the x and y coordinates of every point as interleaved pairs.
+ *
+ * The output layout is identical to an array of SDL_FPoint, so a caller-owned SDL_FPoint buffer
+ * can be passed as (float*) points and handed straight to SDL_RenderDrawPointsF() or
+ * SDL_RenderDrawLinesF() without any further conversion or allocation.
+ *
+ * @param batch Input batch (z is ignored)
+ * @param points Output array of 2 * batch->count floats
+ */
+void vector_batch_to_fpoints(const vector_batch_t* batch, float* points);
+
+/**
+ * @brief Load interleaved x and y pairs, such as an SDL_FPoint array, into a 2D batch.
+ *
+ * @param batch 2D batch; resized to count points
+ * @param points Input array of 2 * count floats
+ * @param count Number of points
+ * @return true on success, false if the batch is not 2D or could not be resized
+ */
+bool vector_batch_from_fpoints(vector_batch_t* batch, const float* points, size_t count);
+
+#endif // BATCH_H
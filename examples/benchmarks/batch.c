@@ -0,0 +1,165 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/batch.c
+ *
+ * @brief Measure ns/point of the vector_batch_t operations against one vector_t per point.
+ *
+ * Usage: bench_batch [points]
+ *
+ * The same 3D points (default 2^20) are stored twice: as a vector_batch_t, and as an array of
+ * heap-allocated vector_t operated on one at a time with the allocation-free vector.h functions.
+ * For add, scale, normalize, distance, dot and the conversion to interleaved SDL_FPoint pairs, the
+ * best of five trials is reported for each layout.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../batch.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Both layouts of the same points, plus the operands and outputs shared by every operation
+typedef struct {
+    size_t          n;
+    vector_batch_t* batch;
+    vector_t**      points;
+    vector_t*       offset;
+    float*          out; ///< n floats for distance and dot, 2 * n for the SDL_FPoint pairs
+} bench_t;
+
+// Structure of arrays
+static void batch_add(bench_t* bench) {
+    vector_batch_add(bench->batch, bench->offset);
+}
+
+static void batch_scale(bench_t* bench) {
+    vector_batch_scale(bench->batch, 1.0001f);
+}
+
+static void batch_normalize(bench_t* bench) {
+    vector_batch_normalize(bench->batch);
+}
+
+static void batch_distance(bench_t* bench) {
+    vector_batch_distance(bench->batch, bench->offset, bench->out);
+}
+
+static void batch_dot(bench_t* bench) {
+    vector_batch_dot(bench->batch, bench->offset, bench->out);
+}
+
+static void batch_fpoints(bench_t* bench) {
+    vector_batch_to_fpoints(bench->batch, bench->out);
+}
+
+// One vector_t per point
+static void vectors_add(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        vector_vector_add_into(bench->points[i], bench->points[i], bench->offset);
+    }
+}
+
+static void vectors_scale(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        vector_scale_into(bench->points[i], bench->points[i], 1.0001f);
+    }
+}
+
+static void vectors_normalize(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        vector_normalize_into(bench->points[i], bench->points[i]);
+    }
+}
+
+static void vectors_distance(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        bench->out[i] = vector_distance(bench->points[i], bench->offset);
+    }
+}
+
+static void vectors_dot(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        bench->out[i] = vector_dot_product(bench->points[i], bench->offset);
+    }
+}
+
+static void vectors_fpoints(bench_t* bench) {
+    for (size_t i = 0; i < bench->n; i++) {
+        bench->out[2 * i + 0] = bench->points[i]->elements[0];
+        bench->out[2 * i + 1] = bench->points[i]->elements[1];
+    }
+}
+
+// Returns the best ns/point over a number of repetitions
+static double time_operation(void (*operation)(bench_t*), bench_t* bench) {
+    double best;
+    BENCH_BEST(best, 5, 1 + (size_t) 2e7 / bench->n, operation(bench));
+    return best / (double) bench->n;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1 << 20;
+
+    bench_t bench = {
+        .n      = n,
+        .batch  = vector_batch_create(3, n),
+        .points = (vector_t**) calloc(n, sizeof(vector_t*)),
+        .offset = vector_create(3),
+        .out    = (float*) malloc(2 * n * sizeof(float)),
+    };
+    if (NULL == bench.batch || NULL == bench.points || NULL == bench.offset || NULL == bench.out) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bench.points[i] = vector_create(3);
+        if (NULL == bench.points[i]) {
+            return EXIT_FAILURE;
+        }
+        for (size_t d = 0; d < 3; d++) {
+            bench.points[i]->elements[d] = (float) ((i + d) % 97) - 48.0f;
+        }
+        vector_batch_set(bench.batch, i, bench.points[i]);
+    }
+    bench.offset->elements[0] = 0.25f;
+    bench.offset->elements[1] = -0.5f;
+    bench.offset->elements[2] = 1.0f;
+
+    const struct {
+        const char* name;
+        void (*batch)(bench_t*);
+        void (*vectors)(bench_t*);
+    } operations[] = {
+        {"add", batch_add, vectors_add},
+        {"scale", batch_scale, vectors_scale},
+        {"normalize", batch_normalize, vectors_normalize},
+        {"distance", batch_distance, vectors_distance},
+        {"dot", batch_dot, vectors_dot},
+        {"to_fpoints", batch_fpoints, vectors_fpoints},
+    };
+
+    printf("%zu points\n", n);
+    printf("%-12s %16s %16s %8s\n", "operation", "vector_t ns/pt", "batch ns/pt", "speedup");
+
+    for (size_t o = 0; o < sizeof(operations) / sizeof(operations[0]); o++) {
+        double vectors = time_operation(operations[o].vectors, &bench);
+        double batch   = time_operation(operations[o].batch, &bench);
+        printf(
+            "%-12s %16.3f %16.3f %7.2fx\n", operations[o].name, vectors, batch, vectors / batch
+        );
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        vector_free(bench.points[i]);
+    }
+    free(bench.points);
+    free(bench.out);
+    vector_free(bench.offset);
+    vector_batch_free(bench.batch);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/bench.h
+ *
+ * @brief Timing helpers shared by the benchmark programs.
+ *
+ * Every benchmark reports the best of several trials, since the minimum is the measurement least
+ * disturbed by the scheduler, interrupts and cold caches. BENCH_BEST runs a fixed number of trials;
+ * BENCH_BEST_WITHIN keeps running single-call trials until a time budget is spent, for operations
+ * whose cost spans several orders of magnitude with the problem size.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * @brief Monotonic wall-clock time in nanoseconds.
+ */
+static inline double bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/**
+ * @brief Set best to the fewest nanoseconds one execution of the statement took.
+ *
+ * Each of trials trials runs the statement repetitions times back to back and is averaged over
+ * them, so short operations are timed well above the resolution of the clock.
+ */
+#define BENCH_BEST(best, trials, repetitions, ...)                                          \
+    do {                                                                                    \
+        (best) = 1e300;                                                                     \
+        for (int bench_trial = 0; bench_trial < (trials); bench_trial++) {                  \
+            double bench_start = bench_now_ns();                                            \
+            for (size_t bench_r = 0; bench_r < (size_t) (repetitions); bench_r++) {         \
+                __VA_ARGS__;                                                                \
+            }                                                                               \
+            double bench_elapsed = (bench_now_ns() - bench_start) / (double) (repetitions); \
+            (best)               = bench_elapsed < (best) ? bench_elapsed : (best);         \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * @brief Set best to the fewest nanoseconds one execution of the statement took.
+ *
+ * Runs the statement once per trial, at least twice and at most 100 times, until budget_ns
+ * nanoseconds have been spent in it.
+ */
+#define BENCH_BEST_WITHIN(best, budget_ns, ...)                                      \
+    do {                                                                             \
+        double bench_total = 0.0;                                                    \
+        (best)             = 1e300;                                                  \
+        for (int bench_trial = 0; bench_trial < 100; bench_trial++) {                \
+            if (bench_trial >= 2 && bench_total >= (budget_ns)) {                    \
+                break;                                                               \
+            }                                                                        \
+            double bench_start = bench_now_ns();                                     \
+            __VA_ARGS__;                                                             \
+            double bench_elapsed  = bench_now_ns() - bench_start;                    \
+            bench_total          += bench_elapsed;                                   \
+            (best)                = bench_elapsed < (best) ? bench_elapsed : (best); \
+        }                                                                            \
+    } while (0)
+
+#endif // BENCH_H
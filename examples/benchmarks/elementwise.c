@@ -0,0 +1,100 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/elementwise.c
+ *
+ * @brief Measure ns/element of the element-wise vector executors.
+ *
+ * The "generic" column passes a user-defined operation, which forces one indirect call per element
+ * (the behavior before the specialized kernels existed). The "specialized" column passes the
+ * scalar_* helpers, which the executors route to inlined, vectorizable loops.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Opaque to the executors, so they must fall back to calling through the pointer
+static float generic_add(float x, float y) {
+    return x + y;
+}
+
+static float generic_multiply(float x, float y) {
+    return x * y;
+}
+
+static float generic_divide(float x, float y) {
+    return x / y;
+}
+
+// Returns the best ns/element over a number of repetitions
+static double time_vector_operation(
+    vector_t* dst, const vector_t* a, const vector_t* b, float (*operation)(float, float)
+) {
+    const size_t n = a->dimensions;
+    double       best;
+    BENCH_BEST(
+        best, 5, 1 + (size_t) 5e7 / n, vector_elementwise_operation_into(dst, a, b, operation)
+    );
+    return best / (double) n;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t sizes[] = {1024, 65536, 1048576};
+
+    const struct {
+        const char* name;
+        float (*generic)(float, float);
+        float (*specialized)(float, float);
+    } operations[] = {
+        {"add", generic_add, scalar_add},
+        {"multiply", generic_multiply, scalar_multiply},
+        {"divide", generic_divide, scalar_divide},
+    };
+
+    printf(
+        "%-10s %10s %16s %16s %8s\n",
+        "operation",
+        "elements",
+        "generic ns/el",
+        "special ns/el",
+        "speedup"
+    );
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        vector_t* a   = vector_create(sizes[s]);
+        vector_t* b   = vector_create(sizes[s]);
+        vector_t* dst = vector_create(sizes[s]);
+        if (NULL == a || NULL == b || NULL == dst) {
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < sizes[s]; i++) {
+            a->elements[i] = (float) (i % 97) + 0.5f;
+            b->elements[i] = (float) (i % 89) + 1.0f; // never zero
+        }
+
+        for (size_t o = 0; o < sizeof(operations) / sizeof(operations[0]); o++) {
+            double generic     = time_vector_operation(dst, a, b, operations[o].generic);
+            double specialized = time_vector_operation(dst, a, b, operations[o].specialized);
+            printf(
+                "%-10s %10zu %16.3f %16.3f %7.2fx\n",
+                operations[o].name,
+                sizes[s],
+                generic,
+                specialized,
+                generic / specialized
+            );
+        }
+
+        vector_free(a);
+        vector_free(b);
+        vector_free(dst);
+    }
+
+    return EXIT_SUCCESS;
+}
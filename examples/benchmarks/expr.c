@@ -0,0 +1,138 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/expr.c
+ *
+ * @brief Compare chained element-wise calls against one fused expression.
+ *
+ * Two chains are timed at sizes from L1-resident to well beyond the last-level cache:
+ * - fma:   (a * b) + c
+ * - chain: ((a * b + c) * 0.5) - d
+ *
+ * The "chained" column calls the *_into executors one operation at a time through a temporary
+ * vector, which sweeps memory once per operation. The "fused" column evaluates an expr_t, which
+ * reads each input once and writes the output once.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../expr.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    vector_t* a;
+    vector_t* b;
+    vector_t* c;
+    vector_t* d;
+    vector_t* temporary;
+    vector_t* dst;
+} operands_t;
+
+static void chained_fma(operands_t* o) {
+    vector_vector_multiply_into(o->temporary, o->a, o->b);
+    vector_vector_add_into(o->dst, o->temporary, o->c);
+}
+
+static void chained_chain(operands_t* o) {
+    vector_vector_multiply_into(o->temporary, o->a, o->b);
+    vector_vector_add_into(o->temporary, o->temporary, o->c);
+    vector_scalar_multiply_into(o->temporary, o->temporary, 0.5f);
+    vector_vector_subtract_into(o->dst, o->temporary, o->d);
+}
+
+static void fused_fma(operands_t* o) {
+    expr_t expr;
+    expr_init(&expr, o->a);
+    expr_vector(&expr, o->b, scalar_multiply);
+    expr_vector(&expr, o->c, scalar_add);
+    expr_evaluate_into(o->dst, &expr);
+}
+
+static void fused_chain(operands_t* o) {
+    expr_t expr;
+    expr_init(&expr, o->a);
+    expr_vector(&expr, o->b, scalar_multiply);
+    expr_vector(&expr, o->c, scalar_add);
+    expr_scalar(&expr, 0.5f, scalar_multiply);
+    expr_vector(&expr, o->d, scalar_subtract);
+    expr_evaluate_into(o->dst, &expr);
+}
+
+// Returns the best ns/element over a number of repetitions
+static double time_function(void (*function)(operands_t*), operands_t* o) {
+    const size_t n = o->a->dimensions;
+    double       best;
+    BENCH_BEST(best, 5, 1 + (size_t) 5e7 / n, function(o));
+    return best / (double) n;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t sizes[] = {1024, 65536, 1048576, 16777216};
+
+    const struct {
+        const char* name;
+        void (*chained)(operands_t*);
+        void (*fused)(operands_t*);
+    } expressions[] = {
+        {"fma", chained_fma, fused_fma},
+        {"chain", chained_chain, fused_chain},
+    };
+
+    printf(
+        "%-10s %10s %16s %16s %8s\n",
+        "expression",
+        "elements",
+        "chained ns/el",
+        "fused ns/el",
+        "speedup"
+    );
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const size_t n = sizes[s];
+        operands_t   o = {
+            vector_create(n),
+            vector_create(n),
+            vector_create(n),
+            vector_create(n),
+            vector_create(n),
+            vector_create(n),
+        };
+        if (NULL == o.a || NULL == o.b || NULL == o.c || NULL == o.d || NULL == o.temporary
+            || NULL == o.dst) {
+            return EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            o.a->elements[i] = (float) (i % 97) + 0.5f;
+            o.b->elements[i] = (float) (i % 89) - 44.0f;
+            o.c->elements[i] = (float) (i % 83) * 0.25f;
+            o.d->elements[i] = (float) (i % 79) - 3.0f;
+        }
+
+        for (size_t e = 0; e < sizeof(expressions) / sizeof(expressions[0]); e++) {
+            double chained = time_function(expressions[e].chained, &o);
+            double fused   = time_function(expressions[e].fused, &o);
+            printf(
+                "%-10s %10zu %16.3f %16.3f %7.2fx\n",
+                expressions[e].name,
+                n,
+                chained,
+                fused,
+                chained / fused
+            );
+        }
+
+        vector_free(o.a);
+        vector_free(o.b);
+        vector_free(o.c);
+        vector_free(o.d);
+        vector_free(o.temporary);
+        vector_free(o.dst);
+    }
+
+    return EXIT_SUCCESS;
+}
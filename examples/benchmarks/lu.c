@@ -0,0 +1,188 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/lu.c
+ *
+ * @brief Measure the speed and accuracy of LU factorization and solves.
+ *
+ * Usage: bench_lu [max size] [max naive size]
+ *
+ * Square sizes double from 64 up to the max size (default 2048). Each size reports:
+ *
+ * - GFLOP/s of lu_factor(), counting 2n³/3 flops, and of a textbook unblocked factorization with
+ *   the same pivoting, which only runs up to the max naive size (default 1024) because it is slow;
+ * - µs for one lu_solve_vector(), and GFLOP/s of lu_solve() for n right-hand sides at once,
+ *   counting 2n³ flops, both reusing the one factorization;
+ * - the scaled residual |b - A x|∞ / (|A|∞ |x|∞ n ε) of the vector solve, which stays of order 1
+ *   for a backward stable solver;
+ * - the largest |A A⁻¹ - I| element of the inverse, also only up to the max naive size.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../lu.h"
+#include "../../matrix.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void fill(matrix_t* matrix, unsigned seed) {
+    for (size_t row = 0; row < matrix->rows; row++) {
+        for (size_t column = 0; column < matrix->columns; column++) {
+            seed                            = seed * 1664525u + 1013904223u;
+            *matrix_at(matrix, row, column) = (float) (seed >> 8) / (float) (1u << 24) - 0.5f;
+        }
+    }
+}
+
+// The reference: one column at a time, pivoting on whole rows
+static void naive_factor(matrix_t* a) {
+    const size_t n = a->rows;
+
+    for (size_t j = 0; j < n; j++) {
+        size_t pivot = j;
+        for (size_t i = j + 1; i < n; i++) {
+            if (fabsf(*matrix_at(a, i, j)) > fabsf(*matrix_at(a, pivot, j))) {
+                pivot = i;
+            }
+        }
+        float* u_j = matrix_row(a, j);
+        float* a_p = matrix_row(a, pivot);
+        for (size_t c = 0; c < n; c++) {
+            float t = u_j[c];
+            u_j[c]  = a_p[c];
+            a_p[c]  = t;
+        }
+
+        for (size_t i = j + 1; i < n; i++) {
+            float*      a_i  = matrix_row(a, i);
+            const float l_ij = a_i[j] /= u_j[j];
+            for (size_t c = j + 1; c < n; c++) {
+                a_i[c] -= l_ij * u_j[c];
+            }
+        }
+    }
+}
+
+// |b - A x|∞ / (|A|∞ |x|∞ n ε), accumulated in double
+static double scaled_residual(const matrix_t* a, const vector_t* x, const vector_t* b) {
+    double residual = 0.0, norm_a = 0.0, norm_x = 0.0;
+
+    for (size_t i = 0; i < a->rows; i++) {
+        double sum = b->elements[i], row = 0.0;
+        for (size_t j = 0; j < a->columns; j++) {
+            sum -= (double) *matrix_at(a, i, j) * x->elements[j];
+            row += fabs(*matrix_at(a, i, j));
+        }
+        residual = fmax(residual, fabs(sum));
+        norm_a   = fmax(norm_a, row);
+        norm_x   = fmax(norm_x, fabs(x->elements[i]));
+    }
+
+    return residual / (norm_a * norm_x * (double) a->rows * FLT_EPSILON);
+}
+
+// Largest |(A A⁻¹ - I)ij|, accumulated in double
+static double inverse_error(const matrix_t* a, const matrix_t* inverse) {
+    double error = 0.0;
+
+    for (size_t i = 0; i < a->rows; i++) {
+        for (size_t j = 0; j < a->columns; j++) {
+            double sum = i == j ? -1.0 : 0.0;
+            for (size_t p = 0; p < a->columns; p++) {
+                sum += (double) *matrix_at(a, i, p) * *matrix_at(inverse, p, j);
+            }
+            error = fmax(error, fabs(sum));
+        }
+    }
+
+    return error;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_size  = argc > 1 ? strtoull(argv[1], NULL, 10) : 2048;
+    size_t max_naive = argc > 2 ? strtoull(argv[2], NULL, 10) : 1024;
+
+    printf(
+        "%6s %12s %12s %10s %12s %10s %12s\n",
+        "size",
+        "lu GFLOP/s",
+        "naive",
+        "solve µs",
+        "nrhs GFLOP/s",
+        "residual",
+        "inverse err"
+    );
+
+    for (size_t n = 64; n <= max_size; n *= 2) {
+        matrix_t* a = matrix_create(n, n);
+        matrix_t* b = matrix_create(n, n);
+        vector_t* v = vector_create(n);
+        vector_t* x = vector_create(n);
+        if (NULL == a || NULL == b || NULL == v || NULL == x) {
+            return EXIT_FAILURE;
+        }
+        fill(a, (unsigned) n);
+        fill(b, (unsigned) n + 1);
+        for (size_t i = 0; i < n; i++) {
+            v->elements[i] = *matrix_at(b, i, 0);
+        }
+
+        const double factor_flops = 2.0 * (double) n * (double) n * (double) n / 3.0;
+        const int    trials       = n <= 256 ? 10 : 3;
+
+        // Each trial also frees the previous factorization, which is negligible next to factoring
+        double best_factor;
+        lu_t*  lu = NULL;
+        BENCH_BEST(best_factor, trials, 1, lu_free(lu); lu = lu_factor(a));
+        if (NULL == lu) {
+            return EXIT_FAILURE;
+        }
+
+        double naive = NAN;
+        if (n <= max_naive) {
+            matrix_t* copy  = matrix_deep_copy(a);
+            double    start = bench_now_ns();
+            naive_factor(copy);
+            naive = factor_flops / (bench_now_ns() - start);
+            matrix_free(copy);
+        }
+
+        double best_vector;
+        BENCH_BEST(best_vector, trials, 1, lu_solve_vector_into(x, lu, v));
+
+        double    start = bench_now_ns();
+        matrix_t* xs    = lu_solve(lu, b);
+        double    nrhs  = 2.0 * (double) n * (double) n * (double) n / (bench_now_ns() - start);
+
+        matrix_t* inverse = lu_inverse(lu);
+        if (NULL == xs || NULL == inverse) {
+            return EXIT_FAILURE;
+        }
+
+        printf(
+            "%6zu %12.2f %12.2f %10.1f %12.2f %10.3f %12.3g\n",
+            n,
+            factor_flops / best_factor,
+            naive,
+            best_vector / 1e3,
+            nrhs,
+            scaled_residual(a, x, v),
+            n <= max_naive ? inverse_error(a, inverse) : NAN
+        );
+
+        lu_free(lu);
+        matrix_free(a);
+        matrix_free(b);
+        matrix_free(xs);
+        matrix_free(inverse);
+        vector_free(v);
+        vector_free(x);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/mat4.c
+ *
+ * @brief Measure batch 4x4 transforms and projections of vertex arrays.
+ *
+ * Usage: bench_mat4 [points]
+ *
+ * Pushes the points (default 2^20) through a model-view-projection matrix with every mat4 batch
+ * function, once with the portable kernels and once with the kernels of the detected SIMD level,
+ * and reports ns/point for each.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../mat4.h"
+#include "../../simd.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    mat4_t  mvp;
+    float*  x;
+    float*  y;
+    float*  z;
+    float*  out[4];
+    vec3_t* points;
+    vec4_t* clip;
+    vec2_t* screen;
+    size_t  n;
+} operands_t;
+
+static void run_transform_soa(operands_t* o) {
+    mat4_transform_soa(&o->mvp, o->x, o->y, o->z, o->out[0], o->out[1], o->out[2], o->out[3], o->n);
+}
+
+static void run_transform_aos(operands_t* o) {
+    mat4_transform_aos(&o->mvp, o->points, o->clip, o->n);
+}
+
+static void run_project_soa(operands_t* o) {
+    mat4_project_soa(&o->mvp, o->x, o->y, o->z, o->screen, 640.0f, 480.0f, o->n);
+}
+
+static void run_project_aos(operands_t* o) {
+    mat4_project_aos(&o->mvp, o->points, o->screen, 640.0f, 480.0f, o->n);
+}
+
+// Returns the best ns/point over a few repetitions
+static double time_operation(void (*operation)(operands_t*), operands_t* o) {
+    double best;
+    BENCH_BEST(best, 10, 1, operation(o));
+    return best / (double) o->n;
+}
+
+int main(int argc, char* argv[]) {
+    operands_t o = {0};
+    o.n          = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t) 1 << 20;
+    o.x          = (float*) malloc(o.n * sizeof(float));
+    o.y          = (float*) malloc(o.n * sizeof(float));
+    o.z          = (float*) malloc(o.n * sizeof(float));
+    o.points     = (vec3_t*) malloc(o.n * sizeof(vec3_t));
+    o.clip       = (vec4_t*) malloc(o.n * sizeof(vec4_t));
+    o.screen     = (vec2_t*) malloc(o.n * sizeof(vec2_t));
+    for (size_t i = 0; i < 4; i++) {
+        o.out[i] = (float*) malloc(o.n * sizeof(float));
+    }
+
+    for (size_t i = 0; i < o.n; i++) {
+        o.x[i]      = (float) (i % 211) - 105.0f;
+        o.y[i]      = (float) (i % 13) * 4.0f;
+        o.z[i]      = (float) (i % 197) - 98.0f;
+        o.points[i] = (vec3_t) {o.x[i], o.y[i], o.z[i]};
+    }
+
+    // World to camera to clip space, with some points behind the camera
+    const mat4_t model      = mat4_rotation_y(0.3f);
+    const mat4_t view       = mat4_look_at(
+        (vec3_t) {0.0f, 20.0f, 150.0f}, (vec3_t) {0.0f, 0.0f, 0.0f}, (vec3_t) {0.0f, 1.0f, 0.0f}
+    );
+    const mat4_t projection = mat4_perspective(1.0f, 640.0f / 480.0f, 0.1f, 1000.0f);
+    const mat4_t view_model = mat4_multiply(&view, &model);
+    o.mvp                   = mat4_multiply(&projection, &view_model);
+
+    const struct {
+        const char* name;
+        void (*run)(operands_t*);
+    } operations[] = {
+        {"transform_soa", run_transform_soa},
+        {"transform_aos", run_transform_aos},
+        {"project_soa", run_project_soa},
+        {"project_aos", run_project_aos},
+    };
+
+    const simd_level_t detected = simd_get_level();
+
+    printf("points: %zu, SIMD level: %s\n", o.n, simd_level_name(detected));
+    printf("%-14s %12s %12s %9s\n", "operation", "scalar ns/pt", "simd ns/pt", "speedup");
+
+    for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+        simd_set_level(SIMD_SCALAR);
+        double scalar = time_operation(operations[i].run, &o);
+        simd_set_level(detected);
+        double simd = time_operation(operations[i].run, &o);
+
+        printf("%-14s %12.3f %12.3f %8.2fx\n", operations[i].name, scalar, simd, scalar / simd);
+    }
+
+    free(o.x);
+    free(o.y);
+    free(o.z);
+    free(o.points);
+    free(o.clip);
+    free(o.screen);
+    for (size_t i = 0; i < 4; i++) {
+        free(o.out[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/matrix.c
+ *
+ * @brief Measure matrix multiplication throughput against a naive triple loop.
+ *
+ * Usage: bench_matrix [max size] [max naive size]
+ *
+ * Square sizes run from 16 up to the max size (default 4096), followed by a few non-square shapes
+ * that exercise the edge tiles. Each shape reports GFLOP/s of matrix_multiply() at every SIMD
+ * level the CPU supports, GFLOP/s of the naive reference, and the largest relative difference
+ * between the two. The naive loop is slow, so it only runs up to the max naive size (default 1024).
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../matrix.h"
+#include "../../simd.h"
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void fill(matrix_t* matrix, unsigned seed) {
+    for (size_t row = 0; row < matrix->rows; row++) {
+        for (size_t column = 0; column < matrix->columns; column++) {
+            seed                            = seed * 1664525u + 1013904223u;
+            *matrix_at(matrix, row, column) = (float) (seed >> 8) / (float) (1u << 24) - 0.5f;
+        }
+    }
+}
+
+// The reference: i-k-j order so it is at least not strided on B
+static void naive_multiply(matrix_t* dst, const matrix_t* a, const matrix_t* b) {
+    for (size_t i = 0; i < a->rows; i++) {
+        float* c = matrix_row(dst, i);
+        for (size_t j = 0; j < b->columns; j++) {
+            c[j] = 0.0f;
+        }
+        for (size_t p = 0; p < a->columns; p++) {
+            const float  aip = *matrix_at(a, i, p);
+            const float* bp  = matrix_row(b, p);
+            for (size_t j = 0; j < b->columns; j++) {
+                c[j] += aip * bp[j];
+            }
+        }
+    }
+}
+
+// Largest |x - y| relative to the largest |y|
+static double max_relative_error(const matrix_t* x, const matrix_t* y) {
+    double error = 0.0;
+    double scale = 0.0;
+
+    for (size_t row = 0; row < x->rows; row++) {
+        for (size_t column = 0; column < x->columns; column++) {
+            double reference  = *matrix_at(y, row, column);
+            double difference = fabs(*matrix_at(x, row, column) - reference);
+            error             = difference > error ? difference : error;
+            scale             = fabs(reference) > scale ? fabs(reference) : scale;
+        }
+    }
+
+    return 0.0 == scale ? error : error / scale;
+}
+
+// Repeat until about 0.2 s has passed and return the best time in nanoseconds
+static double time_multiply(
+    void (*multiply)(matrix_t*, const matrix_t*, const matrix_t*),
+    matrix_t*       dst,
+    const matrix_t* a,
+    const matrix_t* b
+) {
+    double best;
+    BENCH_BEST_WITHIN(best, 2e8, multiply(dst, a, b));
+    return best;
+}
+
+static void gemm_multiply(matrix_t* dst, const matrix_t* a, const matrix_t* b) {
+    matrix_multiply_into(dst, a, b);
+}
+
+static void run_shape(size_t m, size_t n, size_t k, size_t max_naive) {
+    matrix_t* a         = matrix_create(k, m);
+    matrix_t* b         = matrix_create(n, k);
+    matrix_t* c         = matrix_create(n, m);
+    matrix_t* reference = matrix_create(n, m);
+    if (NULL == a || NULL == b || NULL == c || NULL == reference) {
+        matrix_free(a);
+        matrix_free(b);
+        matrix_free(c);
+        matrix_free(reference);
+        return;
+    }
+
+    fill(a, 1);
+    fill(b, 2);
+
+    const double flops      = 2.0 * (double) m * (double) n * (double) k;
+    const bool   with_naive = m <= max_naive && n <= max_naive && k <= max_naive;
+    double       naive      = 0.0;
+
+    if (with_naive) {
+        naive = flops / time_multiply(naive_multiply, reference, a, b);
+    }
+
+    printf("%5zu %5zu %5zu", m, n, k);
+
+    // Time every supported level, then put the detected one back
+    const simd_level_t detected = simd_get_level();
+    double             fastest  = 0.0;
+    for (simd_level_t level = SIMD_SCALAR; level < SIMD_MAX; level++) {
+        if (SIMD_SSE2 == level || SIMD_AVX512 == level) {
+            continue; // gemm only has scalar and AVX2 kernels
+        }
+        if (level > detected) {
+            printf(" %10s", "-");
+            continue;
+        }
+        simd_set_level(level);
+        double gflops = flops / time_multiply(gemm_multiply, c, a, b);
+        fastest       = gflops > fastest ? gflops : fastest;
+        printf(" %10.2f", gflops);
+    }
+    simd_set_level(detected);
+
+    if (with_naive) {
+        double error = max_relative_error(c, reference);
+        printf(" %10.2f %9.1fx %12.3g\n", naive, fastest / naive, error);
+    } else {
+        printf(" %10s %10s %12s\n", "-", "-", "-");
+    }
+
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(c);
+    matrix_free(reference);
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_size  = argc > 1 ? strtoull(argv[1], NULL, 10) : 4096;
+    size_t max_naive = argc > 2 ? strtoull(argv[2], NULL, 10) : 1024;
+
+    printf("SIMD level: %s, GFLOP/s per kernel\n", simd_level_name(simd_get_level()));
+    printf(
+        "%5s %5s %5s %10s %10s %10s %10s %12s\n",
+        "m",
+        "n",
+        "k",
+        "scalar",
+        "avx2",
+        "naive",
+        "speedup",
+        "rel. error"
+    );
+
+    for (size_t size = 16; size <= max_size; size *= 2) {
+        run_shape(size, size, size, max_naive);
+    }
+
+    // Shapes that leave partial register tiles and cache blocks on every edge
+    const size_t shapes[][3] = {
+        {1, 1, 1},
+        {7, 17, 5},
+        {127, 253, 61},
+        {333, 97, 515},
+        {1000, 3, 1000},
+        {5, 1000, 300},
+    };
+    for (size_t i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+        run_shape(shapes[i][0], shapes[i][1], shapes[i][2], max_naive);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/matrix_pool.c
+ *
+ * @brief Measure how matrix multiplication scales across 1, 2, 4, ... N threads.
+ *
+ * Usage: bench_matrix_pool [size] [max threads] [--pin]
+ *
+ * Multiplies two size x size matrices (default 2048) on pools of growing size, up to one thread
+ * per online CPU by default, and reports GFLOP/s, the speedup over one thread and the parallel
+ * efficiency, speedup / threads. With --pin every pool pins its threads to their own CPUs. The
+ * last column is the largest difference from the single-threaded product, which must be 0.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../gemm.h"
+#include "../../matrix.h"
+#include "../../pool.h"
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void fill(matrix_t* matrix, unsigned seed) {
+    for (size_t row = 0; row < matrix->rows; row++) {
+        for (size_t column = 0; column < matrix->columns; column++) {
+            seed                            = seed * 1664525u + 1013904223u;
+            *matrix_at(matrix, row, column) = (float) (seed >> 8) / (float) (1u << 24) - 0.5f;
+        }
+    }
+}
+
+static float max_difference(const matrix_t* x, const matrix_t* y) {
+    float difference = 0.0f;
+
+    for (size_t row = 0; row < x->rows; row++) {
+        for (size_t column = 0; column < x->columns; column++) {
+            float d    = fabsf(*matrix_at(x, row, column) - *matrix_at(y, row, column));
+            difference = d > difference ? d : difference;
+        }
+    }
+
+    return difference;
+}
+
+// Returns the best time in nanoseconds over a few repetitions
+static double time_multiply(matrix_t* c, const matrix_t* a, const matrix_t* b) {
+    double best;
+    BENCH_BEST(best, 3, 1, matrix_multiply_into(c, a, b));
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    bool   pin         = argc > 1 && 0 == strcmp(argv[argc - 1], "--pin");
+    int    positional  = pin ? argc - 1 : argc;
+    size_t size        = positional > 1 ? strtoull(argv[1], NULL, 10) : 2048;
+    long   online      = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = positional > 2 ? strtoull(argv[2], NULL, 10) : (online > 0 ? online : 1);
+
+    matrix_t* a         = matrix_create(size, size);
+    matrix_t* b         = matrix_create(size, size);
+    matrix_t* c         = matrix_create(size, size);
+    matrix_t* reference = matrix_create(size, size);
+    if (NULL == a || NULL == b || NULL == c || NULL == reference) {
+        return EXIT_FAILURE;
+    }
+
+    fill(a, 1);
+    fill(b, 2);
+
+    const double flops = 2.0 * (double) size * (double) size * (double) size;
+
+    printf("size: %zu, online CPUs: %ld, pinned: %s\n", size, online, pin ? "yes" : "no");
+    printf("%8s %10s %9s %11s %12s\n", "threads", "GFLOP/s", "speedup", "efficiency", "difference");
+
+    double baseline = 0.0;
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        pool_t* pool = pool_create(threads);
+        if (NULL == pool) {
+            return EXIT_FAILURE;
+        }
+        if (pin) {
+            pool_pin(pool);
+        }
+        gemm_set_pool(pool);
+
+        double gflops = flops / time_multiply(c, a, b);
+        if (1 == threads) {
+            baseline = gflops;
+            matrix_multiply_into(reference, a, b);
+        }
+
+        double speedup = gflops / baseline;
+        printf(
+            "%8zu %10.2f %8.2fx %10.1f%% %12g\n",
+            threads,
+            gflops,
+            speedup,
+            100.0 * speedup / (double) threads,
+            max_difference(c, reference)
+        );
+
+        gemm_set_pool(NULL);
+        pool_free(pool);
+    }
+
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(c);
+    matrix_free(reference);
+
+    return EXIT_SUCCESS;
+}
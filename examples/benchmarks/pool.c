@@ -0,0 +1,124 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/pool.c
+ *
+ * @brief Measure how large vector operations scale across 1, 2, 4, ... N threads.
+ *
+ * Usage: bench_pool [elements] [max threads]
+ *
+ * The element count defaults to 2^24 and the thread count to one per online CPU. Each operation
+ * reports ns/element and the speedup over one thread. Reductions also print their result, which
+ * must be identical on every row because chunk partial sums are combined in a fixed order.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../pool.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    vector_t* a;
+    vector_t* b;
+    vector_t* dst;
+    float     result;
+} operands_t;
+
+static void run_add(operands_t* o) {
+    vector_vector_add_into(o->dst, o->a, o->b);
+    o->result = o->dst->elements[0];
+}
+
+static void run_clip(operands_t* o) {
+    vector_clip_into(o->dst, o->a, 10.0f, 50.0f);
+    o->result = o->dst->elements[0];
+}
+
+static void run_dot(operands_t* o) {
+    o->result = vector_dot_product(o->a, o->b);
+}
+
+static void run_magnitude(operands_t* o) {
+    o->result = vector_magnitude(o->a);
+}
+
+static void run_mean(operands_t* o) {
+    o->result = vector_mean(o->a);
+}
+
+// Returns the best ns/element over a few repetitions
+static double time_operation(void (*operation)(operands_t*), operands_t* o) {
+    double best;
+    BENCH_BEST(best, 5, 1, operation(o));
+    return best / (double) o->a->dimensions;
+}
+
+int main(int argc, char* argv[]) {
+    size_t n           = argc > 1 ? strtoull(argv[1], NULL, 10) : (size_t) 1 << 24;
+    long   online      = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = argc > 2 ? strtoull(argv[2], NULL, 10) : (online > 0 ? online : 1);
+
+    const struct {
+        const char* name;
+        void (*run)(operands_t*);
+    } operations[] = {
+        {"add", run_add},
+        {"clip", run_clip},
+        {"dot", run_dot},
+        {"magnitude", run_magnitude},
+        {"mean", run_mean},
+    };
+    const size_t count = sizeof(operations) / sizeof(operations[0]);
+
+    operands_t o = {vector_create(n), vector_create(n), vector_create(n), 0.0f};
+    if (NULL == o.a || NULL == o.b || NULL == o.dst) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        o.a->elements[i] = (float) (i % 97) * 0.625f;
+        o.b->elements[i] = (float) (i % 89) * 0.25f - 11.0f;
+    }
+
+    printf("elements: %zu, online CPUs: %ld\n", n, online);
+    printf("%-10s %8s %12s %9s %16s\n", "operation", "threads", "ns/element", "speedup", "result");
+
+    double baseline[sizeof(operations) / sizeof(operations[0])];
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        pool_t* pool = pool_create(threads);
+        if (NULL == pool) {
+            return EXIT_FAILURE;
+        }
+        vector_set_pool(pool);
+
+        for (size_t i = 0; i < count; i++) {
+            double elapsed = time_operation(operations[i].run, &o);
+            if (1 == threads) {
+                baseline[i] = elapsed;
+            }
+            printf(
+                "%-10s %8zu %12.4f %8.2fx %16.9g\n",
+                operations[i].name,
+                threads,
+                elapsed,
+                baseline[i] / elapsed,
+                o.result
+            );
+        }
+
+        vector_set_pool(NULL);
+        pool_free(pool);
+    }
+
+    vector_free(o.a);
+    vector_free(o.b);
+    vector_free(o.dst);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/reduction.c
+ *
+ * @brief Measure the vector reductions at every instruction set level supported by this CPU.
+ *
+ * Each reduction is timed with the kernels forced to scalar, SSE2, AVX2 and AVX-512 in turn, up to
+ * the widest level detected at startup. Runs headless; no SDL window is created.
+ */
+
+#include "../../simd.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum {
+    REDUCTION_DOT,
+    REDUCTION_MAGNITUDE,
+    REDUCTION_DISTANCE,
+    REDUCTION_MEAN,
+    REDUCTION_MAX_COUNT
+} reduction_t;
+
+static const char* reduction_names[REDUCTION_MAX_COUNT] = {"dot", "magnitude", "distance", "mean"};
+
+// Number of input vectors streamed by each reduction
+static const size_t reduction_inputs[REDUCTION_MAX_COUNT] = {2, 1, 2, 1};
+
+static float run_reduction(reduction_t reduction, const vector_t* a, const vector_t* b) {
+    switch (reduction) {
+        case REDUCTION_DOT:
+            return vector_dot_product(a, b);
+        case REDUCTION_MAGNITUDE:
+            return vector_magnitude(a);
+        case REDUCTION_DISTANCE:
+            return vector_distance(a, b);
+        case REDUCTION_MEAN:
+            return vector_mean(a);
+        default:
+            return 0.0f;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n = (argc > 1) ? (size_t) strtoull(argv[1], NULL, 10) : 1000000;
+
+    vector_t* a = vector_create(n);
+    vector_t* b = vector_create(n);
+    if (NULL == a || NULL == b) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        a->elements[i] = (float) (i % 101) * 0.01f;
+        b->elements[i] = (float) (i % 103) * 0.01f;
+    }
+
+    const simd_level_t detected    = simd_detect();
+    const size_t       repetitions = 1 + (size_t) 2e8 / n;
+    volatile float     sink        = 0.0f; // keep results alive
+
+    printf("elements: %zu, detected: %s\n", n, simd_level_name(detected));
+    printf("%-10s %-8s %12s %10s %14s\n", "reduction", "level", "ns/element", "GB/s", "result");
+
+    for (reduction_t r = 0; r < REDUCTION_MAX_COUNT; r++) {
+        for (simd_level_t level = SIMD_SCALAR; level <= detected; level++) {
+            simd_set_level(level);
+
+            double best;
+            float  result = 0.0f;
+            BENCH_BEST(best, 3, repetitions, result = run_reduction(r, a, b); sink = result);
+
+            double bytes = (double) (reduction_inputs[r] * n * sizeof(float));
+            printf(
+                "%-10s %-8s %12.4f %10.2f %14.6g\n",
+                reduction_names[r],
+                simd_level_name(level),
+                best / (double) n,
+                bytes / best,
+                result
+            );
+        }
+    }
+
+    (void) sink;
+    simd_set_level(detected);
+
+    vector_free(a);
+    vector_free(b);
+
+    return EXIT_SUCCESS;
+}
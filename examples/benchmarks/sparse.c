@@ -0,0 +1,170 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/sparse.c
+ *
+ * @brief Measure sparse matrix-vector multiplies against dense ones at falling densities.
+ *
+ * Usage: bench_sparse [size] [threads]
+ *
+ * Fills a size x size matrix (default 4096) with random nonzeros at densities from 50% down to
+ * 0.01%, compresses it with sparse_from_matrix(), and multiplies it by a vector three ways: dense,
+ * one simd_dot() per row; sparse on one thread; and sparse on a pool of threads (default one per
+ * online CPU). Reports µs per multiply, the speedup of each sparse multiply over the dense one,
+ * the memory of both formats, and the largest difference between the dense and sparse products.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../matrix.h"
+#include "../../pool.h"
+#include "../../simd.h"
+#include "../../sparse.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static unsigned next(unsigned* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+// Each element is nonzero with probability density
+static void fill(matrix_t* matrix, double density, unsigned seed) {
+    const unsigned cutoff = (unsigned) (density * (double) (1u << 24));
+
+    for (size_t row = 0; row < matrix->rows; row++) {
+        float* elements = matrix_row(matrix, row);
+        for (size_t column = 0; column < matrix->columns; column++) {
+            bool nonzero     = next(&seed) < cutoff;
+            elements[column] = nonzero ? (float) next(&seed) / (float) (1u << 24) - 0.5f : 0.0f;
+        }
+    }
+}
+
+static void dense_multiply(vector_t* y, const matrix_t* a, const vector_t* x) {
+    for (size_t row = 0; row < a->rows; row++) {
+        y->elements[row] = simd_dot(matrix_row(a, row), x->elements, a->columns);
+    }
+}
+
+typedef struct {
+    const matrix_t* dense;
+    const sparse_t* sparse;
+    const vector_t* x;
+    vector_t*       y;
+} operands_t;
+
+static void run_dense(operands_t* o) {
+    dense_multiply(o->y, o->dense, o->x);
+}
+
+static void run_sparse(operands_t* o) {
+    sparse_multiply_vector_into(o->y, o->sparse, o->x);
+}
+
+// Returns the best time in nanoseconds over a few repetitions
+static double time_operation(void (*operation)(operands_t*), operands_t* o) {
+    double best;
+    BENCH_BEST(best, 10, 1, operation(o));
+    return best;
+}
+
+static float max_difference(const vector_t* x, const vector_t* y) {
+    float difference = 0.0f;
+
+    for (size_t i = 0; i < x->dimensions; i++) {
+        float d    = fabsf(x->elements[i] - y->elements[i]);
+        difference = d > difference ? d : difference;
+    }
+
+    return difference;
+}
+
+int main(int argc, char* argv[]) {
+    size_t size    = argc > 1 ? strtoull(argv[1], NULL, 10) : 4096;
+    long   online  = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = argc > 2 ? strtoull(argv[2], NULL, 10) : (online > 0 ? online : 1);
+
+    matrix_t* dense     = matrix_create(size, size);
+    vector_t* x         = vector_create(size);
+    vector_t* y         = vector_create(size);
+    vector_t* reference = vector_create(size);
+    pool_t*   pool      = pool_create(threads);
+    if (NULL == dense || NULL == x || NULL == y || NULL == reference || NULL == pool) {
+        return EXIT_FAILURE;
+    }
+
+    unsigned seed = 7;
+    for (size_t i = 0; i < size; i++) {
+        x->elements[i] = (float) next(&seed) / (float) (1u << 24) - 0.5f;
+    }
+
+    const double densities[]  = {0.5, 0.2, 0.1, 0.05, 0.01, 0.001, 0.0001};
+    const double dense_memory = (double) size * (double) size * sizeof(float) / (1 << 20);
+
+    printf("size: %zu, pool threads: %zu, dense MiB: %.1f\n", size, threads, dense_memory);
+    printf(
+        "%9s %10s %10s %10s %10s %8s %8s %10s %11s\n",
+        "density",
+        "nonzeros",
+        "dense µs",
+        "sparse µs",
+        "pool µs",
+        "speedup",
+        "pool",
+        "sparse MiB",
+        "difference"
+    );
+
+    for (size_t i = 0; i < sizeof(densities) / sizeof(densities[0]); i++) {
+        fill(dense, densities[i], (unsigned) i + 1);
+
+        sparse_t* sparse = sparse_from_matrix(dense, 0.0f);
+        if (NULL == sparse) {
+            return EXIT_FAILURE;
+        }
+
+        operands_t o = {dense, sparse, x, y};
+
+        double dense_time = time_operation(run_dense, &o);
+        dense_multiply(reference, dense, x);
+
+        sparse_set_pool(NULL);
+        double sparse_time = time_operation(run_sparse, &o);
+        sparse_set_pool(pool);
+        double pool_time = time_operation(run_sparse, &o);
+        sparse_set_pool(NULL);
+
+        double sparse_memory = (double) (sparse->nonzeros * (sizeof(float) + sizeof(uint32_t))
+                                         + (sparse->rows + 1) * sizeof(size_t))
+                               / (1 << 20);
+
+        printf(
+            "%8.2f%% %10zu %10.1f %10.1f %10.1f %7.1fx %7.1fx %10.2f %11g\n",
+            100.0 * densities[i],
+            sparse->nonzeros,
+            dense_time / 1e3,
+            sparse_time / 1e3,
+            pool_time / 1e3,
+            dense_time / sparse_time,
+            dense_time / pool_time,
+            sparse_memory,
+            max_difference(y, reference)
+        );
+
+        sparse_free(sparse);
+    }
+
+    matrix_free(dense);
+    vector_free(x);
+    vector_free(y);
+    vector_free(reference);
+    pool_free(pool);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,313 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/tensor.c
+ *
+ * @brief Measure ns/element of broadcasting element-wise operations, axis reductions and copies.
+ *
+ * Usage: bench_tensor [rows] [columns] [layers]
+ *
+ * Each element-wise case adds two tensors into a preallocated {rows, columns} result (default
+ * 1024 × 1024): equal shapes, a broadcast row, a broadcast column, a scalar, and a transposed view.
+ * The "naive" column visits every element through its full index, the way a loop over tensor_at()
+ * would; the "engine" column is tensor_add_into(), which coalesces dimensions and runs SIMD inner
+ * loops.
+ *
+ * Each reduction case takes the mean and the maximum of a {layers, rows, columns} tensor (default
+ * 16 layers) over some axes. The "naive" column is the triple loop over tensor_at3() that
+ * accumulates into the result; the "engine" column is tensor_reduce_into().
+ *
+ * Each copy case materializes a view of the same tensor into a preallocated contiguous tensor, as
+ * tensor_contiguous() does: channels-last {rows, columns, layers}, rows and columns swapped, the
+ * columns reversed, and every other column. The "naive" column copies element by element through
+ * tensor_at(); the "engine" column is tensor_copy_into(), which moves whole runs or cache-sized
+ * tiles.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../tensor.h"
+#include "bench.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void fill(tensor_t* tensor) {
+    for (size_t i = 0; i < tensor->size; i++) {
+        tensor->data[i] = (float) (i % 97) + 0.5f;
+    }
+}
+
+// The reference: one odometer step and three index-to-offset computations per element
+static void naive_add(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    size_t index[TENSOR_MAX_RANK] = {0};
+    size_t ia[TENSOR_MAX_RANK], ib[TENSOR_MAX_RANK];
+
+    for (size_t e = 0; e < dst->size; e++) {
+        for (size_t i = 0; i < a->rank; i++) {
+            const size_t j = i + dst->rank - a->rank;
+            ia[i]          = 1 == a->shape[i] ? 0 : index[j];
+        }
+        for (size_t i = 0; i < b->rank; i++) {
+            const size_t j = i + dst->rank - b->rank;
+            ib[i]          = 1 == b->shape[i] ? 0 : index[j];
+        }
+        *tensor_at(dst, index) = *tensor_at(a, ia) + *tensor_at(b, ib);
+
+        for (size_t i = dst->rank; i-- > 0;) {
+            if (++index[i] < dst->shape[i]) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
+// The reference: one pass in row-major order, accumulating into the kept element of dst
+static void naive_reduce(tensor_t* dst, const tensor_t* src, unsigned axes, tensor_reduction_t r) {
+    const size_t mask[3] = {
+        axes & TENSOR_AXIS(0) ? 0 : SIZE_MAX,
+        axes & TENSOR_AXIS(1) ? 0 : SIZE_MAX,
+        axes & TENSOR_AXIS(2) ? 0 : SIZE_MAX,
+    };
+
+    for (size_t i = 0; i < dst->size; i++) {
+        dst->data[i] = TENSOR_REDUCE_MAX == r ? -INFINITY : 0.0f;
+    }
+
+    for (size_t layer = 0; layer < src->shape[0]; layer++) {
+        for (size_t row = 0; row < src->shape[1]; row++) {
+            for (size_t column = 0; column < src->shape[2]; column++) {
+                const float x   = *tensor_at3(src, layer, row, column);
+                float*      acc = tensor_at3(dst, layer & mask[0], row & mask[1], column & mask[2]);
+                *acc            = TENSOR_REDUCE_MAX == r ? fmaxf(*acc, x) : *acc + x;
+            }
+        }
+    }
+
+    if (TENSOR_REDUCE_MEAN == r) {
+        const float count = (float) (src->size / dst->size);
+        for (size_t i = 0; i < dst->size; i++) {
+            dst->data[i] /= count;
+        }
+    }
+}
+
+// The reference: one odometer step and two index-to-offset computations per element
+static void naive_copy(tensor_t* dst, const tensor_t* src) {
+    size_t index[TENSOR_MAX_RANK] = {0};
+
+    for (size_t e = 0; e < dst->size; e++) {
+        *tensor_at(dst, index) = *tensor_at(src, index);
+
+        for (size_t i = dst->rank; i-- > 0;) {
+            if (++index[i] < dst->shape[i]) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+}
+
+// Returns the best ns/element over a few trials
+static double time_add(tensor_t* dst, const tensor_t* a, const tensor_t* b, int engine) {
+    double best;
+    BENCH_BEST(best, 5, 1, engine ? (void) tensor_add_into(dst, a, b) : naive_add(dst, a, b));
+    return best / (double) dst->size;
+}
+
+// Returns the best ns/element of src over a few trials
+static double
+time_reduce(const tensor_t* src, unsigned axes, tensor_reduction_t reduction, int engine) {
+    size_t shape[3];
+    for (size_t i = 0; i < 3; i++) {
+        shape[i] = axes & TENSOR_AXIS(i) ? 1 : src->shape[i];
+    }
+
+    tensor_t* dst = tensor_create_nd(3, shape);
+    if (NULL == dst) {
+        exit(EXIT_FAILURE);
+    }
+
+    double best;
+    BENCH_BEST(
+        best,
+        5,
+        1,
+        engine ? (void) tensor_reduce_into(dst, src, axes, reduction)
+               : naive_reduce(dst, src, axes, reduction)
+    );
+
+    tensor_free(dst);
+    return best / (double) src->size;
+}
+
+// Returns the best ns/element of a contiguous copy of src over a few trials
+static double time_copy(const tensor_t* src, int engine) {
+    tensor_t* dst = tensor_create_nd(src->rank, src->shape);
+    if (NULL == dst) {
+        exit(EXIT_FAILURE);
+    }
+
+    double best;
+    BENCH_BEST(best, 5, 1, engine ? (void) tensor_copy_into(dst, src) : naive_copy(dst, src));
+
+    tensor_free(dst);
+    return best / (double) src->size;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t rows    = argc > 1 ? strtoull(argv[1], NULL, 10) : 1024;
+    const size_t columns = argc > 2 ? strtoull(argv[2], NULL, 10) : 1024;
+    const size_t layers  = argc > 3 ? strtoull(argv[3], NULL, 10) : 16;
+
+    const size_t full_shape[2]   = {rows, columns};
+    const size_t row_shape[1]    = {columns};
+    const size_t column_shape[2] = {rows, 1};
+    const size_t flip_shape[2]   = {columns, rows};
+
+    tensor_t* dst    = tensor_create_nd(2, full_shape);
+    tensor_t* a      = tensor_create_nd(2, full_shape);
+    tensor_t* full   = tensor_create_nd(2, full_shape);
+    tensor_t* row    = tensor_create_nd(1, row_shape);
+    tensor_t* column = tensor_create_nd(2, column_shape);
+    tensor_t* scalar = tensor_create_nd(0, NULL);
+    tensor_t* flip   = tensor_create_nd(2, flip_shape);
+    if (NULL == dst || NULL == a || NULL == full || NULL == row || NULL == column || NULL == scalar
+        || NULL == flip) {
+        return EXIT_FAILURE;
+    }
+    fill(a);
+    fill(full);
+    fill(row);
+    fill(column);
+    fill(scalar);
+    fill(flip);
+
+    // A {rows, columns} view of the {columns, rows} tensor, stepping down its columns
+    const tensor_t transposed = tensor_transpose(flip, 0, 1);
+
+    const struct {
+        const char*     name;
+        const tensor_t* b;
+    } cases[] = {
+        {"equal", full},
+        {"row", row},
+        {"column", column},
+        {"scalar", scalar},
+        {"transposed", &transposed},
+    };
+
+    printf("%-12s %10s %14s %14s %8s\n", "b", "elements", "naive ns/el", "engine ns/el", "speedup");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        double naive  = time_add(dst, a, cases[c].b, 0);
+        double engine = time_add(dst, a, cases[c].b, 1);
+        printf(
+            "%-12s %10zu %14.3f %14.3f %7.2fx\n",
+            cases[c].name,
+            dst->size,
+            naive,
+            engine,
+            naive / engine
+        );
+    }
+
+    const size_t volume_shape[3] = {layers, rows, columns};
+    tensor_t*    volume          = tensor_create_nd(3, volume_shape);
+    if (NULL == volume) {
+        return EXIT_FAILURE;
+    }
+    fill(volume);
+
+    const struct {
+        const char* name;
+        unsigned    axes;
+    } reductions[] = {
+        {"columns", TENSOR_AXIS(2)},
+        {"rows", TENSOR_AXIS(1)},
+        {"layers", TENSOR_AXIS(0)},
+        {"per layer", TENSOR_AXIS(1) | TENSOR_AXIS(2)},
+        {"all", TENSOR_AXIS(0) | TENSOR_AXIS(1) | TENSOR_AXIS(2)},
+    };
+
+    const struct {
+        const char*        name;
+        tensor_reduction_t reduction;
+    } kinds[] = {
+        {"mean", TENSOR_REDUCE_MEAN},
+        {"max", TENSOR_REDUCE_MAX},
+    };
+
+    printf(
+        "\n%-12s %-6s %10s %14s %14s %8s\n",
+        "reduce",
+        "kind",
+        "elements",
+        "naive ns/el",
+        "engine ns/el",
+        "speedup"
+    );
+
+    for (size_t c = 0; c < sizeof(reductions) / sizeof(reductions[0]); c++) {
+        for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+            double naive  = time_reduce(volume, reductions[c].axes, kinds[k].reduction, 0);
+            double engine = time_reduce(volume, reductions[c].axes, kinds[k].reduction, 1);
+            printf(
+                "%-12s %-6s %10zu %14.3f %14.3f %7.2fx\n",
+                reductions[c].name,
+                kinds[k].name,
+                volume->size,
+                naive,
+                engine,
+                naive / engine
+            );
+        }
+    }
+
+    const size_t channels_last[3] = {1, 2, 0};
+    const struct {
+        const char* name;
+        tensor_t    view;
+    } copies[] = {
+        {"channels", tensor_permute(volume, channels_last)},
+        {"swapped", tensor_transpose(volume, 1, 2)},
+        {"reversed", tensor_slice(volume, 2, columns - 1, columns, -1)},
+        {"strided", tensor_slice(volume, 2, 0, (columns + 1) / 2, 2)},
+    };
+
+    printf(
+        "\n%-12s %10s %14s %14s %8s\n",
+        "copy",
+        "elements",
+        "naive ns/el",
+        "engine ns/el",
+        "speedup"
+    );
+
+    for (size_t c = 0; c < sizeof(copies) / sizeof(copies[0]); c++) {
+        double naive  = time_copy(&copies[c].view, 0);
+        double engine = time_copy(&copies[c].view, 1);
+        printf(
+            "%-12s %10zu %14.3f %14.3f %7.2fx\n",
+            copies[c].name,
+            copies[c].view.size,
+            naive,
+            engine,
+            naive / engine
+        );
+    }
+
+    tensor_free(volume);
+    tensor_free(dst);
+    tensor_free(a);
+    tensor_free(full);
+    tensor_free(row);
+    tensor_free(column);
+    tensor_free(scalar);
+    tensor_free(flip);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/tensor_file.c
+ *
+ * @brief Measure writing tensor files and loading them by mapping versus reading.
+ *
+ * Usage: bench_tensor_file [path] [layers]
+ *
+ * A {layers, 1024, 1024} tensor (default 256 layers, 1 GiB) is saved to path (default
+ * bench_tensor_file.tensor, removed afterwards), then loaded two ways:
+ *
+ * - "read" allocates a tensor and reads the whole file into it, as a loader parsing the file would;
+ * - "map" is tensor_load(), which maps the file and only checks its header.
+ *
+ * For each, the report shows the time to load, the time to then read one element in the middle,
+ * and the time for a sum over every element, which for the mapped tensor includes faulting in all
+ * of its pages. The file was just written, so both run from the page cache; from a cold disk the
+ * gap between loading everything and loading one layer only grows.
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../tensor.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// The reference: allocate the whole tensor and read the elements into it
+static tensor_t* read_tensor(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (NULL == file) {
+        return NULL;
+    }
+
+    tensor_file_header_t header;
+    tensor_t*            tensor = NULL;
+    if (1 == fread(&header, sizeof(header), 1, file)) {
+        size_t shape[TENSOR_MAX_RANK];
+        for (size_t i = 0; i < header.rank && i < TENSOR_MAX_RANK; i++) {
+            shape[i] = (size_t) header.shape[i];
+        }
+        tensor = tensor_create_nd(header.rank, shape);
+    }
+
+    if (NULL != tensor
+        && (0 != fseek(file, (long) header.data_offset, SEEK_SET)
+            || tensor->size != fread(tensor->data, sizeof(float), tensor->size, file))) {
+        tensor_free(tensor);
+        tensor = NULL;
+    }
+
+    fclose(file);
+    return tensor;
+}
+
+int main(int argc, char* argv[]) {
+    const char*  path   = argc > 1 ? argv[1] : "bench_tensor_file.tensor";
+    const size_t layers = argc > 2 ? strtoull(argv[2], NULL, 10) : 256;
+
+    const size_t shape[3] = {layers, 1024, 1024};
+    tensor_t*    source   = tensor_create_nd(3, shape);
+    if (NULL == source) {
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < source->size; i++) {
+        source->data[i] = (float) (i % 97) + 0.5f;
+    }
+
+    const double bytes = (double) source->size * sizeof(float);
+
+    double start = bench_now_ns();
+    if (!tensor_save(source, path)) {
+        return EXIT_FAILURE;
+    }
+    printf("save %.0f MiB: %.2f GB/s\n\n", bytes / (1 << 20), bytes / (bench_now_ns() - start));
+    tensor_free(source);
+
+    printf("%-6s %12s %16s %14s\n", "load", "load ms", "one element µs", "sum all ms");
+
+    for (int mapped = 0; mapped < 2; mapped++) {
+        start            = bench_now_ns();
+        tensor_t* tensor = mapped ? tensor_load(path) : read_tensor(path);
+        double    load   = bench_now_ns() - start;
+        if (NULL == tensor) {
+            return EXIT_FAILURE;
+        }
+
+        // One element in the middle: a single page fault for the mapped tensor
+        start                = bench_now_ns();
+        volatile float value = *tensor_at3(tensor, layers / 2, 512, 512);
+        double         first = bench_now_ns() - start;
+
+        start              = bench_now_ns();
+        volatile float sum = tensor_reduce_all(tensor, TENSOR_REDUCE_SUM);
+        double         all = bench_now_ns() - start;
+
+        (void) value;
+        (void) sum;
+        printf(
+            "%-6s %12.3f %16.1f %14.1f\n",
+            mapped ? "map" : "read",
+            load / 1e6,
+            first / 1e3,
+            all / 1e6
+        );
+        tensor_free(tensor);
+    }
+
+    remove(path);
+    return EXIT_SUCCESS;
+}
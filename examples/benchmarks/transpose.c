@@ -0,0 +1,121 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/transpose.c
+ *
+ * @brief Measure matrix transposition bandwidth against memcpy.
+ *
+ * Usage: bench_transpose [max size]
+ *
+ * Square sizes run from 256 up to the max size (default 8192). Each transpose reports GB/s,
+ * counting every element read once and written once, next to memcpy of the same matrix as the
+ * ceiling:
+ *
+ * - naive:    row by row reads, column by column writes
+ * - scalar:   matrix_transpose_into() with the portable block kernel
+ * - simd:     matrix_transpose_into() with the kernel of the detected SIMD level
+ * - in-place: matrix_transpose_in_place() with the kernel of the detected SIMD level
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../matrix.h"
+#include "../../simd.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    matrix_t* src;
+    matrix_t* dst;
+} operands_t;
+
+static void run_memcpy(operands_t* o) {
+    memcpy(o->dst->data, o->src->data, o->src->rows * o->src->stride * sizeof(float));
+}
+
+static void run_naive(operands_t* o) {
+    for (size_t row = 0; row < o->src->rows; row++) {
+        const float* src = matrix_row(o->src, row);
+        for (size_t column = 0; column < o->src->columns; column++) {
+            *matrix_at(o->dst, column, row) = src[column];
+        }
+    }
+}
+
+static void run_blocked(operands_t* o) {
+    matrix_transpose_into(o->dst, o->src);
+}
+
+static void run_in_place(operands_t* o) {
+    matrix_transpose_in_place(o->src);
+}
+
+// Repeat until about 0.2 s has passed and return the best GB/s
+static double time_operation(void (*operation)(operands_t*), operands_t* o) {
+    const double bytes = 2.0 * (double) o->src->rows * (double) o->src->columns * sizeof(float);
+    double       best;
+    BENCH_BEST_WITHIN(best, 2e8, operation(o));
+    return bytes / best;
+}
+
+int main(int argc, char* argv[]) {
+    size_t max_size = argc > 1 ? strtoull(argv[1], NULL, 10) : 8192;
+
+    const simd_level_t detected = simd_get_level();
+
+    printf("SIMD level: %s, GB/s\n", simd_level_name(detected));
+    printf(
+        "%6s %10s %10s %10s %10s %10s %9s\n",
+        "size",
+        "memcpy",
+        "naive",
+        "scalar",
+        "simd",
+        "in-place",
+        "of memcpy"
+    );
+
+    for (size_t size = 256; size <= max_size; size *= 2) {
+        operands_t o = {matrix_create(size, size), matrix_create(size, size)};
+        if (NULL == o.src || NULL == o.dst) {
+            matrix_free(o.src);
+            matrix_free(o.dst);
+            return EXIT_FAILURE;
+        }
+
+        for (size_t row = 0; row < size; row++) {
+            for (size_t column = 0; column < size; column++) {
+                *matrix_at(o.src, row, column) = (float) (row * size + column);
+            }
+        }
+
+        double copy  = time_operation(run_memcpy, &o);
+        double naive = time_operation(run_naive, &o);
+
+        simd_set_level(SIMD_SCALAR);
+        double scalar = time_operation(run_blocked, &o);
+        simd_set_level(detected);
+
+        double simd     = time_operation(run_blocked, &o);
+        double in_place = time_operation(run_in_place, &o);
+
+        printf(
+            "%6zu %10.2f %10.2f %10.2f %10.2f %10.2f %8.0f%%\n",
+            size,
+            copy,
+            naive,
+            scalar,
+            simd,
+            in_place,
+            100.0 * simd / copy
+        );
+
+        matrix_free(o.src);
+        matrix_free(o.dst);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,167 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/vec.c
+ *
+ * @brief Compare heap-allocated vector_t math against the inline vec2_t/vec3_t value types.
+ *
+ * For the cross product and both polar conversions, three paths are timed per call:
+ * - heap: the allocating vector_t function plus vector_free() of its result
+ * - into: the *_into() variant writing into a preallocated vector_t
+ * - value: the static inline function from vec.h
+ *
+ * Runs headless; no SDL window is created.
+ */
+
+#include "../../vec.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POINTS      4096
+#define REPETITIONS 200
+
+static void report(const char* name, const char* path, double elapsed, float checksum) {
+    printf(
+        "%-20s %-6s %10.2f ns/call   (checksum %g)\n",
+        name,
+        path,
+        elapsed / ((double) POINTS * REPETITIONS),
+        checksum
+    );
+}
+
+int main(int argc, char* argv[]) {
+    static vec3_t a[POINTS], b[POINTS];
+    static vec2_t polar[POINTS], cartesian[POINTS];
+
+    for (size_t i = 0; i < POINTS; i++) {
+        a[i]         = (vec3_t) {(float) i, 1.0f, -0.5f * (float) i};
+        b[i]         = (vec3_t) {0.25f, (float) (i % 7), 2.0f};
+        polar[i]     = (vec2_t) {1.0f + (float) (i % 13), 0.001f * (float) i};
+        cartesian[i] = (vec2_t) {(float) (i % 17) - 8.0f, (float) (i % 11) - 5.0f};
+    }
+
+    vector_t* va  = vector_create(3);
+    vector_t* vb  = vector_create(3);
+    vector_t* v2  = vector_create(2);
+    vector_t* out = vector_create(3);
+    vector_t* o2  = vector_create(2);
+    if (NULL == va || NULL == vb || NULL == v2 || NULL == out || NULL == o2) {
+        return EXIT_FAILURE;
+    }
+
+    // Cross product
+    {
+        float  checksum = 0.0f;
+        double start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec3_to_vector(a[i], va);
+                vec3_to_vector(b[i], vb);
+                vector_t* c  = vector_cross_product(va, vb);
+                checksum    += c->elements[0];
+                vector_free(c);
+            }
+        }
+        report("cross_product", "heap", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec3_to_vector(a[i], va);
+                vec3_to_vector(b[i], vb);
+                checksum += vector_cross_product_into(out, va, vb)->elements[0];
+            }
+        }
+        report("cross_product", "into", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                checksum += vec3_cross(a[i], b[i]).x;
+            }
+        }
+        report("cross_product", "value", bench_now_ns() - start, checksum);
+    }
+
+    // Polar to cartesian
+    {
+        float  checksum = 0.0f;
+        double start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec2_to_vector(polar[i], v2);
+                vector_t* c  = vector_polar_to_cartesian(v2);
+                checksum    += c->elements[0];
+                vector_free(c);
+            }
+        }
+        report("polar_to_cartesian", "heap", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec2_to_vector(polar[i], v2);
+                checksum += vector_polar_to_cartesian_into(o2, v2)->elements[0];
+            }
+        }
+        report("polar_to_cartesian", "into", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                checksum += vec2_from_polar(polar[i].x, polar[i].y).x;
+            }
+        }
+        report("polar_to_cartesian", "value", bench_now_ns() - start, checksum);
+    }
+
+    // Cartesian to polar
+    {
+        float  checksum = 0.0f;
+        double start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec2_to_vector(cartesian[i], v2);
+                vector_t* c  = vector_cartesian_to_polar(v2);
+                checksum    += c->elements[1];
+                vector_free(c);
+            }
+        }
+        report("cartesian_to_polar", "heap", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                vec2_to_vector(cartesian[i], v2);
+                checksum += vector_cartesian_to_polar_into(o2, v2)->elements[1];
+            }
+        }
+        report("cartesian_to_polar", "into", bench_now_ns() - start, checksum);
+
+        checksum = 0.0f;
+        start    = bench_now_ns();
+        for (size_t r = 0; r < REPETITIONS; r++) {
+            for (size_t i = 0; i < POINTS; i++) {
+                checksum += vec2_to_polar(cartesian[i]).y;
+            }
+        }
+        report("cartesian_to_polar", "value", bench_now_ns() - start, checksum);
+    }
+
+    vector_free(va);
+    vector_free(vb);
+    vector_free(v2);
+    vector_free(out);
+    vector_free(o2);
+
+    return EXIT_SUCCESS;
+}
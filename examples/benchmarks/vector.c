@@ -0,0 +1,393 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/benchmarks/vector.c
+ *
+ * @brief Time every function in vector.h and report throughput and allocations per call.
+ *
+ * Usage: bench_vector [--json] [max elements]
+ *
+ * Each function runs over vectors of 2 to 10^7 elements (capped by the optional argument);
+ * fixed-size operations such as the cross product run once at their own size. For every run the
+ * benchmark reports:
+ * - ns/call and ns/element, the best of three trials
+ * - GB/s, counting each input and output array touched once per call
+ * - mallocs/call, counting malloc, calloc, realloc and aligned_alloc
+ *
+ * Allocations are counted by wrapping the allocator at link time, so this target must be linked
+ * with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=aligned_alloc (see CMakeLists.txt).
+ * Allocating functions are timed together with the vector_free() of their result.
+ *
+ * With --json the results are printed as one JSON object, for tracking regressions between
+ * releases. Runs headless; no SDL window is created.
+ */
+
+#include "../../simd.h"
+#include "../../vector.h"
+#include "bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Allocation counting
+
+static size_t allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+    allocations++;
+    return __real_aligned_alloc(alignment, size);
+}
+
+// Operands shared by every benchmark of one size
+typedef struct {
+    size_t    n;
+    vector_t* a;
+    vector_t* b;
+    vector_t* c;
+    vector_t* dst;
+    arena_t*  arena;
+    float     sink; ///< Accumulates scalar results so they are not optimized away.
+} bench_t;
+
+// Opaque to the executors, so they fall back to calling through the pointer
+static float generic_add(float x, float y) {
+    return x + y;
+}
+
+#define BENCH(name, statement)                 \
+    static void bench_##name(bench_t* bench) { \
+        statement;                             \
+    }
+
+// Lifecycle
+BENCH(vector_create, vector_free(vector_create(bench->n)))
+BENCH(vector_create_aligned, vector_free(vector_create_aligned(bench->n)))
+BENCH(vector_create_in, arena_reset(bench->arena); vector_create_in(bench->arena, bench->n))
+BENCH(vector_deep_copy, vector_free(vector_deep_copy(bench->a)))
+BENCH(vector_shallow_copy, vector_free(vector_shallow_copy(bench->a)))
+BENCH(vector_copy_into, vector_copy_into(bench->dst, bench->a))
+
+// Element-wise executors with an opaque operation
+BENCH(
+    scalar_elementwise_operation,
+    vector_free(scalar_elementwise_operation(bench->a, 2.0f, generic_add))
+)
+BENCH(
+    scalar_elementwise_operation_into,
+    scalar_elementwise_operation_into(bench->dst, bench->a, 2.0f, generic_add)
+)
+BENCH(
+    vector_elementwise_operation,
+    vector_free(vector_elementwise_operation(bench->a, bench->b, generic_add))
+)
+BENCH(
+    vector_elementwise_operation_into,
+    vector_elementwise_operation_into(bench->dst, bench->a, bench->b, generic_add)
+)
+
+// Vector-scalar operations
+BENCH(vector_scalar_add, vector_free(vector_scalar_add(bench->a, 2.0f)))
+BENCH(vector_scalar_subtract, vector_free(vector_scalar_subtract(bench->a, 2.0f)))
+BENCH(vector_scalar_multiply, vector_free(vector_scalar_multiply(bench->a, 2.0f)))
+BENCH(vector_scalar_divide, vector_free(vector_scalar_divide(bench->a, 2.0f)))
+BENCH(vector_scalar_add_into, vector_scalar_add_into(bench->dst, bench->a, 2.0f))
+BENCH(vector_scalar_subtract_into, vector_scalar_subtract_into(bench->dst, bench->a, 2.0f))
+BENCH(vector_scalar_multiply_into, vector_scalar_multiply_into(bench->dst, bench->a, 2.0f))
+BENCH(vector_scalar_divide_into, vector_scalar_divide_into(bench->dst, bench->a, 2.0f))
+
+// Vector-vector operations
+BENCH(vector_vector_add, vector_free(vector_vector_add(bench->a, bench->b)))
+BENCH(vector_vector_subtract, vector_free(vector_vector_subtract(bench->a, bench->b)))
+BENCH(vector_vector_multiply, vector_free(vector_vector_multiply(bench->a, bench->b)))
+BENCH(vector_vector_divide, vector_free(vector_vector_divide(bench->a, bench->b)))
+BENCH(vector_vector_add_into, vector_vector_add_into(bench->dst, bench->a, bench->b))
+BENCH(vector_vector_subtract_into, vector_vector_subtract_into(bench->dst, bench->a, bench->b))
+BENCH(vector_vector_multiply_into, vector_vector_multiply_into(bench->dst, bench->a, bench->b))
+BENCH(vector_vector_divide_into, vector_vector_divide_into(bench->dst, bench->a, bench->b))
+
+// Common vector operations
+BENCH(vector_magnitude, bench->sink += vector_magnitude(bench->a))
+BENCH(vector_distance, bench->sink += vector_distance(bench->a, bench->b))
+BENCH(vector_mean, bench->sink += vector_mean(bench->a))
+BENCH(vector_low_pass_filter, bench->sink += vector_low_pass_filter(bench->a, 0.1f))
+BENCH(vector_normalize, vector_free(vector_normalize(bench->a, false)))
+BENCH(vector_normalize_into, vector_normalize_into(bench->dst, bench->a))
+BENCH(vector_scale, vector_free(vector_scale(bench->a, 2.0f, false)))
+BENCH(vector_scale_into, vector_scale_into(bench->dst, bench->a, 2.0f))
+BENCH(vector_clip, vector_free(vector_clip(bench->a, 10.0f, 50.0f, false)))
+BENCH(vector_clip_into, vector_clip_into(bench->dst, bench->a, 10.0f, 50.0f))
+BENCH(vector_dot_product, bench->sink += vector_dot_product(bench->a, bench->b))
+
+// Fixed-size operations
+BENCH(vector_cross_product, vector_free(vector_cross_product(bench->a, bench->b)))
+BENCH(vector_cross_product_into, vector_cross_product_into(bench->dst, bench->a, bench->b))
+BENCH(vector_polar_to_cartesian, vector_free(vector_polar_to_cartesian(bench->a)))
+BENCH(vector_polar_to_cartesian_into, vector_polar_to_cartesian_into(bench->dst, bench->a))
+BENCH(vector_cartesian_to_polar, vector_free(vector_cartesian_to_polar(bench->a)))
+BENCH(vector_cartesian_to_polar_into, vector_cartesian_to_polar_into(bench->dst, bench->a))
+
+// Coordinate arrays; a and b are the inputs, dst and c the outputs
+static void bench_to_cartesian(bench_t* bench, bool approximate) {
+    const float* radii  = bench->a->elements;
+    const float* angles = bench->b->elements;
+    vector_polar_to_cartesian_array(
+        radii, angles, bench->dst->elements, bench->c->elements, bench->n, approximate
+    );
+}
+
+static void bench_to_polar(bench_t* bench, bool approximate) {
+    const float* xs = bench->a->elements;
+    const float* ys = bench->b->elements;
+    vector_cartesian_to_polar_array(
+        xs, ys, bench->dst->elements, bench->c->elements, bench->n, approximate
+    );
+}
+
+BENCH(vector_polar_to_cartesian_array, bench_to_cartesian(bench, false))
+BENCH(vector_polar_to_cartesian_array_approximate, bench_to_cartesian(bench, true))
+BENCH(vector_cartesian_to_polar_array, bench_to_polar(bench, false))
+BENCH(vector_cartesian_to_polar_array_approximate, bench_to_polar(bench, true))
+
+/**
+ * @param name Function name as printed
+ * @param dimensions Fixed operand size, or 0 to run at every size
+ * @param streams Arrays of n floats read or written once per call, for GB/s
+ * @param run Benchmark body
+ */
+typedef struct {
+    const char* name;
+    size_t      dimensions;
+    size_t      streams;
+    void (*run)(bench_t*);
+} bench_entry_t;
+
+#define BENCH_ENTRY(name, dimensions, streams) {#name, dimensions, streams, bench_##name}
+
+static const bench_entry_t entries[] = {
+    BENCH_ENTRY(vector_create, 0, 1),
+    BENCH_ENTRY(vector_create_aligned, 0, 1),
+    BENCH_ENTRY(vector_create_in, 0, 1),
+    BENCH_ENTRY(vector_deep_copy, 0, 2),
+    BENCH_ENTRY(vector_shallow_copy, 0, 0),
+    BENCH_ENTRY(vector_copy_into, 0, 2),
+    BENCH_ENTRY(scalar_elementwise_operation, 0, 2),
+    BENCH_ENTRY(scalar_elementwise_operation_into, 0, 2),
+    BENCH_ENTRY(vector_elementwise_operation, 0, 3),
+    BENCH_ENTRY(vector_elementwise_operation_into, 0, 3),
+    BENCH_ENTRY(vector_scalar_add, 0, 2),
+    BENCH_ENTRY(vector_scalar_subtract, 0, 2),
+    BENCH_ENTRY(vector_scalar_multiply, 0, 2),
+    BENCH_ENTRY(vector_scalar_divide, 0, 2),
+    BENCH_ENTRY(vector_scalar_add_into, 0, 2),
+    BENCH_ENTRY(vector_scalar_subtract_into, 0, 2),
+    BENCH_ENTRY(vector_scalar_multiply_into, 0, 2),
+    BENCH_ENTRY(vector_scalar_divide_into, 0, 2),
+    BENCH_ENTRY(vector_vector_add, 0, 3),
+    BENCH_ENTRY(vector_vector_subtract, 0, 3),
+    BENCH_ENTRY(vector_vector_multiply, 0, 3),
+    BENCH_ENTRY(vector_vector_divide, 0, 3),
+    BENCH_ENTRY(vector_vector_add_into, 0, 3),
+    BENCH_ENTRY(vector_vector_subtract_into, 0, 3),
+    BENCH_ENTRY(vector_vector_multiply_into, 0, 3),
+    BENCH_ENTRY(vector_vector_divide_into, 0, 3),
+    BENCH_ENTRY(vector_magnitude, 0, 1),
+    BENCH_ENTRY(vector_distance, 0, 2),
+    BENCH_ENTRY(vector_mean, 0, 1),
+    BENCH_ENTRY(vector_low_pass_filter, 0, 1),
+    BENCH_ENTRY(vector_normalize, 0, 2),
+    BENCH_ENTRY(vector_normalize_into, 0, 2),
+    BENCH_ENTRY(vector_scale, 0, 2),
+    BENCH_ENTRY(vector_scale_into, 0, 2),
+    BENCH_ENTRY(vector_clip, 0, 2),
+    BENCH_ENTRY(vector_clip_into, 0, 2),
+    BENCH_ENTRY(vector_dot_product, 0, 2),
+    BENCH_ENTRY(vector_polar_to_cartesian_array, 0, 4),
+    BENCH_ENTRY(vector_polar_to_cartesian_array_approximate, 0, 4),
+    BENCH_ENTRY(vector_cartesian_to_polar_array, 0, 4),
+    BENCH_ENTRY(vector_cartesian_to_polar_array_approximate, 0, 4),
+    BENCH_ENTRY(vector_cross_product, 3, 3),
+    BENCH_ENTRY(vector_cross_product_into, 3, 3),
+    BENCH_ENTRY(vector_polar_to_cartesian, 2, 2),
+    BENCH_ENTRY(vector_polar_to_cartesian_into, 2, 2),
+    BENCH_ENTRY(vector_cartesian_to_polar, 2, 2),
+    BENCH_ENTRY(vector_cartesian_to_polar_into, 2, 2),
+};
+
+typedef struct {
+    double ns_per_call;
+    double mallocs_per_call;
+} bench_result_t;
+
+// Best ns/call of three trials, each sized to about 2 * 10^7 elements of work
+static bench_result_t bench_run(const bench_entry_t* entry, bench_t* bench) {
+    size_t repetitions = (size_t) 2e7 / bench->n;
+    repetitions        = repetitions < 1 ? 1 : repetitions > 100000 ? 100000 : repetitions;
+
+    double best;
+    size_t start = allocations;
+    BENCH_BEST(best, 3, repetitions, entry->run(bench));
+
+    return (bench_result_t) {best, (double) (allocations - start) / (double) (3 * repetitions)};
+}
+
+// Create the operands of one size; values keep every operation finite and divisors nonzero
+static bool bench_create(bench_t* bench, size_t n, arena_t* arena) {
+    bench->n     = n;
+    bench->a     = vector_create(n);
+    bench->b     = vector_create(n);
+    bench->c     = vector_create(n);
+    bench->dst   = vector_create(n);
+    bench->arena = arena;
+    if (NULL == bench->a || NULL == bench->b || NULL == bench->c || NULL == bench->dst) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        bench->a->elements[i] = (float) (i % 97) * 0.625f + 1.0f;
+        bench->b->elements[i] = (float) (i % 89) * 0.25f - 11.125f;
+    }
+
+    return true;
+}
+
+static void bench_free(bench_t* bench) {
+    vector_free(bench->a);
+    vector_free(bench->b);
+    vector_free(bench->c);
+    vector_free(bench->dst);
+}
+
+static void bench_report(
+    const bench_entry_t* entry, size_t n, bench_result_t result, bool json, bool* first
+) {
+    double gbps = (double) (entry->streams * n * sizeof(float)) / result.ns_per_call;
+
+    if (json) {
+        printf(
+            "%s\n    {\"function\": \"%s\", \"elements\": %zu, \"ns_per_call\": %.3f, "
+            "\"ns_per_element\": %.5f, \"gb_per_s\": %.3f, \"mallocs_per_call\": %.2f}",
+            *first ? "" : ",",
+            entry->name,
+            n,
+            result.ns_per_call,
+            result.ns_per_call / (double) n,
+            gbps,
+            result.mallocs_per_call
+        );
+    } else {
+        printf(
+            "%-45s %10zu %14.2f %12.4f %9.2f %8.2f\n",
+            entry->name,
+            n,
+            result.ns_per_call,
+            result.ns_per_call / (double) n,
+            gbps,
+            result.mallocs_per_call
+        );
+    }
+
+    *first = false;
+}
+
+int main(int argc, char* argv[]) {
+    bool   json     = false;
+    size_t elements = 10000000;
+
+    for (int i = 1; i < argc; i++) {
+        if (0 == strcmp(argv[i], "--json")) {
+            json = true;
+        } else {
+            elements = strtoull(argv[i], NULL, 10);
+        }
+    }
+
+    const size_t sizes[] = {2, 16, 256, 4096, 65536, 1048576, 10000000};
+    const size_t count   = sizeof(entries) / sizeof(entries[0]);
+    bool         first   = true;
+
+    // Room for one vector header and aligned elements of the largest size
+    arena_t* arena = arena_create(elements * sizeof(float) + 4 * VECTOR_ALIGNMENT);
+    if (NULL == arena) {
+        return EXIT_FAILURE;
+    }
+
+    if (json) {
+        printf("{\n  \"simd\": \"%s\",\n  \"results\": [", simd_level_name(simd_get_level()));
+    } else {
+        printf("simd: %s\n", simd_level_name(simd_get_level()));
+        printf(
+            "%-45s %10s %14s %12s %9s %8s\n",
+            "function",
+            "elements",
+            "ns/call",
+            "ns/element",
+            "GB/s",
+            "mallocs"
+        );
+    }
+
+    float sink = 0.0f;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]) && sizes[s] <= elements; s++) {
+        bench_t bench = {0};
+        if (!bench_create(&bench, sizes[s], arena)) {
+            return EXIT_FAILURE;
+        }
+
+        for (size_t e = 0; e < count; e++) {
+            if (0 == entries[e].dimensions) {
+                bench_report(&entries[e], sizes[s], bench_run(&entries[e], &bench), json, &first);
+            }
+        }
+
+        sink += bench.sink;
+        bench_free(&bench);
+    }
+
+    for (size_t e = 0; e < count; e++) {
+        if (0 == entries[e].dimensions) {
+            continue;
+        }
+
+        bench_t bench = {0};
+        if (!bench_create(&bench, entries[e].dimensions, arena)) {
+            return EXIT_FAILURE;
+        }
+        bench_report(&entries[e], bench.n, bench_run(&entries[e], &bench), json, &first);
+        bench_free(&bench);
+    }
+
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+
+    arena_free(arena);
+
+    // Keeps the scalar results observable
+    if (sink == 42.0f) {
+        fprintf(stderr, "sink %f\n", sink);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -22,11 +22,13 @@ void print_matrix(const matrix_t* matrix) {
     for (size_t row = 0; row < matrix->rows; ++row) {
         fprintf(stderr, "  [ ");
 
+        const float* elements = matrix_row(matrix, row);
+
         for (size_t column = 0; column < matrix->columns; ++column) {
-            float element = matrix->elements[row][column];
+            float element = elements[column];
 
             // Print the value with proper formatting
-            fprintf(stderr, "%*.*f ", width - 2, width - 3, element);
+            fprintf(stderr, "%*.*f ", (int) width - 2, (int) width - 3, element);
         }
 
         fprintf(stderr, "]\n");
@@ -38,12 +40,22 @@ void print_matrix(const matrix_t* matrix) {
 int main(int argc, char* argv[]) {
     // Create a 2x2 matrix
     matrix_t* matrix = matrix_create(2, 2);
+    if (NULL == matrix) {
+        return 1;
+    }
 
     // Initialize the matrix with specific values
-    matrix->elements[0][0] = 1.25f;
-    matrix->elements[0][1] = 2.7f;
-    matrix->elements[1][0] = 3.15f;
-    matrix->elements[1][1] = 4.5f;
+    *matrix_at(matrix, 0, 0) = 1.25f;
+    *matrix_at(matrix, 0, 1) = 2.7f;
+
+    // Code written against the array-of-rows layout keeps working through the row view
+    float** elements = matrix_row_view(matrix);
+    if (NULL == elements) {
+        matrix_free(matrix);
+        return 1;
+    }
+    elements[1][0] = 3.15f;
+    elements[1][1] = 4.5f;
 
     // Print the initialized matrix
     print_matrix(matrix);
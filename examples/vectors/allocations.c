@@ -0,0 +1,152 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file examples/vectors/allocations.c
+ *
+ * @brief Check that a chain of *_into vector operations never touches the heap.
+ *
+ * Usage: vector_allocations [elements]
+ *
+ * Every operand is allocated up front, then a chain of *_into calls runs over them, several of
+ * them with the destination aliasing an input. Allocations are counted by wrapping the allocator
+ * at link time, so this target must be linked with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=aligned_alloc (see CMakeLists.txt).
+ *
+ * The chain runs once serially and once on a pool of four threads. The pool grows its buffer of
+ * partial sums on the first reduction it runs, so that pass is warmed up once before counting.
+ *
+ * Exits with EXIT_FAILURE if any call fails or allocates. Runs headless; no SDL window is created.
+ */
+
+#include "../../pool.h"
+#include "../../vector.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Allocation counting
+
+static size_t allocations = 0;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+    allocations++;
+    return __real_aligned_alloc(alignment, size);
+}
+
+// Operands allocated before counting starts
+typedef struct {
+    vector_t* a;
+    vector_t* b;
+    vector_t* dst;
+    vector_t* u; ///< 3-dimensional, for the cross product
+    vector_t* v; ///< 3-dimensional, for the cross product
+    vector_t* p; ///< 2-dimensional, for the coordinate conversions
+} operands_t;
+
+// Run every *_into operation once; returns the number of calls that failed
+static size_t run_chain(operands_t* o) {
+    size_t failures = 0;
+
+    failures += NULL == vector_copy_into(o->dst, o->a);
+    failures += NULL == vector_scalar_add_into(o->dst, o->dst, 2.0f);
+    failures += NULL == vector_scalar_subtract_into(o->dst, o->a, 1.0f);
+    failures += NULL == vector_scalar_multiply_into(o->dst, o->dst, 0.5f);
+    failures += NULL == vector_scalar_divide_into(o->dst, o->dst, 4.0f);
+
+    // dst == a
+    failures += NULL == vector_vector_add_into(o->a, o->a, o->b);
+    failures += NULL == vector_vector_subtract_into(o->a, o->a, o->b);
+    failures += NULL == vector_vector_multiply_into(o->dst, o->a, o->b);
+    failures += NULL == vector_vector_divide_into(o->dst, o->dst, o->b);
+
+    failures += NULL == vector_normalize_into(o->dst, o->dst);
+    failures += NULL == vector_scale_into(o->dst, o->dst, 3.0f);
+    failures += NULL == vector_clip_into(o->dst, o->dst, -1.0f, 1.0f);
+
+    failures += NULL == vector_cross_product_into(o->u, o->u, o->v);
+    failures += NULL == vector_cartesian_to_polar_into(o->p, o->p);
+    failures += NULL == vector_polar_to_cartesian_into(o->p, o->p);
+
+    return failures;
+}
+
+// Count the allocations of one pass of the chain; returns false on a failure or an allocation
+static bool check_chain(operands_t* o, const char* label) {
+    allocations     = 0;
+    size_t failures = run_chain(o);
+    size_t counted  = allocations;
+
+    printf("%-8s %zu failed calls, %zu allocations\n", label, failures, counted);
+    return 0 == failures && 0 == counted;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1 << 20;
+
+    operands_t o = {
+        .a   = vector_create_aligned(n),
+        .b   = vector_create_aligned(n),
+        .dst = vector_create_aligned(n),
+        .u   = vector_create(3),
+        .v   = vector_create(3),
+        .p   = vector_create(2),
+    };
+    if (NULL == o.a || NULL == o.b || NULL == o.dst || NULL == o.u || NULL == o.v || NULL == o.p) {
+        fprintf(stderr, "Failed to allocate the operands.\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        o.a->elements[i] = (float) (i % 101) + 1.0f;
+        o.b->elements[i] = (float) (i % 37) + 1.0f;
+    }
+    for (size_t i = 0; i < 3; i++) {
+        o.u->elements[i] = (float) i + 1.0f;
+        o.v->elements[i] = (float) i - 1.0f;
+    }
+    o.p->elements[0] = 3.0f;
+    o.p->elements[1] = 4.0f;
+
+    bool passed = check_chain(&o, "serial");
+
+    pool_t* pool = pool_create(4);
+    if (NULL == pool) {
+        return EXIT_FAILURE;
+    }
+    vector_set_pool(pool);
+    run_chain(&o); // warm up the pool's partial sums
+    passed = check_chain(&o, "pool") && passed;
+    vector_set_pool(NULL);
+    pool_free(pool);
+
+    vector_free(o.a);
+    vector_free(o.b);
+    vector_free(o.dst);
+    vector_free(o.u);
+    vector_free(o.v);
+    vector_free(o.p);
+
+    printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file expr.c
+ *
+ * @brief Deferred, fused element-wise vector expressions
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "expr.h"
+#include "kernels.h"
+
+#include <stdio.h>
+
+// Elements evaluated per block; small enough that the block and one block of each operand stay in
+// L1 cache, large enough to amortize dispatching each step
+#define EXPR_BLOCK 512
+
+// Expression lifecycle
+expr_t* expr_init(expr_t* expr, const vector_t* source) {
+    if (NULL == expr || NULL == source) {
+        return NULL;
+    }
+
+    expr->source = source;
+    expr->count  = 0;
+    expr->valid  = true;
+
+    return expr;
+}
+
+static expr_t* expr_record(expr_t* expr, expr_step_t step) {
+    if (NULL == expr || !expr->valid) {
+        return NULL;
+    }
+
+    if (NULL == step.operation) {
+        fprintf(stderr, "Expression operation is NULL.\n");
+        expr->valid = false;
+        return NULL;
+    }
+
+    if (EXPR_MAX_STEPS == expr->count) {
+        fprintf(stderr, "Expression is full; it holds at most %d operations.\n", EXPR_MAX_STEPS);
+        expr->valid = false;
+        return NULL;
+    }
+
+    expr->steps[expr->count++] = step;
+    return expr;
+}
+
+expr_t* expr_scalar(expr_t* expr, const float b, float (*operation)(float, float)) {
+    return expr_record(expr, (expr_step_t) {operation, NULL, b});
+}
+
+expr_t* expr_vector(expr_t* expr, const vector_t* b, float (*operation)(float, float)) {
+    if (NULL != expr && expr->valid
+        && (NULL == b || b->dimensions != expr->source->dimensions)) {
+        fprintf(stderr, "Expression operand dimensions do not match the source.\n");
+        expr->valid = false;
+        return NULL;
+    }
+
+    return expr_record(expr, (expr_step_t) {operation, b, 0.0f});
+}
+
+// Apply one step to the block of elements starting at offset; returns the zero divisor count
+static size_t
+expr_apply(float* dst, const float* a, const expr_step_t* step, size_t offset, size_t n) {
+    if (NULL == step->vector) {
+        return scalar_elementwise_chunk(dst, a, step->scalar, n, step->operation);
+    }
+
+    return vector_elementwise_chunk(dst, a, step->vector->elements + offset, n, step->operation);
+}
+
+// Expression evaluation
+vector_t* expr_evaluate_into(vector_t* dst, const expr_t* expr) {
+    if (NULL == dst || NULL == expr || !expr->valid) {
+        return NULL;
+    }
+
+    const size_t n = expr->source->dimensions;
+    if (dst->dimensions != n) {
+        fprintf(stderr, "Expression destination dimensions do not match the source.\n");
+        return NULL;
+    }
+
+    if (0 == expr->count) {
+        return vector_copy_into(dst, expr->source);
+    }
+
+    _Alignas(VECTOR_ALIGNMENT) float block[EXPR_BLOCK];
+    const size_t                     last  = expr->count - 1;
+    size_t                           zeros = 0;
+
+    // Every step reads and writes the same element range of a block, so a block is fully read
+    // before it is stored and dst may alias any input
+    for (size_t offset = 0; offset < n; offset += EXPR_BLOCK) {
+        const size_t m = n - offset < EXPR_BLOCK ? n - offset : EXPR_BLOCK;
+        const float* a = expr->source->elements + offset;
+
+        for (size_t s = 0; s <= last; s++) {
+            // The final step stores straight into dst; earlier steps stay in the block
+            float* out  = s == last ? dst->elements + offset : block;
+            zeros      += expr_apply(out, a, &expr->steps[s], offset, m);
+            a           = block;
+        }
+    }
+
+    if (zeros > 0) {
+        fprintf(stderr, "Division by zero is undefined. %zu divisors are zero.\n", zeros);
+    }
+
+    return dst;
+}
+
+vector_t* expr_evaluate(const expr_t* expr) {
+    if (NULL == expr || !expr->valid) {
+        return NULL;
+    }
+
+    vector_t* result = vector_create(expr->source->dimensions);
+    if (NULL == result) {
+        fprintf(stderr, "Failed to allocate memory for the expression result.\n");
+        return NULL;
+    }
+
+    if (NULL == expr_evaluate_into(result, expr)) {
+        vector_free(result);
+        return NULL;
+    }
+
+    return result;
+}
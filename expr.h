@@ -0,0 +1,113 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file expr.h
+ *
+ * @brief Deferred, fused element-wise vector expressions
+ *
+ * An expr_t records a chain of element-wise operations on a source vector without computing
+ * anything. Evaluating it runs the whole chain in a single pass: the output is produced in small
+ * blocks that stay in L1 cache, so every input is read once and the output is written once, with
+ * no intermediate vectors.
+ *
+ * The operations are the same scalar_* helpers accepted by the element-wise executors in vector.h.
+ * For example, (a * b) + c:
+ *
+ *     expr_t expr;
+ *     expr_init(&expr, a);
+ *     expr_vector(&expr, b, scalar_multiply);
+ *     expr_vector(&expr, c, scalar_add);
+ *     expr_evaluate_into(out, &expr);
+ *
+ * An expression only refers to its vectors; they must outlive it and be unchanged until it is
+ * evaluated.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef EXPR_H
+#define EXPR_H
+
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Maximum number of operations recorded in one expression
+#define EXPR_MAX_STEPS 16
+
+/**
+ * @brief One recorded operation, applied as result = operation(result, operand).
+ */
+typedef struct {
+    float (*operation)(float, float); ///< Element-wise operation.
+    const vector_t* vector;           ///< Vector operand, or NULL for a scalar operand.
+    float           scalar;           ///< Scalar operand.
+} expr_step_t;
+
+/**
+ * @brief A deferred chain of element-wise operations on a source vector.
+ *
+ * Fixed-size, so expressions can live on the stack and building one never allocates.
+ */
+typedef struct {
+    const vector_t* source;                ///< Vector the chain starts from.
+    expr_step_t     steps[EXPR_MAX_STEPS]; ///< Recorded operations, in order.
+    size_t          count;                 ///< Number of recorded operations.
+    bool            valid;                 ///< False once recording an operation has failed.
+} expr_t;
+
+/**
+ * @brief Start an expression from a source vector.
+ *
+ * @param expr Expression to initialize
+ * @param source Vector the chain starts from
+ * @return expr on success, NULL if either argument is NULL
+ */
+expr_t* expr_init(expr_t* expr, const vector_t* source);
+
+/**
+ * @brief Record an operation with a scalar operand.
+ *
+ * @param expr Expression to extend
+ * @param b Scalar operand
+ * @param operation A pointer to the function performing the element-wise operation
+ * @return expr on success, NULL if the expression is full or invalid
+ */
+expr_t* expr_scalar(expr_t* expr, const float b, float (*operation)(float, float));
+
+/**
+ * @brief Record an operation with a vector operand.
+ *
+ * @param expr Expression to extend
+ * @param b Vector operand with the same dimensions as the source
+ * @param operation A pointer to the function performing the element-wise operation
+ * @return expr on success, NULL if the dimensions do not match or the expression is full or invalid
+ */
+expr_t* expr_vector(expr_t* expr, const vector_t* b, float (*operation)(float, float));
+
+/**
+ * @brief Evaluate an expression into a destination vector in one fused pass.
+ *
+ * The destination may alias the source or any operand. The scalar_* helpers run as vectorizable
+ * loops; other operations are called once per element. Division by zero yields NaN and is reported
+ * once per evaluation.
+ *
+ * @param dst Destination vector with the same dimensions as the source
+ * @param expr Expression to evaluate
+ * @return dst on success, NULL if the expression is invalid or the dimensions do not match
+ */
+vector_t* expr_evaluate_into(vector_t* dst, const expr_t* expr);
+
+/**
+ * @brief Evaluate an expression into a newly allocated vector.
+ *
+ * @param expr Expression to evaluate
+ * @return A pointer to the resulting vector, NULL on failure
+ */
+vector_t* expr_evaluate(const expr_t* expr);
+
+#endif // EXPR_H
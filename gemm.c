@@ -0,0 +1,494 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file gemm.c
+ *
+ * @brief Single-precision general matrix multiplication
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "gemm.h"
+#include "simd.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define GEMM_X86 1
+    #include <immintrin.h>
+#else
+    #define GEMM_X86 0
+#endif
+
+// Alignment in bytes of the packing buffers
+#define GEMM_ALIGNMENT 64
+
+// Tiles of C per thread in a parallel depth block; more tiles balance better, fewer share better
+#define GEMM_TILES_PER_THREAD 4
+
+// Panels packed per chunk of a parallel packing job
+#define GEMM_PACK_CHUNK 8
+
+static pool_t* gemm_pool = NULL;
+
+void gemm_set_pool(pool_t* pool) {
+    gemm_pool = pool;
+}
+
+pool_t* gemm_get_pool(void) {
+    return gemm_pool;
+}
+
+/**
+ * Computes one full GEMM_MR x GEMM_NR tile, c = α(a b) + βc, from packed panels of depth kc.
+ * With β = 0, c is only written.
+ */
+typedef void (*gemm_kernel_t)(
+    size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta
+);
+
+// Packing
+
+// Copy mc x kc of A into GEMM_MR-row panels, column by column, zero-padding the last panel
+static void gemm_pack_a(size_t mc, size_t kc, const float* a, size_t lda, float* packed) {
+    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        const size_t mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+        const float* panel = a + ir * lda;
+
+        for (size_t p = 0; p < kc; p++) {
+            for (size_t i = 0; i < mr; i++) {
+                packed[i] = panel[i * lda + p];
+            }
+            for (size_t i = mr; i < GEMM_MR; i++) {
+                packed[i] = 0.0f;
+            }
+            packed += GEMM_MR;
+        }
+    }
+}
+
+// Copy kc x nc of B into GEMM_NR-column panels, row by row, zero-padding the last panel
+static void gemm_pack_b(size_t kc, size_t nc, const float* b, size_t ldb, float* packed) {
+    for (size_t jr = 0; jr < nc; jr += GEMM_NR) {
+        const size_t nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+
+        for (size_t p = 0; p < kc; p++) {
+            const float* row = b + p * ldb + jr;
+            memcpy(packed, row, nr * sizeof(float));
+            for (size_t j = nr; j < GEMM_NR; j++) {
+                packed[j] = 0.0f;
+            }
+            packed += GEMM_NR;
+        }
+    }
+}
+
+// Micro-kernels
+
+// One row of the tile at a time keeps its GEMM_NR accumulators in registers on any vector width
+static void gemm_kernel_scalar(
+    size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta
+) {
+    for (size_t i = 0; i < GEMM_MR; i++) {
+        float acc[GEMM_NR] = {0};
+
+        for (size_t p = 0; p < kc; p++) {
+            const float  ai = a[p * GEMM_MR + i];
+            const float* bp = b + p * GEMM_NR;
+            for (size_t j = 0; j < GEMM_NR; j++) {
+                acc[j] += ai * bp[j];
+            }
+        }
+
+        float* row = c + i * ldc;
+        if (0.0f == beta) {
+            for (size_t j = 0; j < GEMM_NR; j++) {
+                row[j] = alpha * acc[j];
+            }
+        } else {
+            for (size_t j = 0; j < GEMM_NR; j++) {
+                row[j] = alpha * acc[j] + beta * row[j];
+            }
+        }
+    }
+}
+
+#if GEMM_X86
+
+// 6 x 16 tile in 12 accumulators: each step loads two vectors of B and broadcasts six values of A
+    #define GEMM_AVX2_STEP(i)                       \
+        ai      = _mm256_broadcast_ss(a + i);       \
+        c##i##0 = _mm256_fmadd_ps(ai, b0, c##i##0); \
+        c##i##1 = _mm256_fmadd_ps(ai, b1, c##i##1);
+
+    #define GEMM_AVX2_STORE(i)                                                    \
+        {                                                                         \
+            float* row = c + i * ldc;                                             \
+            c##i##0    = _mm256_mul_ps(va, c##i##0);                              \
+            c##i##1    = _mm256_mul_ps(va, c##i##1);                              \
+            if (0.0f != beta) {                                                   \
+                c##i##0 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row + 0), c##i##0); \
+                c##i##1 = _mm256_fmadd_ps(vb, _mm256_loadu_ps(row + 8), c##i##1); \
+            }                                                                     \
+            _mm256_storeu_ps(row + 0, c##i##0);                                   \
+            _mm256_storeu_ps(row + 8, c##i##1);                                   \
+        }
+
+__attribute__((target("avx2,fma"))) static void gemm_kernel_avx2(
+    size_t kc, const float* a, const float* b, float* c, size_t ldc, float alpha, float beta
+) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+    __m256 ai;
+
+    for (size_t p = 0; p < kc; p++) {
+        const __m256 b0 = _mm256_load_ps(b + 0);
+        const __m256 b1 = _mm256_load_ps(b + 8);
+
+        GEMM_AVX2_STEP(0)
+        GEMM_AVX2_STEP(1)
+        GEMM_AVX2_STEP(2)
+        GEMM_AVX2_STEP(3)
+        GEMM_AVX2_STEP(4)
+        GEMM_AVX2_STEP(5)
+
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    const __m256 va = _mm256_set1_ps(alpha);
+    const __m256 vb = _mm256_set1_ps(beta);
+
+    GEMM_AVX2_STORE(0)
+    GEMM_AVX2_STORE(1)
+    GEMM_AVX2_STORE(2)
+    GEMM_AVX2_STORE(3)
+    GEMM_AVX2_STORE(4)
+    GEMM_AVX2_STORE(5)
+}
+
+#endif // GEMM_X86
+
+static gemm_kernel_t gemm_select_kernel(void) {
+#if GEMM_X86
+    if (simd_get_level() >= SIMD_AVX2) {
+        return gemm_kernel_avx2;
+    }
+#endif
+    return gemm_kernel_scalar;
+}
+
+// Blocked multiplication
+
+// Multiply a packed mc x kc block of A by a packed kc x nc block of B into C
+static void gemm_macro_kernel(
+    gemm_kernel_t kernel,
+    size_t        mc,
+    size_t        nc,
+    size_t        kc,
+    float         alpha,
+    const float*  packed_a,
+    const float*  packed_b,
+    float         beta,
+    float*        c,
+    size_t        ldc
+) {
+    _Alignas(GEMM_ALIGNMENT) float tile[GEMM_MR * GEMM_NR];
+
+    for (size_t jr = 0; jr < nc; jr += GEMM_NR) {
+        const size_t nr = nc - jr < GEMM_NR ? nc - jr : GEMM_NR;
+
+        for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+            const size_t mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+            const float* a  = packed_a + ir * kc;
+            const float* b  = packed_b + jr * kc;
+            float*       ct = c + ir * ldc + jr;
+
+            if (GEMM_MR == mr && GEMM_NR == nr) {
+                kernel(kc, a, b, ct, ldc, alpha, beta);
+                continue;
+            }
+
+            // Edge tile: compute the full tile aside, then merge only the valid part
+            kernel(kc, a, b, tile, GEMM_NR, alpha, 0.0f);
+            for (size_t i = 0; i < mr; i++) {
+                for (size_t j = 0; j < nr; j++) {
+                    float value     = tile[i * GEMM_NR + j];
+                    ct[i * ldc + j] = 0.0f == beta ? value : value + beta * ct[i * ldc + j];
+                }
+            }
+        }
+    }
+}
+
+// C = βC, without reading C when β is 0
+static void gemm_scale(size_t m, size_t n, float beta, float* c, size_t ldc) {
+    for (size_t i = 0; i < m; i++) {
+        float* row = c + i * ldc;
+        if (0.0f == beta) {
+            memset(row, 0, n * sizeof(float));
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                row[j] *= beta;
+            }
+        }
+    }
+}
+
+static size_t gemm_round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Serial blocked multiplication: one A block is packed at a time, sized for the L2 cache
+static bool gemm_serial(
+    gemm_kernel_t kernel,
+    size_t        m,
+    size_t        n,
+    size_t        k,
+    float         alpha,
+    const float*  a,
+    size_t        lda,
+    const float*  b,
+    size_t        ldb,
+    float         beta,
+    float*        c,
+    size_t        ldc
+) {
+    // Size the packing buffers to the problem, capped at one cache block
+    const size_t mc_max = gemm_round_up(m < GEMM_MC ? m : GEMM_MC, GEMM_MR);
+    const size_t nc_max = gemm_round_up(n < GEMM_NC ? n : GEMM_NC, GEMM_NR);
+    const size_t kc_max = k < GEMM_KC ? k : GEMM_KC;
+    const size_t size_a = gemm_round_up(mc_max * kc_max * sizeof(float), GEMM_ALIGNMENT);
+    const size_t size_b = gemm_round_up(nc_max * kc_max * sizeof(float), GEMM_ALIGNMENT);
+
+    float* packed_a = (float*) aligned_alloc(GEMM_ALIGNMENT, size_a);
+    float* packed_b = (float*) aligned_alloc(GEMM_ALIGNMENT, size_b);
+    if (NULL == packed_a || NULL == packed_b) {
+        fprintf(stderr, "Failed to allocate %zu bytes of GEMM packing buffers.\n", size_a + size_b);
+        free(packed_a);
+        free(packed_b);
+        return false;
+    }
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        const size_t nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            const size_t kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+
+            // Only the first depth block applies β; later blocks accumulate onto it
+            const float beta_block = 0 == pc ? beta : 1.0f;
+
+            gemm_pack_b(kc, nc, b + pc * ldb + jc, ldb, packed_b);
+
+            for (size_t ic = 0; ic < m; ic += GEMM_MC) {
+                const size_t mc = m - ic < GEMM_MC ? m - ic : GEMM_MC;
+
+                gemm_pack_a(mc, kc, a + ic * lda + pc, lda, packed_a);
+                gemm_macro_kernel(
+                    kernel,
+                    mc,
+                    nc,
+                    kc,
+                    alpha,
+                    packed_a,
+                    packed_b,
+                    beta_block,
+                    c + ic * ldc + jc,
+                    ldc
+                );
+            }
+        }
+    }
+
+    free(packed_a);
+    free(packed_b);
+
+    return true;
+}
+
+// One depth block of a parallel multiplication, shared by every thread
+typedef struct {
+    gemm_kernel_t kernel;
+    size_t        m;
+    size_t        nc;
+    size_t        kc;
+    float         alpha;
+    const float*  a;        ///< A at the first column of the depth block.
+    size_t        lda;
+    const float*  b;        ///< B at the first row of the depth block and column of the C block.
+    size_t        ldb;
+    float         beta;     ///< β of this depth block.
+    float*        c;        ///< C at the first column of the C block.
+    size_t        ldc;
+    float*        packed_a; ///< All m rows of A, in GEMM_MR-row panels.
+    float*        packed_b; ///< All nc columns of B, in GEMM_NR-column panels.
+    size_t        columns;  ///< Columns of C per tile, a multiple of GEMM_NR.
+    size_t        tiles_n;  ///< Tiles across one GEMM_MC-row block of C.
+} gemm_job_t;
+
+// Pack the GEMM_MR-row panels [begin, end) of A
+static void gemm_pack_a_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    gemm_job_t*  job  = (gemm_job_t*) context;
+    const size_t row  = begin * GEMM_MR;
+    const size_t rows = end * GEMM_MR < job->m ? end * GEMM_MR - row : job->m - row;
+
+    gemm_pack_a(rows, job->kc, job->a + row * job->lda, job->lda, job->packed_a + row * job->kc);
+}
+
+// Pack the GEMM_NR-column panels [begin, end) of B
+static void gemm_pack_b_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    gemm_job_t*  job     = (gemm_job_t*) context;
+    const size_t column  = begin * GEMM_NR;
+    const size_t columns = end * GEMM_NR < job->nc ? end * GEMM_NR - column : job->nc - column;
+
+    gemm_pack_b(job->kc, columns, job->b + column, job->ldb, job->packed_b + column * job->kc);
+}
+
+// Multiply the tiles [begin, end) of C, numbered row block by row block
+static void gemm_tile_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    gemm_job_t* job = (gemm_job_t*) context;
+
+    for (size_t tile = begin; tile < end; tile++) {
+        const size_t ic = tile / job->tiles_n * GEMM_MC;
+        const size_t jr = tile % job->tiles_n * job->columns;
+        const size_t mc = job->m - ic < GEMM_MC ? job->m - ic : GEMM_MC;
+        const size_t nr = job->nc - jr < job->columns ? job->nc - jr : job->columns;
+
+        gemm_macro_kernel(
+            job->kernel,
+            mc,
+            nr,
+            job->kc,
+            job->alpha,
+            job->packed_a + ic * job->kc,
+            job->packed_b + jr * job->kc,
+            job->beta,
+            job->c + ic * job->ldc + jr,
+            job->ldc
+        );
+    }
+}
+
+// Parallel blocked multiplication: all of A is packed per depth block so tiles can share it
+static bool gemm_parallel(
+    pool_t*       pool,
+    gemm_kernel_t kernel,
+    size_t        m,
+    size_t        n,
+    size_t        k,
+    float         alpha,
+    const float*  a,
+    size_t        lda,
+    const float*  b,
+    size_t        ldb,
+    float         beta,
+    float*        c,
+    size_t        ldc
+) {
+    const size_t nc_max = gemm_round_up(n < GEMM_NC ? n : GEMM_NC, GEMM_NR);
+    const size_t kc_max = k < GEMM_KC ? k : GEMM_KC;
+    const size_t rows   = gemm_round_up(m, GEMM_MR);
+    const size_t size_a = gemm_round_up(rows * kc_max * sizeof(float), GEMM_ALIGNMENT);
+    const size_t size_b = gemm_round_up(nc_max * kc_max * sizeof(float), GEMM_ALIGNMENT);
+
+    float* packed_a = (float*) aligned_alloc(GEMM_ALIGNMENT, size_a);
+    float* packed_b = (float*) aligned_alloc(GEMM_ALIGNMENT, size_b);
+    if (NULL == packed_a || NULL == packed_b) {
+        fprintf(stderr, "Failed to allocate %zu bytes of shared GEMM panels; ", size_a + size_b);
+        fprintf(stderr, "multiplying serially.\n");
+        free(packed_a);
+        free(packed_b);
+        return gemm_serial(kernel, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+
+    // Split each GEMM_MC-row block into enough column tiles to give every thread several
+    const size_t tiles_m  = (m + GEMM_MC - 1) / GEMM_MC;
+    const size_t wanted   = pool_threads(pool) * GEMM_TILES_PER_THREAD;
+    const size_t split    = (wanted + tiles_m - 1) / tiles_m;
+    const size_t panels_a = rows / GEMM_MR;
+
+    gemm_job_t job = {0};
+    job.kernel     = kernel;
+    job.m          = m;
+    job.alpha      = alpha;
+    job.lda        = lda;
+    job.ldb        = ldb;
+    job.ldc        = ldc;
+    job.packed_a   = packed_a;
+    job.packed_b   = packed_b;
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        job.nc      = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+        job.c       = c + jc;
+        job.columns = gemm_round_up((job.nc + split - 1) / split, GEMM_NR);
+        job.tiles_n = (job.nc + job.columns - 1) / job.columns;
+
+        const size_t panels_b = (job.nc + GEMM_NR - 1) / GEMM_NR;
+
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            job.kc   = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+            job.a    = a + pc;
+            job.b    = b + pc * ldb + jc;
+            job.beta = 0 == pc ? beta : 1.0f;
+
+            // Pack, then multiply; each pool_for returns only once every thread is done
+            pool_for(pool, panels_b, GEMM_PACK_CHUNK, gemm_pack_b_task, &job);
+            pool_for(pool, panels_a, GEMM_PACK_CHUNK, gemm_pack_a_task, &job);
+            pool_for(pool, tiles_m * job.tiles_n, 1, gemm_tile_task, &job);
+        }
+    }
+
+    free(packed_a);
+    free(packed_b);
+
+    return true;
+}
+
+bool gemm(
+    size_t       m,
+    size_t       n,
+    size_t       k,
+    float        alpha,
+    const float* a,
+    size_t       lda,
+    const float* b,
+    size_t       ldb,
+    float        beta,
+    float*       c,
+    size_t       ldc
+) {
+    if (0 == m || 0 == n) {
+        return true;
+    }
+
+    if (0 == k || 0.0f == alpha) {
+        gemm_scale(m, n, beta, c, ldc);
+        return true;
+    }
+
+    const gemm_kernel_t kernel = gemm_select_kernel();
+    const double        work   = (double) m * (double) n * (double) k;
+
+    if (pool_threads(gemm_pool) > 1 && work >= GEMM_PARALLEL_THRESHOLD) {
+        return gemm_parallel(gemm_pool, kernel, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+
+    return gemm_serial(kernel, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
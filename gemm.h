@@ -0,0 +1,100 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file gemm.h
+ *
+ * @brief Single-precision general matrix multiplication
+ *
+ * gemm() computes C = αAB + βC for row-major matrices given as raw pointers and leading dimensions,
+ * following the BLAS sgemm convention without transposes. It is the engine behind
+ * matrix_multiply().
+ *
+ * The implementation follows the Goto/BLIS structure: B is packed into panels that stay in the L3
+ * cache, A into panels that stay in the L2 cache, and a register-tiled micro-kernel multiplies one
+ * GEMM_MR x GEMM_NR tile of C at a time from the L1 cache. The micro-kernel uses AVX2 and FMA when
+ * the running CPU supports them (see simd.h) and a portable C kernel otherwise. Edge tiles of any
+ * size are handled, so every shape is supported.
+ *
+ * With a pool set by gemm_set_pool(), large products are split across its threads. Each depth
+ * block packs B and A once, cooperatively, into buffers shared by every thread, and C is divided
+ * into a 2D grid of tiles that the threads claim one at a time. Every tile is computed exactly as
+ * the serial code computes it, so the result is bit-identical for any thread count.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "pool.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Register tile: rows and columns of C computed per micro-kernel call
+#define GEMM_MR 6
+#define GEMM_NR 16
+
+// Cache blocks: rows of A (L2), depth (L1 panels) and columns of B (L3) packed at a time
+#define GEMM_MC 120
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+/**
+ * @brief Products of at least this many multiply-adds (m * n * k) run on the pool, if one is set.
+ * Smaller products always run serially on the caller, where waking the workers would cost more
+ * than it saves.
+ */
+#define GEMM_PARALLEL_THRESHOLD (1 << 23)
+
+/**
+ * @brief Set the pool used to parallelize large products.
+ *
+ * The pool is borrowed, not owned; clear it with gemm_set_pool(NULL) before freeing it. Pin its
+ * threads with pool_pin() to keep each one on the cores whose caches hold its packed panels.
+ *
+ * @param pool Pool to use, or NULL to run serially (the default)
+ */
+void gemm_set_pool(pool_t* pool);
+
+/**
+ * @brief Return the pool used to parallelize large products, or NULL.
+ */
+pool_t* gemm_get_pool(void);
+
+/**
+ * @brief Compute C = αAB + βC for row-major single-precision matrices.
+ *
+ * When β is 0, C is not read, so it may hold uninitialized values. C must not overlap A or B.
+ *
+ * @param m Rows of A and C
+ * @param n Columns of B and C
+ * @param k Columns of A and rows of B
+ * @param alpha Scale of the product AB
+ * @param a m x k matrix A
+ * @param lda Floats between consecutive rows of A; at least k
+ * @param b k x n matrix B
+ * @param ldb Floats between consecutive rows of B; at least n
+ * @param beta Scale of the existing C
+ * @param c m x n matrix C, updated in place
+ * @param ldc Floats between consecutive rows of C; at least n
+ * @return true on success, false if the packing buffers cannot be allocated
+ */
+bool gemm(
+    size_t       m,
+    size_t       n,
+    size_t       k,
+    float        alpha,
+    const float* a,
+    size_t       lda,
+    const float* b,
+    size_t       ldb,
+    float        beta,
+    float*       c,
+    size_t       ldc
+);
+
+#endif // GEMM_H
@@ -0,0 +1,131 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file kernels.h
+ *
+ * @brief Specialized element-wise kernels shared by vector.c and expr.c
+ *
+ * The element-wise executors in vector.c and the expression evaluator in expr.c recognize the
+ * scalar_* helpers and route them to these loops instead of calling through the function pointer
+ * once per element. Each loop body is a single arithmetic expression the compiler can inline and
+ * auto-vectorize. The destination may alias an input, so the pointers are deliberately not
+ * restrict-qualified; the compiler emits a runtime overlap check.
+ *
+ * Internal to the library; not part of the public API.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "vector.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#define SCALAR_ELEMENTWISE_KERNEL(name, op)                                        \
+    static inline void name(float* dst, const float* a, const float b, size_t n) { \
+        for (size_t i = 0; i < n; i++) {                                           \
+            dst[i] = a[i] op b;                                                    \
+        }                                                                          \
+    }
+
+#define VECTOR_ELEMENTWISE_KERNEL(name, op)                                         \
+    static inline void name(float* dst, const float* a, const float* b, size_t n) { \
+        for (size_t i = 0; i < n; i++) {                                            \
+            dst[i] = a[i] op b[i];                                                  \
+        }                                                                           \
+    }
+
+SCALAR_ELEMENTWISE_KERNEL(scalar_add_kernel, +)
+SCALAR_ELEMENTWISE_KERNEL(scalar_subtract_kernel, -)
+SCALAR_ELEMENTWISE_KERNEL(scalar_multiply_kernel, *)
+
+VECTOR_ELEMENTWISE_KERNEL(vector_add_kernel, +)
+VECTOR_ELEMENTWISE_KERNEL(vector_subtract_kernel, -)
+VECTOR_ELEMENTWISE_KERNEL(vector_multiply_kernel, *)
+
+// Divisions return the number of zero divisors so the caller reports them once per call
+static inline size_t scalar_divide_kernel(float* dst, const float* a, const float b, size_t n) {
+    if (0 == b) {
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = NAN; // Division by zero is undefined
+        }
+        return n;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = a[i] / b;
+    }
+    return 0;
+}
+
+static inline size_t vector_divide_kernel(float* dst, const float* a, const float* b, size_t n) {
+    size_t zeros = 0;
+
+    // Count zero divisors up front; the common case then runs as a plain vectorized division
+    for (size_t i = 0; i < n; i++) {
+        zeros += (0 == b[i]);
+    }
+
+    if (0 == zeros) {
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = a[i] / b[i];
+        }
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = (0 == b[i]) ? NAN : a[i] / b[i]; // Division by zero is undefined
+    }
+    return zeros;
+}
+
+// Dispatch known operations to their specialized kernels; returns the number of zero divisors
+static inline size_t scalar_elementwise_chunk(
+    float* dst, const float* a, const float b, size_t n, float (*operation)(float, float)
+) {
+    if (scalar_add == operation) {
+        scalar_add_kernel(dst, a, b, n);
+    } else if (scalar_subtract == operation) {
+        scalar_subtract_kernel(dst, a, b, n);
+    } else if (scalar_multiply == operation) {
+        scalar_multiply_kernel(dst, a, b, n);
+    } else if (scalar_divide == operation) {
+        return scalar_divide_kernel(dst, a, b, n);
+    } else {
+        // Perform element-wise operation
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = operation(a[i], b);
+        }
+    }
+
+    return 0;
+}
+
+static inline size_t vector_elementwise_chunk(
+    float* dst, const float* a, const float* b, size_t n, float (*operation)(float, float)
+) {
+    if (scalar_add == operation) {
+        vector_add_kernel(dst, a, b, n);
+    } else if (scalar_subtract == operation) {
+        vector_subtract_kernel(dst, a, b, n);
+    } else if (scalar_multiply == operation) {
+        vector_multiply_kernel(dst, a, b, n);
+    } else if (scalar_divide == operation) {
+        return vector_divide_kernel(dst, a, b, n);
+    } else {
+        // Perform element-wise operation
+        for (size_t i = 0; i < n; i++) {
+            dst[i] = operation(a[i], b[i]);
+        }
+    }
+
+    return 0;
+}
+
+#endif // KERNELS_H
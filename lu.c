@@ -0,0 +1,494 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file lu.c
+ *
+ * @brief LU factorization with partial pivoting, with solves, determinants and inverses on top
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "lu.h"
+
+#include "simd.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Panels at most this wide are factored one column at a time
+#define LU_PANEL_LEAF 16
+
+// Triangular solves recurse down to blocks of at most this many rows
+#define LU_SUBSTITUTE_ROWS 16
+
+// Columns of B per strip of a substitution, so the strip stays in the L1 cache
+#define LU_SUBSTITUTE_COLUMNS 64
+
+static void lu_swap_rows(float* a, float* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float t = a[i];
+        a[i]    = b[i];
+        b[i]    = t;
+    }
+}
+
+// Triangular solves
+
+// Solve T X = B in place for an order x columns B by substitution, one row of B at a time, in
+// strips of columns whose rows stay in the L1 cache
+static void lu_substitute(
+    lu_triangle_t kind,
+    size_t        order,
+    size_t        columns,
+    const float*  t,
+    size_t        ldt,
+    float*        b,
+    size_t        ldb
+) {
+    const bool lower = LU_LOWER == kind || LU_UNIT_LOWER == kind;
+    const bool unit  = LU_UNIT_LOWER == kind || LU_UNIT_UPPER == kind;
+
+    for (size_t first = 0; first < columns; first += LU_SUBSTITUTE_COLUMNS) {
+        const size_t last = first + LU_SUBSTITUTE_COLUMNS < columns ? first + LU_SUBSTITUTE_COLUMNS
+                                                                    : columns;
+
+        for (size_t step = 0; step < order; step++) {
+            const size_t i   = lower ? step : order - 1 - step;
+            const size_t lo  = lower ? 0 : i + 1;
+            const size_t hi  = lower ? i : order;
+            float*       x_i = b + i * ldb;
+
+            for (size_t p = lo; p < hi; p++) {
+                const float  t_ip = t[i * ldt + p];
+                const float* x_p  = b + p * ldb;
+                for (size_t c = first; c < last; c++) {
+                    x_i[c] -= t_ip * x_p[c];
+                }
+            }
+
+            if (!unit) {
+                const float diagonal = t[i * ldt + i];
+                for (size_t c = first; c < last; c++) {
+                    x_i[c] /= diagonal;
+                }
+            }
+        }
+    }
+}
+
+// Solve T X = B in place by halving T: solve with one diagonal half, subtract its contribution
+// from the other rows of B with gemm(), then solve with the other half. Only blocks of at most
+// LU_SUBSTITUTE_ROWS rows are left to substitution, so nearly all flops run in gemm().
+static bool lu_trsm(
+    lu_triangle_t kind,
+    size_t        order,
+    size_t        columns,
+    const float*  t,
+    size_t        ldt,
+    float*        b,
+    size_t        ldb
+) {
+    if (order <= LU_SUBSTITUTE_ROWS) {
+        lu_substitute(kind, order, columns, t, ldt, b, ldb);
+        return true;
+    }
+
+    const size_t top    = order / 2;
+    const size_t bottom = order - top;
+    const float* t11    = t;
+    const float* t22    = t + top * ldt + top;
+    float*       b1     = b;
+    float*       b2     = b + top * ldb;
+
+    if (LU_LOWER == kind || LU_UNIT_LOWER == kind) {
+        return lu_trsm(kind, top, columns, t11, ldt, b1, ldb)
+               && gemm(bottom, columns, top, -1.0f, t + top * ldt, ldt, b1, ldb, 1.0f, b2, ldb)
+               && lu_trsm(kind, bottom, columns, t22, ldt, b2, ldb);
+    }
+
+    return lu_trsm(kind, bottom, columns, t22, ldt, b2, ldb)
+           && gemm(top, columns, bottom, -1.0f, t + top, ldt, b2, ldb, 1.0f, b1, ldb)
+           && lu_trsm(kind, top, columns, t11, ldt, b1, ldb);
+}
+
+bool lu_solve_triangular(const matrix_t* triangle, matrix_t* b, lu_triangle_t kind) {
+    if (NULL == triangle || NULL == b) {
+        fprintf(stderr, "Cannot solve with a NULL matrix.\n");
+        return false;
+    }
+
+    if (triangle->rows != triangle->columns || b->rows != triangle->rows) {
+        fprintf(
+            stderr,
+            "Cannot solve a %zux%zu triangular system for a %zux%zu right-hand side.\n",
+            triangle->rows,
+            triangle->columns,
+            b->rows,
+            b->columns
+        );
+        return false;
+    }
+
+    if (matrix_overlaps(triangle, b)) {
+        fprintf(stderr, "The solution of a triangular system cannot overwrite the triangle.\n");
+        return false;
+    }
+
+    return lu_trsm(
+        kind,
+        triangle->rows,
+        b->columns,
+        triangle->data,
+        triangle->stride,
+        b->data,
+        b->stride
+    );
+}
+
+// Factorization
+
+// Factor the rows below start of a narrow panel one column at a time, pivoting on whole rows
+static void lu_factor_columns(lu_t* lu, size_t start, size_t columns) {
+    const size_t n   = lu->order;
+    const size_t lda = lu->factors->stride;
+    float*       a   = lu->factors->data;
+
+    for (size_t j = start; j < start + columns; j++) {
+        // The largest magnitude in the column on or below the diagonal
+        size_t pivot = j;
+        float  best  = fabsf(a[j * lda + j]);
+        for (size_t i = j + 1; i < n; i++) {
+            const float magnitude = fabsf(a[i * lda + j]);
+            if (magnitude > best) {
+                best  = magnitude;
+                pivot = i;
+            }
+        }
+
+        // Swapping whole rows keeps L on the left consistent with P A = L U
+        lu->pivots[j] = pivot;
+        if (pivot != j) {
+            lu_swap_rows(a + j * lda, a + pivot * lda, n);
+            lu->sign = -lu->sign;
+        }
+
+        if (0.0f == a[j * lda + j]) {
+            lu->singular = true;
+            continue;
+        }
+
+        // Multipliers, then a rank-one update of the rest of the panel
+        const float  inverse = 1.0f / a[j * lda + j];
+        const float* u_j     = a + j * lda;
+        for (size_t i = j + 1; i < n; i++) {
+            float*      a_i  = a + i * lda;
+            const float l_ij = a_i[j] *= inverse;
+            for (size_t c = j + 1; c < start + columns; c++) {
+                a_i[c] -= l_ij * u_j[c];
+            }
+        }
+    }
+}
+
+// Factor the rows below start of a panel by halving its columns, as LAPACK's sgetrf2 does, so
+// that most of the panel's flops also run in gemm()
+static bool lu_factor_panel(lu_t* lu, size_t start, size_t columns) {
+    if (columns <= LU_PANEL_LEAF) {
+        lu_factor_columns(lu, start, columns);
+        return true;
+    }
+
+    const size_t n     = lu->order;
+    const size_t lda   = lu->factors->stride;
+    const size_t left  = columns / 2;
+    const size_t right = columns - left;
+    float*       a11   = lu->factors->data + start * lda + start;
+
+    if (!lu_factor_panel(lu, start, left)) {
+        return false;
+    }
+
+    // U12 = L11⁻¹ A12, then A22 -= L21 U12 within the panel
+    return lu_trsm(LU_UNIT_LOWER, left, right, a11, lda, a11 + left, lda)
+           && gemm(
+               n - start - left,
+               right,
+               left,
+               -1.0f,
+               a11 + left * lda,
+               lda,
+               a11 + left,
+               lda,
+               1.0f,
+               a11 + left * lda + left,
+               lda
+           )
+           && lu_factor_panel(lu, start + left, right);
+}
+
+lu_t* lu_factor(const matrix_t* matrix) {
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    if (matrix->rows != matrix->columns) {
+        fprintf(stderr, "Cannot factor a %zux%zu matrix.\n", matrix->rows, matrix->columns);
+        return NULL;
+    }
+
+    const size_t n = matrix->rows;
+
+    // The structure and the pivots share one allocation
+    const size_t size = sizeof(lu_t) + n * sizeof(size_t);
+    lu_t*        lu   = (lu_t*) malloc(size);
+    if (NULL == lu) {
+        fprintf(stderr, "Failed to allocate %zu bytes to lu_t.\n", size);
+        return NULL;
+    }
+
+    lu->factors  = matrix_deep_copy(matrix);
+    lu->pivots   = (size_t*) (lu + 1);
+    lu->order    = n;
+    lu->sign     = 1;
+    lu->singular = false;
+    if (NULL == lu->factors) {
+        free(lu);
+        return NULL;
+    }
+
+    const size_t lda = lu->factors->stride;
+    float*       a   = lu->factors->data;
+
+    for (size_t start = 0; start < n; start += LU_BLOCK) {
+        const size_t columns = n - start < LU_BLOCK ? n - start : LU_BLOCK;
+        const size_t rest    = start + columns;
+
+        if (!lu_factor_panel(lu, start, columns)) {
+            lu_free(lu);
+            return NULL;
+        }
+        if (rest == n) {
+            break;
+        }
+
+        // U12 = L11⁻¹ A12, then the trailing update A22 -= L21 U12
+        float* a11 = a + start * lda + start;
+        if (!lu_trsm(LU_UNIT_LOWER, columns, n - rest, a11, lda, a11 + columns, lda)
+            || !gemm(
+                n - rest,
+                n - rest,
+                columns,
+                -1.0f,
+                a + rest * lda + start,
+                lda,
+                a11 + columns,
+                lda,
+                1.0f,
+                a + rest * lda + rest,
+                lda
+            )) {
+            lu_free(lu);
+            return NULL;
+        }
+    }
+
+    return lu;
+}
+
+void lu_free(lu_t* lu) {
+    if (NULL == lu) {
+        return;
+    }
+
+    matrix_free(lu->factors);
+    free(lu); // the pivots live in the same allocation
+}
+
+// Solving
+
+static bool lu_check(const lu_t* lu, size_t rows) {
+    if (NULL == lu) {
+        return false;
+    }
+
+    if (lu->singular) {
+        fprintf(stderr, "Cannot solve with a singular %zux%zu matrix.\n", lu->order, lu->order);
+        return false;
+    }
+
+    if (rows != lu->order) {
+        fprintf(
+            stderr,
+            "Cannot solve a %zux%zu system for a right-hand side of %zu rows.\n",
+            lu->order,
+            lu->order,
+            rows
+        );
+        return false;
+    }
+
+    return true;
+}
+
+bool lu_solve_in_place(const lu_t* lu, matrix_t* b) {
+    if (NULL == b || !lu_check(lu, b->rows)) {
+        return false;
+    }
+
+    if (matrix_overlaps(lu->factors, b)) {
+        fprintf(stderr, "The solution of a system cannot overwrite its factorization.\n");
+        return false;
+    }
+
+    for (size_t i = 0; i < lu->order; i++) {
+        if (lu->pivots[i] != i) {
+            lu_swap_rows(matrix_row(b, i), matrix_row(b, lu->pivots[i]), b->columns);
+        }
+    }
+
+    const matrix_t* f = lu->factors;
+    return lu_trsm(LU_UNIT_LOWER, lu->order, b->columns, f->data, f->stride, b->data, b->stride)
+           && lu_trsm(LU_UPPER, lu->order, b->columns, f->data, f->stride, b->data, b->stride);
+}
+
+matrix_t* lu_solve(const lu_t* lu, const matrix_t* b) {
+    if (NULL == b || !lu_check(lu, b->rows)) {
+        return NULL;
+    }
+
+    matrix_t* x = matrix_deep_copy(b);
+    if (NULL == x) {
+        return NULL;
+    }
+
+    if (!lu_solve_in_place(lu, x)) {
+        matrix_free(x);
+        return NULL;
+    }
+
+    return x;
+}
+
+vector_t* lu_solve_vector_into(vector_t* dst, const lu_t* lu, const vector_t* b) {
+    if (NULL == dst || NULL == b || !lu_check(lu, b->dimensions)) {
+        return NULL;
+    }
+
+    if (dst->dimensions != lu->order) {
+        fprintf(
+            stderr,
+            "Cannot store the solution of a %zux%zu system in a vector of dimension %zu.\n",
+            lu->order,
+            lu->order,
+            dst->dimensions
+        );
+        return NULL;
+    }
+
+    const size_t n = lu->order;
+    float*       x = dst->elements;
+
+    if (x != b->elements) {
+        memmove(x, b->elements, n * sizeof(float));
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const size_t p = lu->pivots[i];
+        float        t = x[i];
+        x[i]           = x[p];
+        x[p]           = t;
+    }
+
+    // L y = P b, then U x = y, each step a dot product with a contiguous row
+    for (size_t i = 1; i < n; i++) {
+        x[i] -= simd_dot(matrix_row(lu->factors, i), x, i);
+    }
+    for (size_t i = n; i-- > 0;) {
+        const float* u_i = matrix_row(lu->factors, i);
+        x[i]             = (x[i] - simd_dot(u_i + i + 1, x + i + 1, n - i - 1)) / u_i[i];
+    }
+
+    return dst;
+}
+
+vector_t* lu_solve_vector(const lu_t* lu, const vector_t* b) {
+    if (NULL == b || !lu_check(lu, b->dimensions)) {
+        return NULL;
+    }
+
+    vector_t* x = vector_create(lu->order);
+    if (NULL == x) {
+        return NULL;
+    }
+
+    if (NULL == lu_solve_vector_into(x, lu, b)) {
+        vector_free(x);
+        return NULL;
+    }
+
+    return x;
+}
+
+// Determinant and inverse
+
+float lu_determinant(const lu_t* lu) {
+    if (NULL == lu) {
+        return NAN;
+    }
+
+    double determinant = lu->sign;
+    for (size_t i = 0; i < lu->order; i++) {
+        determinant *= *matrix_at(lu->factors, i, i);
+    }
+
+    return (float) determinant;
+}
+
+float lu_log_determinant(const lu_t* lu, int* sign) {
+    if (NULL == lu) {
+        return NAN;
+    }
+
+    int    s   = lu->singular ? 0 : lu->sign;
+    double sum = 0.0;
+    for (size_t i = 0; i < lu->order && 0 != s; i++) {
+        const float u_ii = *matrix_at(lu->factors, i, i);
+        if (u_ii < 0.0f) {
+            s = -s;
+        }
+        sum += log(fabs((double) u_ii));
+    }
+
+    if (NULL != sign) {
+        *sign = s;
+    }
+
+    return 0 == s ? -INFINITY : (float) sum;
+}
+
+matrix_t* lu_inverse(const lu_t* lu) {
+    if (!lu_check(lu, NULL == lu ? 0 : lu->order)) {
+        return NULL;
+    }
+
+    matrix_t* inverse = matrix_create(lu->order, lu->order);
+    if (NULL == inverse) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < lu->order; i++) {
+        *matrix_at(inverse, i, i) = 1.0f;
+    }
+
+    if (!lu_solve_in_place(lu, inverse)) {
+        matrix_free(inverse);
+        return NULL;
+    }
+
+    return inverse;
+}
@@ -0,0 +1,172 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file lu.h
+ *
+ * @brief LU factorization with partial pivoting, with solves, determinants and inverses on top
+ *
+ * lu_factor() writes a square matrix A as P A = L U, with P a row permutation, L unit lower
+ * triangular and U upper triangular. The factorization is right-looking and blocked: each panel of
+ * LU_BLOCK columns is factored on its own, recursively, then the whole trailing submatrix is
+ * updated at once by gemm(), so nearly all of the 2n³/3 flops run in the cache-blocked, vectorized
+ * and, with a pool set by gemm_set_pool(), multithreaded product.
+ *
+ * An lu_t is immutable once computed and can be used for any number of solves. Solving for several
+ * right-hand sides at once, as the columns of one matrix, also runs through gemm().
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef LU_H
+#define LU_H
+
+#include "gemm.h"
+#include "matrix.h"
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @brief Columns per panel of the factorization.
+ *
+ * It is the depth k of every trailing gemm() update, and equal to GEMM_KC, so each update packs
+ * exactly one depth block. Smaller panels make the updates less efficient; larger ones leave more
+ * of the work to the panel factorization.
+ */
+#define LU_BLOCK GEMM_KC
+
+// Structures
+
+/**
+ * @brief The shape of a triangular matrix given to lu_solve_triangular().
+ */
+typedef enum {
+    LU_LOWER,      /**< Lower triangular; the elements above the diagonal are ignored */
+    LU_UNIT_LOWER, /**< Lower triangular with ones on the diagonal, which is not read */
+    LU_UPPER,      /**< Upper triangular; the elements below the diagonal are ignored */
+    LU_UNIT_UPPER, /**< Upper triangular with ones on the diagonal, which is not read */
+} lu_triangle_t;
+
+/**
+ * @brief The factorization P A = L U of a square matrix A.
+ *
+ * @param factors  L strictly below the diagonal, its unit diagonal implied, and U on and above it.
+ * @param pivots   Row i was swapped with row pivots[i] >= i at step i; in order, they make up P.
+ * @param order    The number of rows and columns of A.
+ * @param sign     The determinant of P, +1 or -1.
+ * @param singular Whether some pivot was exactly zero, so A and U are singular.
+ */
+typedef struct {
+    matrix_t* factors;  ///< L strictly below the diagonal and U on and above it.
+    size_t*   pivots;   ///< Row i was swapped with row pivots[i] >= i at step i.
+    size_t    order;    ///< The number of rows and columns of A.
+    int       sign;     ///< The determinant of P, +1 or -1.
+    bool      singular; ///< Whether some pivot was exactly zero.
+} lu_t;
+
+// Factorization
+
+/**
+ * @brief Factor a square matrix as P A = L U with partial pivoting.
+ *
+ * A singular matrix is still factored, like LAPACK's sgetrf: the zero pivot is skipped and
+ * lu->singular is set. The determinant of such a factorization is 0, and solves and inverses fail.
+ *
+ * @param matrix Square matrix or view A; it is copied, not modified.
+ * @return Pointer to the factorization, or NULL if A is not square or allocation fails.
+ */
+lu_t* lu_factor(const matrix_t* matrix);
+
+/**
+ * @brief Free a factorization. Safely handles NULL pointers.
+ */
+void lu_free(lu_t* lu);
+
+// Solving
+
+/**
+ * @brief Solve T X = B in place for a triangular T, overwriting B with X.
+ *
+ * Each column of B is one right-hand side. T is halved recursively: the rows of one half are
+ * solved first, and their contribution to the rows of the other half is subtracted by gemm(), so
+ * only small diagonal blocks are left to substitution.
+ *
+ * @param triangle Square triangular matrix T; only the triangle named by kind is read.
+ * @param b Matrix B with as many rows as T; must not overlap T.
+ * @param kind Which triangle of T to use, and whether its diagonal is implicitly one.
+ * @return true on success, false if the shapes do not match, B overlaps T, or gemm() fails. A zero
+ *         on a diagonal that is read yields infinities or NaNs in X, as in IEEE arithmetic.
+ */
+bool lu_solve_triangular(const matrix_t* triangle, matrix_t* b, lu_triangle_t kind);
+
+/**
+ * @brief Solve A X = B in place, overwriting B with X.
+ *
+ * Applies P, then solves with L and with U. The factorization is only read, so it can be shared.
+ *
+ * @param lu Factorization of A.
+ * @param b Matrix B with lu->order rows, one right-hand side per column.
+ * @return true on success, false if A is singular, the shapes do not match, or a solve fails.
+ */
+bool lu_solve_in_place(const lu_t* lu, matrix_t* b);
+
+/**
+ * @brief Solve A X = B and return X as a new matrix.
+ *
+ * @return Pointer to X or NULL on failure.
+ */
+matrix_t* lu_solve(const lu_t* lu, const matrix_t* b);
+
+/**
+ * @brief Solve A x = b for a single right-hand side into an existing vector.
+ *
+ * One right-hand side does not benefit from gemm(), so each substitution step is a simd_dot() with
+ * a contiguous row of L or U.
+ *
+ * @param dst Solution x with lu->order dimensions; may be b itself.
+ * @param lu Factorization of A.
+ * @param b Right-hand side with lu->order dimensions.
+ * @return dst on success, NULL if A is singular or the dimensions do not match.
+ */
+vector_t* lu_solve_vector_into(vector_t* dst, const lu_t* lu, const vector_t* b);
+
+/**
+ * @brief Solve A x = b for a single right-hand side and return x as a new vector.
+ *
+ * @return Pointer to x or NULL on failure.
+ */
+vector_t* lu_solve_vector(const lu_t* lu, const vector_t* b);
+
+// Determinant and inverse
+
+/**
+ * @brief The determinant of A, sign times the product of the diagonal of U.
+ *
+ * The product is accumulated in double but can still overflow or underflow a float for large
+ * matrices; lu_log_determinant() cannot.
+ */
+float lu_determinant(const lu_t* lu);
+
+/**
+ * @brief The natural logarithm of |det A|, with the sign of det A stored in *sign.
+ *
+ * @param lu Factorization of A.
+ * @param sign Receives +1, -1, or 0 if A is singular; may be NULL.
+ * @return log |det A|, or -INFINITY if A is singular.
+ */
+float lu_log_determinant(const lu_t* lu, int* sign);
+
+/**
+ * @brief The inverse of A, computed by solving A X = I.
+ *
+ * Prefer lu_solve() to multiplying by the inverse: it is faster and more accurate.
+ *
+ * @return Pointer to the new inverse or NULL if A is singular or allocation fails.
+ */
+matrix_t* lu_inverse(const lu_t* lu);
+
+#endif // LU_H
@@ -0,0 +1,349 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file mat4.c
+ *
+ * @brief A 4x4 matrix value type for affine and projective transforms of vertex arrays
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "mat4.h"
+#include "simd.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define MAT4_X86 1
+    #include <immintrin.h>
+#else
+    #define MAT4_X86 0
+#endif
+
+// Viewport mapping from normalized device coordinates to pixels, y pointing down
+typedef struct {
+    float half_width;
+    float half_height;
+} mat4_viewport_t;
+
+// Portable kernels
+
+static void scalar_transform_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    float*        out_x,
+    float*        out_y,
+    float*        out_z,
+    float*        out_w,
+    size_t        n
+) {
+    const float(*m)[4] = matrix->m;
+
+    for (size_t i = 0; i < n; i++) {
+        const float px = x[i], py = y[i], pz = z[i];
+
+        out_x[i] = m[0][0] * px + m[0][1] * py + m[0][2] * pz + m[0][3];
+        out_y[i] = m[1][0] * px + m[1][1] * py + m[1][2] * pz + m[1][3];
+        out_z[i] = m[2][0] * px + m[2][1] * py + m[2][2] * pz + m[2][3];
+        if (NULL != out_w) {
+            out_w[i] = m[3][0] * px + m[3][1] * py + m[3][2] * pz + m[3][3];
+        }
+    }
+}
+
+static void
+scalar_transform_aos(const mat4_t* matrix, const vec3_t* points, vec4_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = mat4_transform(matrix, (vec4_t) {points[i].x, points[i].y, points[i].z, 1.0f});
+    }
+}
+
+static inline size_t scalar_project_point(
+    const mat4_t* matrix, float x, float y, float z, mat4_viewport_t viewport, vec2_t* screen
+) {
+    const float(*m)[4] = matrix->m;
+
+    const float w = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+    if (!(w > 0.0f)) {
+        *screen = (vec2_t) {NAN, NAN};
+        return 1;
+    }
+
+    const float cx = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+    const float cy = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+    const float r  = 1.0f / w;
+
+    *screen = (vec2_t) {
+        viewport.half_width + cx * r * viewport.half_width,
+        viewport.half_height - cy * r * viewport.half_height,
+    };
+    return 0;
+}
+
+static size_t scalar_project_soa(
+    const mat4_t*   matrix,
+    const float*    x,
+    const float*    y,
+    const float*    z,
+    vec2_t*         screen,
+    mat4_viewport_t viewport,
+    size_t          n
+) {
+    size_t behind = 0;
+    for (size_t i = 0; i < n; i++) {
+        behind += scalar_project_point(matrix, x[i], y[i], z[i], viewport, &screen[i]);
+    }
+    return behind;
+}
+
+static size_t scalar_project_aos(
+    const mat4_t* matrix, const vec3_t* points, vec2_t* screen, mat4_viewport_t viewport, size_t n
+) {
+    size_t behind = 0;
+    for (size_t i = 0; i < n; i++) {
+        const vec3_t p  = points[i];
+        behind         += scalar_project_point(matrix, p.x, p.y, p.z, viewport, &screen[i]);
+    }
+    return behind;
+}
+
+#if MAT4_X86
+
+// SSE2 kernels: one packed point per iteration, as a sum of the matrix columns scaled by x, y, z
+
+typedef struct {
+    __m128 c0, c1, c2, c3;
+} mat4_columns_t;
+
+__attribute__((target("sse2"))) static inline mat4_columns_t sse2_columns(const mat4_t* matrix) {
+    const float(*m)[4] = matrix->m;
+    return (mat4_columns_t) {
+        _mm_setr_ps(m[0][0], m[1][0], m[2][0], m[3][0]),
+        _mm_setr_ps(m[0][1], m[1][1], m[2][1], m[3][1]),
+        _mm_setr_ps(m[0][2], m[1][2], m[2][2], m[3][2]),
+        _mm_setr_ps(m[0][3], m[1][3], m[2][3], m[3][3]),
+    };
+}
+
+__attribute__((target("sse2"))) static inline __m128
+sse2_transform_point(mat4_columns_t c, const vec3_t* p) {
+    __m128 v = _mm_add_ps(c.c3, _mm_mul_ps(c.c0, _mm_set1_ps(p->x)));
+    v        = _mm_add_ps(v, _mm_mul_ps(c.c1, _mm_set1_ps(p->y)));
+    return _mm_add_ps(v, _mm_mul_ps(c.c2, _mm_set1_ps(p->z)));
+}
+
+__attribute__((target("sse2"))) static void
+sse2_transform_aos(const mat4_t* matrix, const vec3_t* points, vec4_t* out, size_t n) {
+    const mat4_columns_t c = sse2_columns(matrix);
+    for (size_t i = 0; i < n; i++) {
+        _mm_storeu_ps(&out[i].x, sse2_transform_point(c, &points[i]));
+    }
+}
+
+__attribute__((target("sse2"))) static size_t sse2_project_aos(
+    const mat4_t* matrix, const vec3_t* points, vec2_t* screen, mat4_viewport_t viewport, size_t n
+) {
+    const mat4_columns_t c      = sse2_columns(matrix);
+    const __m128         scale  = _mm_setr_ps(viewport.half_width, -viewport.half_height, 0, 0);
+    const __m128         offset = _mm_setr_ps(viewport.half_width, viewport.half_height, 0, 0);
+    const __m128         nan    = _mm_set1_ps(NAN);
+    size_t               behind = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        __m128 clip = sse2_transform_point(c, &points[i]);
+        __m128 w    = _mm_shuffle_ps(clip, clip, _MM_SHUFFLE(3, 3, 3, 3));
+
+        // w > 0 selects the projected point; anything else, NaN included, selects NaN
+        __m128 front = _mm_cmpgt_ps(w, _mm_setzero_ps());
+        __m128 pixel = _mm_add_ps(offset, _mm_mul_ps(_mm_div_ps(clip, w), scale));
+        pixel        = _mm_or_ps(_mm_and_ps(front, pixel), _mm_andnot_ps(front, nan));
+
+        behind += 1 - (_mm_movemask_ps(front) & 1);
+        _mm_storel_pi((__m64*) &screen[i], pixel);
+    }
+
+    return behind;
+}
+
+// AVX2 kernels: eight points of an SoA batch per iteration, one FMA chain per output axis
+
+    #define MAT4_AVX2_ROW(row)                                                        \
+        _mm256_fmadd_ps(                                                              \
+            m##row##0,                                                                \
+            px,                                                                       \
+            _mm256_fmadd_ps(m##row##1, py, _mm256_fmadd_ps(m##row##2, pz, m##row##3)) \
+        )
+
+    #define MAT4_AVX2_LOAD(row)                                     \
+        const __m256 m##row##0 = _mm256_set1_ps(matrix->m[row][0]); \
+        const __m256 m##row##1 = _mm256_set1_ps(matrix->m[row][1]); \
+        const __m256 m##row##2 = _mm256_set1_ps(matrix->m[row][2]); \
+        const __m256 m##row##3 = _mm256_set1_ps(matrix->m[row][3]);
+
+__attribute__((target("avx2,fma"))) static void avx2_transform_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    float*        out_x,
+    float*        out_y,
+    float*        out_z,
+    float*        out_w,
+    size_t        n
+) {
+    MAT4_AVX2_LOAD(0)
+    MAT4_AVX2_LOAD(1)
+    MAT4_AVX2_LOAD(2)
+    MAT4_AVX2_LOAD(3)
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+
+        _mm256_storeu_ps(out_x + i, MAT4_AVX2_ROW(0));
+        _mm256_storeu_ps(out_y + i, MAT4_AVX2_ROW(1));
+        _mm256_storeu_ps(out_z + i, MAT4_AVX2_ROW(2));
+        if (NULL != out_w) {
+            _mm256_storeu_ps(out_w + i, MAT4_AVX2_ROW(3));
+        }
+    }
+
+    scalar_transform_soa(
+        matrix,
+        x + i,
+        y + i,
+        z + i,
+        out_x + i,
+        out_y + i,
+        out_z + i,
+        NULL == out_w ? NULL : out_w + i,
+        n - i
+    );
+}
+
+__attribute__((target("avx2,fma"))) static size_t avx2_project_soa(
+    const mat4_t*   matrix,
+    const float*    x,
+    const float*    y,
+    const float*    z,
+    vec2_t*         screen,
+    mat4_viewport_t viewport,
+    size_t          n
+) {
+    MAT4_AVX2_LOAD(0)
+    MAT4_AVX2_LOAD(1)
+    MAT4_AVX2_LOAD(3)
+
+    const __m256 half_width  = _mm256_set1_ps(viewport.half_width);
+    const __m256 half_height = _mm256_set1_ps(viewport.half_height);
+    const __m256 nan         = _mm256_set1_ps(NAN);
+    size_t       behind      = 0;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+
+        const __m256 w     = MAT4_AVX2_ROW(3);
+        const __m256 front = _mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ);
+        const __m256 r     = _mm256_div_ps(_mm256_set1_ps(1.0f), w);
+
+        __m256 sx = _mm256_fmadd_ps(_mm256_mul_ps(MAT4_AVX2_ROW(0), r), half_width, half_width);
+        __m256 sy = _mm256_fnmadd_ps(_mm256_mul_ps(MAT4_AVX2_ROW(1), r), half_height, half_height);
+        sx        = _mm256_blendv_ps(nan, sx, front);
+        sy        = _mm256_blendv_ps(nan, sy, front);
+
+        behind += 8 - (size_t) __builtin_popcount(_mm256_movemask_ps(front));
+
+        // Interleave into (x, y) pairs: points 0-1 and 4-5, then 2-3 and 6-7, then reorder lanes
+        const __m256 low  = _mm256_unpacklo_ps(sx, sy);
+        const __m256 high = _mm256_unpackhi_ps(sx, sy);
+        _mm256_storeu_ps(&screen[i].x, _mm256_permute2f128_ps(low, high, 0x20));
+        _mm256_storeu_ps(&screen[i + 4].x, _mm256_permute2f128_ps(low, high, 0x31));
+    }
+
+    return behind + scalar_project_soa(matrix, x + i, y + i, z + i, screen + i, viewport, n - i);
+}
+
+#endif // MAT4_X86
+
+// Batch transforms
+
+static mat4_viewport_t mat4_viewport(float width, float height) {
+    return (mat4_viewport_t) {0.5f * width, 0.5f * height};
+}
+
+void mat4_transform_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    float*        out_x,
+    float*        out_y,
+    float*        out_z,
+    float*        out_w,
+    size_t        n
+) {
+#if MAT4_X86
+    if (simd_get_level() >= SIMD_AVX2) {
+        avx2_transform_soa(matrix, x, y, z, out_x, out_y, out_z, out_w, n);
+        return;
+    }
+#endif
+    scalar_transform_soa(matrix, x, y, z, out_x, out_y, out_z, out_w, n);
+}
+
+void mat4_transform_aos(const mat4_t* matrix, const vec3_t* points, vec4_t* out, size_t n) {
+#if MAT4_X86
+    if (simd_get_level() >= SIMD_SSE2) {
+        sse2_transform_aos(matrix, points, out, n);
+        return;
+    }
+#endif
+    scalar_transform_aos(matrix, points, out, n);
+}
+
+size_t mat4_project_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    vec2_t*       screen,
+    float         width,
+    float         height,
+    size_t        n
+) {
+    const mat4_viewport_t viewport = mat4_viewport(width, height);
+#if MAT4_X86
+    if (simd_get_level() >= SIMD_AVX2) {
+        return avx2_project_soa(matrix, x, y, z, screen, viewport, n);
+    }
+#endif
+    return scalar_project_soa(matrix, x, y, z, screen, viewport, n);
+}
+
+size_t mat4_project_aos(
+    const mat4_t* matrix,
+    const vec3_t* points,
+    vec2_t*       screen,
+    float         width,
+    float         height,
+    size_t        n
+) {
+    const mat4_viewport_t viewport = mat4_viewport(width, height);
+#if MAT4_X86
+    if (simd_get_level() >= SIMD_SSE2) {
+        return sse2_project_aos(matrix, points, screen, viewport, n);
+    }
+#endif
+    return scalar_project_aos(matrix, points, screen, viewport, n);
+}
@@ -0,0 +1,246 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file mat4.h
+ *
+ * @brief A 4x4 matrix value type for affine and projective transforms of vertex arrays
+ *
+ * mat4_t is a plain struct passed by value or pointer that never touches the heap. The builders and
+ * the single-point transform are static inline; the batch transforms in mat4.c push whole vertex
+ * arrays through one matrix with SIMD and write into caller-owned buffers, so moving every vertex
+ * of a frame from world to camera to clip to screen space costs no allocation at all.
+ *
+ * Matrices are row-major and act on column vectors: p' = M p, so m[row][3] holds the translation
+ * and mat4_multiply(a, b) applies b first. Clip space follows the OpenGL convention: the camera
+ * looks down -z, w = -z after projection, and the visible volume maps to [-1, 1] on every axis.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef MAT4_H
+#define MAT4_H
+
+#include "vec.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// Structures
+
+/**
+ * @brief A 4x4 single-precision matrix, row-major, aligned for 128-bit loads.
+ */
+typedef struct {
+    _Alignas(16) float m[4][4]; ///< The elements, m[row][column].
+} mat4_t;
+
+// Builders
+
+static inline mat4_t mat4_identity(void) {
+    return (mat4_t) {{
+        {1.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    }};
+}
+
+static inline mat4_t mat4_translation(vec3_t offset) {
+    mat4_t t  = mat4_identity();
+    t.m[0][3] = offset.x;
+    t.m[1][3] = offset.y;
+    t.m[2][3] = offset.z;
+    return t;
+}
+
+static inline mat4_t mat4_scaling(vec3_t factors) {
+    mat4_t s  = mat4_identity();
+    s.m[0][0] = factors.x;
+    s.m[1][1] = factors.y;
+    s.m[2][2] = factors.z;
+    return s;
+}
+
+/**
+ * @brief Rotation by angle radians about the x axis, counter-clockwise looking down the axis.
+ */
+static inline mat4_t mat4_rotation_x(float angle) {
+    float  c = cosf(angle), s = sinf(angle);
+    mat4_t r = mat4_identity();
+    r.m[1][1] = c;
+    r.m[1][2] = -s;
+    r.m[2][1] = s;
+    r.m[2][2] = c;
+    return r;
+}
+
+static inline mat4_t mat4_rotation_y(float angle) {
+    float  c = cosf(angle), s = sinf(angle);
+    mat4_t r = mat4_identity();
+    r.m[0][0] = c;
+    r.m[0][2] = s;
+    r.m[2][0] = -s;
+    r.m[2][2] = c;
+    return r;
+}
+
+static inline mat4_t mat4_rotation_z(float angle) {
+    float  c = cosf(angle), s = sinf(angle);
+    mat4_t r = mat4_identity();
+    r.m[0][0] = c;
+    r.m[0][1] = -s;
+    r.m[1][0] = s;
+    r.m[1][1] = c;
+    return r;
+}
+
+/**
+ * @brief Perspective projection from camera space to clip space.
+ *
+ * @param fov_y Vertical field of view in radians
+ * @param aspect Width divided by height of the viewport
+ * @param near Distance to the near clipping plane, greater than 0
+ * @param far Distance to the far clipping plane, greater than near
+ */
+static inline mat4_t mat4_perspective(float fov_y, float aspect, float near, float far) {
+    const float f = 1.0f / tanf(fov_y * 0.5f);
+    return (mat4_t) {{
+        {f / aspect, 0.0f, 0.0f, 0.0f},
+        {0.0f, f, 0.0f, 0.0f},
+        {0.0f, 0.0f, (far + near) / (near - far), 2.0f * far * near / (near - far)},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+    }};
+}
+
+/**
+ * @brief View transform from world space to the space of a camera at eye looking at target.
+ *
+ * @param eye Position of the camera
+ * @param target Point the camera looks at; must differ from eye
+ * @param up Direction that appears upwards; must not be parallel to target - eye
+ */
+static inline mat4_t mat4_look_at(vec3_t eye, vec3_t target, vec3_t up) {
+    const vec3_t f = vec3_normalize(vec3_subtract(target, eye));
+    const vec3_t s = vec3_normalize(vec3_cross(f, up));
+    const vec3_t u = vec3_cross(s, f);
+    return (mat4_t) {{
+        {s.x, s.y, s.z, -vec3_dot(s, eye)},
+        {u.x, u.y, u.z, -vec3_dot(u, eye)},
+        {-f.x, -f.y, -f.z, vec3_dot(f, eye)},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+    }};
+}
+
+// Operations
+
+/**
+ * @brief The product a b, which applies b first and then a.
+ */
+static inline mat4_t mat4_multiply(const mat4_t* a, const mat4_t* b) {
+    mat4_t product;
+    for (size_t i = 0; i < 4; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            product.m[i][j] = a->m[i][0] * b->m[0][j] + a->m[i][1] * b->m[1][j]
+                              + a->m[i][2] * b->m[2][j] + a->m[i][3] * b->m[3][j];
+        }
+    }
+    return product;
+}
+
+/**
+ * @brief Transform one homogeneous point, M p.
+ */
+static inline vec4_t mat4_transform(const mat4_t* matrix, vec4_t p) {
+    const float(*m)[4] = matrix->m;
+    return (vec4_t) {
+        m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3] * p.w,
+        m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3] * p.w,
+        m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3] * p.w,
+        m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3] * p.w,
+    };
+}
+
+// Batch transforms
+//
+// The points are 3D positions with an implicit w of 1. Structure-of-arrays inputs match the axes
+// of a vector_batch_t, so batch->x, batch->y and batch->z can be passed directly. Input and output
+// arrays must not overlap, except that an SoA output axis may be the input axis of the same name.
+
+/**
+ * @brief Transform n points given as separate x, y and z arrays into homogeneous coordinates.
+ *
+ * @param matrix Transform to apply
+ * @param x, y, z Input coordinates, n floats each
+ * @param out_x, out_y, out_z, out_w Output coordinates, n floats each; out_w may be NULL when the
+ *        matrix is affine and w is known to stay 1
+ * @param n Number of points
+ */
+void mat4_transform_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    float*        out_x,
+    float*        out_y,
+    float*        out_z,
+    float*        out_w,
+    size_t        n
+);
+
+/**
+ * @brief Transform n packed 3D points into homogeneous coordinates.
+ *
+ * @param matrix Transform to apply
+ * @param points Input points
+ * @param out Output points, n of them
+ * @param n Number of points
+ */
+void mat4_transform_aos(const mat4_t* matrix, const vec3_t* points, vec4_t* out, size_t n);
+
+/**
+ * @brief Project n points given as separate x, y and z arrays onto the screen.
+ *
+ * Each point is transformed to clip space, divided by w, and mapped from [-1, 1] to pixels with y
+ * pointing down: screen = ((x / w + 1) width / 2, (1 - y / w) height / 2). vec2_t has the layout
+ * of SDL_FPoint, so screen can be an SDL_FPoint array cast to vec2_t* and handed straight to
+ * SDL_RenderDrawPointsF() or SDL_RenderGeometry() vertices.
+ *
+ * Points with w ≤ 0 are at or behind the camera and have no screen position. They are written as
+ * (NAN, NAN) and counted, so a renderer can clip the primitives that use them.
+ *
+ * @param matrix Transform to clip space, typically projection * view * model
+ * @param x, y, z Input coordinates, n floats each
+ * @param screen Output screen coordinates, n of them
+ * @param width, height Viewport size in pixels
+ * @param n Number of points
+ * @return The number of points at or behind the camera
+ */
+size_t mat4_project_soa(
+    const mat4_t* matrix,
+    const float*  x,
+    const float*  y,
+    const float*  z,
+    vec2_t*       screen,
+    float         width,
+    float         height,
+    size_t        n
+);
+
+/**
+ * @brief Project n packed 3D points onto the screen. See mat4_project_soa().
+ *
+ * @return The number of points at or behind the camera
+ */
+size_t mat4_project_aos(
+    const mat4_t* matrix,
+    const vec3_t* points,
+    vec2_t*       screen,
+    float         width,
+    float         height,
+    size_t        n
+);
+
+#endif // MAT4_H
@@ -12,56 +12,431 @@
  */
 
 #include "matrix.h"
+#include "simd.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Floats per row, padded so every row starts on a MATRIX_ALIGNMENT boundary
+static size_t matrix_stride(size_t columns) {
+    const size_t lanes = MATRIX_ALIGNMENT / sizeof(float);
+    return (columns + lanes - 1) / lanes * lanes;
+}
+
 // Matrix operations
 matrix_t* matrix_create(size_t columns, size_t rows) {
-    matrix_t* matrix = (matrix_t*) malloc(sizeof(matrix_t));
-    if (NULL == matrix) {
-        fprintf(stderr, "Failed to allocate memory for matrix_t.\n");
+    // The header occupies the first cache line; the rows start on the next boundary
+    _Static_assert(sizeof(matrix_t) <= MATRIX_ALIGNMENT, "matrix_t must fit in one cache line");
+
+    const size_t stride = matrix_stride(columns);
+    if (0 != rows && stride > (SIZE_MAX - MATRIX_ALIGNMENT) / sizeof(float) / rows) {
+        fprintf(stderr, "Matrix of %zu x %zu elements is too large.\n", rows, columns);
         return NULL;
     }
 
-    matrix->elements = (float**) malloc(rows * sizeof(float*));
-    if (NULL == matrix->elements) {
-        fprintf(stderr, "Failed to allocate memory for matrix rows.\n");
-        free(matrix);
+    // Rows are padded to the alignment, so the size is already a multiple of it
+    const size_t   bytes = rows * stride * sizeof(float);
+    const size_t   size  = MATRIX_ALIGNMENT + bytes;
+    unsigned char* block = (unsigned char*) aligned_alloc(MATRIX_ALIGNMENT, size);
+    if (NULL == block) {
+        fprintf(stderr, "Failed to allocate %zu bytes to matrix_t.\n", size);
         return NULL;
     }
 
-    for (size_t i = 0; i < rows; ++i) {
-        matrix->elements[i] = (float*) malloc(columns * sizeof(float));
-        if (NULL == matrix->elements[i]) {
-            fprintf(stderr, "Failed to allocate memory for matrix columns.\n");
-            // Free previously allocated rows
-            for (size_t j = 0; j < i; ++j) {
-                free(matrix->elements[j]);
-            }
-            free(matrix->elements);
-            free(matrix);
-            return NULL;
-        }
-        memset(matrix->elements[i], 0, columns * sizeof(float));
+    matrix_t* matrix = (matrix_t*) block;
+    matrix->data     = (float*) (block + MATRIX_ALIGNMENT);
+    matrix->elements = NULL;
+    matrix->columns  = columns;
+    matrix->rows     = rows;
+    matrix->stride   = stride;
+    matrix->storage  = MATRIX_STORAGE_ALIGNED;
+
+    memset(matrix->data, 0, bytes);
+
+    return matrix;
+}
+
+matrix_t* matrix_create_in(arena_t* arena, size_t columns, size_t rows) {
+    const size_t stride = matrix_stride(columns);
+    if (0 != rows && stride > (SIZE_MAX - MATRIX_ALIGNMENT) / sizeof(float) / rows) {
+        fprintf(stderr, "Matrix of %zu x %zu elements is too large.\n", rows, columns);
+        return NULL;
+    }
+
+    matrix_t* matrix = (matrix_t*) arena_alloc(arena, sizeof(matrix_t), _Alignof(matrix_t));
+    if (NULL == matrix) {
+        return NULL; // arena_alloc logs the error for us
     }
 
-    matrix->columns = columns;
-    matrix->rows    = rows;
+    const size_t bytes = rows * stride * sizeof(float);
+
+    matrix->data = (float*) arena_alloc(arena, bytes, MATRIX_ALIGNMENT);
+    if (NULL == matrix->data) {
+        return NULL; // the header is reclaimed with the rest of the arena
+    }
+
+    memset(matrix->data, 0, bytes);
+
+    matrix->elements = NULL;
+    matrix->columns  = columns;
+    matrix->rows     = rows;
+    matrix->stride   = stride;
+    matrix->storage  = MATRIX_STORAGE_ARENA;
 
     return matrix;
 }
 
 void matrix_free(matrix_t* matrix) {
     if (NULL == matrix) {
-        fprintf(stderr, "Cannot free a NULL matrix.\n");
         return;
     }
 
-    if (matrix->elements) {
-        free(matrix->elements);
+    // The row view is always a separate heap allocation owned by this header
+    free(matrix->elements);
+    matrix->elements = NULL;
+
+    // Arena matrices are released all at once by arena_reset(), and a view's header is a value
+    // owned by the caller; aligned data lives in the header's block and aliased data belongs to
+    // another matrix
+    if (MATRIX_STORAGE_ARENA != matrix->storage && MATRIX_STORAGE_VIEW != matrix->storage) {
+        free(matrix);
+    }
+}
+
+float** matrix_row_view(matrix_t* matrix) {
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    if (NULL != matrix->elements) {
+        return matrix->elements;
+    }
+
+    float** elements = (float**) malloc((matrix->rows ? matrix->rows : 1) * sizeof(float*));
+    if (NULL == elements) {
+        fprintf(stderr, "Failed to allocate %zu row pointers.\n", matrix->rows);
+        return NULL;
+    }
+
+    for (size_t row = 0; row < matrix->rows; row++) {
+        elements[row] = matrix_row(matrix, row);
+    }
+
+    matrix->elements = elements;
+    return elements;
+}
+
+matrix_t* matrix_deep_copy(const matrix_t* matrix) {
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    matrix_t* deep_copy = matrix_create(matrix->columns, matrix->rows);
+    if (NULL == deep_copy) {
+        return NULL;
+    }
+
+    const size_t bytes = matrix->columns * sizeof(float);
+    for (size_t row = 0; row < matrix->rows; row++) {
+        memcpy(matrix_row(deep_copy, row), matrix_row(matrix, row), bytes);
+    }
+
+    return deep_copy;
+}
+
+matrix_t* matrix_shallow_copy(const matrix_t* matrix) {
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    // Allocate memory for the new matrix structure only, not for its data
+    matrix_t* shallow_copy = (matrix_t*) malloc(sizeof(matrix_t));
+    if (NULL == shallow_copy) {
+        fprintf(stderr, "Failed to allocate %zu bytes to matrix_t.\n", sizeof(matrix_t));
+        return NULL;
+    }
+
+    // Share the data, mark it as borrowed, and leave the row view to be built on demand
+    *shallow_copy          = *matrix;
+    shallow_copy->elements = NULL;
+    shallow_copy->storage  = MATRIX_STORAGE_ALIAS;
+
+    return shallow_copy;
+}
+
+// Views
+
+matrix_t
+matrix_view(const matrix_t* matrix, size_t row, size_t column, size_t rows, size_t columns) {
+    matrix_t view = {NULL, NULL, 0, 0, 0, MATRIX_STORAGE_VIEW};
+
+    if (NULL == matrix || row > matrix->rows || rows > matrix->rows - row
+        || column > matrix->columns || columns > matrix->columns - column) {
+        fprintf(
+            stderr,
+            "A %zux%zu view at (%zu, %zu) does not fit in a %zux%zu matrix.\n",
+            rows,
+            columns,
+            row,
+            column,
+            NULL == matrix ? 0 : matrix->rows,
+            NULL == matrix ? 0 : matrix->columns
+        );
+        return view;
+    }
+
+    view.data    = matrix_at(matrix, row, column);
+    view.columns = columns;
+    view.rows    = rows;
+    view.stride  = matrix->stride;
+
+    return view;
+}
+
+matrix_t matrix_column_slice(const matrix_t* matrix, size_t column) {
+    return matrix_view(matrix, 0, column, NULL == matrix ? 0 : matrix->rows, 1);
+}
+
+vector_t matrix_row_slice(const matrix_t* matrix, size_t row) {
+    if (NULL == matrix || row >= matrix->rows) {
+        fprintf(stderr, "Row %zu is out of range.\n", row);
+        return (vector_t) {NULL, 0, VECTOR_STORAGE_VIEW};
+    }
+
+    return (vector_t) {matrix_row(matrix, row), matrix->columns, VECTOR_STORAGE_VIEW};
+}
+
+bool matrix_overlaps(const matrix_t* a, const matrix_t* b) {
+    if (NULL == a || NULL == b || 0 == a->rows || 0 == a->columns || 0 == b->rows
+        || 0 == b->columns) {
+        return false;
+    }
+
+    // Half-open spans from the first element to one past the last
+    const float* a_end = matrix_at(a, a->rows - 1, a->columns);
+    const float* b_end = matrix_at(b, b->rows - 1, b->columns);
+
+    return a->data < b_end && b->data < a_end;
+}
+
+// Arithmetic operations
+
+bool matrix_multiply_into(matrix_t* dst, const matrix_t* a, const matrix_t* b) {
+    if (NULL == dst || NULL == a || NULL == b) {
+        fprintf(stderr, "Cannot multiply a NULL matrix.\n");
+        return false;
+    }
+
+    if (a->columns != b->rows || dst->rows != a->rows || dst->columns != b->columns) {
+        fprintf(
+            stderr,
+            "Cannot multiply a %zux%zu matrix by a %zux%zu matrix into a %zux%zu matrix.\n",
+            a->rows,
+            a->columns,
+            b->rows,
+            b->columns,
+            dst->rows,
+            dst->columns
+        );
+        return false;
+    }
+
+    if (matrix_overlaps(dst, a) || matrix_overlaps(dst, b)) {
+        fprintf(stderr, "The product of two matrices cannot be written over either of them.\n");
+        return false;
+    }
+
+    return gemm(
+        a->rows,
+        b->columns,
+        a->columns,
+        1.0f,
+        a->data,
+        a->stride,
+        b->data,
+        b->stride,
+        0.0f,
+        dst->data,
+        dst->stride
+    );
+}
+
+matrix_t* matrix_multiply(const matrix_t* a, const matrix_t* b) {
+    if (NULL == a || NULL == b) {
+        fprintf(stderr, "Cannot multiply a NULL matrix.\n");
+        return NULL;
+    }
+
+    matrix_t* product = matrix_create(b->columns, a->rows);
+    if (NULL == product) {
+        return NULL;
+    }
+
+    if (!matrix_multiply_into(product, a, b)) {
+        matrix_free(product);
+        return NULL;
+    }
+
+    return product;
+}
+
+// Transposition
+
+// Split a block size in half, rounded up to a multiple of 16 so the halves keep whole SIMD tiles
+// and every destination row of a block starts on a cache line
+static size_t matrix_transpose_half(size_t size) {
+    return (size / 2 + 15) & ~(size_t) 15;
+}
+
+// dst = srcᵀ for a rows x columns block, halving the longer side until the block is small
+static void matrix_transpose_block(
+    const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns, bool stream
+) {
+    if (rows <= MATRIX_TRANSPOSE_BLOCK && columns <= MATRIX_TRANSPOSE_BLOCK) {
+        if (!stream) {
+            simd_transpose(src, lds, dst, ldd, rows, columns);
+            return;
+        }
+
+        _Alignas(MATRIX_ALIGNMENT) float tile[MATRIX_TRANSPOSE_BLOCK * MATRIX_TRANSPOSE_BLOCK];
+
+        simd_transpose(src, lds, tile, rows, rows, columns);
+        for (size_t i = 0; i < columns; i++) {
+            simd_stream(dst + i * ldd, tile + i * rows, rows);
+        }
+        return;
+    }
+
+    if (rows >= columns) {
+        const size_t half = matrix_transpose_half(rows);
+        matrix_transpose_block(src, lds, dst, ldd, half, columns, stream);
+        matrix_transpose_block(
+            src + half * lds, lds, dst + half, ldd, rows - half, columns, stream
+        );
+    } else {
+        const size_t half = matrix_transpose_half(columns);
+        matrix_transpose_block(src, lds, dst, ldd, rows, half, stream);
+        matrix_transpose_block(
+            src + half, lds, dst + half * ldd, ldd, rows, columns - half, stream
+        );
+    }
+}
+
+// Swap the rows x columns block at (row, column) with the transpose of its mirror at (column, row)
+static void matrix_transpose_swap(
+    float* data, size_t stride, size_t row, size_t column, size_t rows, size_t columns
+) {
+    if (rows <= MATRIX_TRANSPOSE_BLOCK && columns <= MATRIX_TRANSPOSE_BLOCK) {
+        _Alignas(MATRIX_ALIGNMENT) float tile[MATRIX_TRANSPOSE_BLOCK * MATRIX_TRANSPOSE_BLOCK];
+
+        float* upper = data + row * stride + column;
+        float* lower = data + column * stride + row;
+
+        simd_transpose(upper, stride, tile, rows, rows, columns);
+        simd_transpose(lower, stride, upper, stride, columns, rows);
+        for (size_t i = 0; i < columns; i++) {
+            memcpy(lower + i * stride, tile + i * rows, rows * sizeof(float));
+        }
+        return;
+    }
+
+    if (rows >= columns) {
+        const size_t half = matrix_transpose_half(rows);
+        matrix_transpose_swap(data, stride, row, column, half, columns);
+        matrix_transpose_swap(data, stride, row + half, column, rows - half, columns);
+    } else {
+        const size_t half = matrix_transpose_half(columns);
+        matrix_transpose_swap(data, stride, row, column, rows, half);
+        matrix_transpose_swap(data, stride, row, column + half, rows, columns - half);
+    }
+}
+
+// Transpose the size x size block on the diagonal at (start, start) in place
+static void matrix_transpose_diagonal(float* data, size_t stride, size_t start, size_t size) {
+    if (size <= MATRIX_TRANSPOSE_BLOCK) {
+        _Alignas(MATRIX_ALIGNMENT) float tile[MATRIX_TRANSPOSE_BLOCK * MATRIX_TRANSPOSE_BLOCK];
+
+        float* block = data + start * stride + start;
+
+        simd_transpose(block, stride, tile, size, size, size);
+        for (size_t i = 0; i < size; i++) {
+            memcpy(block + i * stride, tile + i * size, size * sizeof(float));
+        }
+        return;
+    }
+
+    const size_t half = matrix_transpose_half(size);
+    matrix_transpose_diagonal(data, stride, start, half);
+    matrix_transpose_diagonal(data, stride, start + half, size - half);
+    matrix_transpose_swap(data, stride, start + half, start, size - half, half);
+}
+
+bool matrix_transpose_into(matrix_t* dst, const matrix_t* src) {
+    if (NULL == dst || NULL == src) {
+        fprintf(stderr, "Cannot transpose a NULL matrix.\n");
+        return false;
+    }
+
+    if (dst->rows != src->columns || dst->columns != src->rows) {
+        fprintf(
+            stderr,
+            "Cannot transpose a %zux%zu matrix into a %zux%zu matrix.\n",
+            src->rows,
+            src->columns,
+            dst->rows,
+            dst->columns
+        );
+        return false;
+    }
+
+    if (matrix_overlaps(dst, src)) {
+        fprintf(stderr, "Use matrix_transpose_in_place() to transpose a matrix onto itself.\n");
+        return false;
+    }
+
+    const bool stream = dst->rows * dst->stride * sizeof(float) > MATRIX_TRANSPOSE_STREAM;
+    matrix_transpose_block(
+        src->data, src->stride, dst->data, dst->stride, src->rows, src->columns, stream
+    );
+    if (stream) {
+        simd_stream_fence();
+    }
+    return true;
+}
+
+matrix_t* matrix_transpose(const matrix_t* matrix) {
+    if (NULL == matrix) {
+        fprintf(stderr, "Cannot transpose a NULL matrix.\n");
+        return NULL;
+    }
+
+    matrix_t* transpose = matrix_create(matrix->rows, matrix->columns);
+    if (NULL == transpose) {
+        return NULL;
+    }
+
+    matrix_transpose_into(transpose, matrix);
+    return transpose;
+}
+
+bool matrix_transpose_in_place(matrix_t* matrix) {
+    if (NULL == matrix) {
+        fprintf(stderr, "Cannot transpose a NULL matrix.\n");
+        return false;
+    }
+
+    if (matrix->rows != matrix->columns) {
+        fprintf(
+            stderr,
+            "Cannot transpose a %zux%zu matrix in place; only square matrices can be.\n",
+            matrix->rows,
+            matrix->columns
+        );
+        return false;
     }
 
-    free(matrix);
+    matrix_transpose_diagonal(matrix->data, matrix->stride, 0, matrix->rows);
+    return true;
 }
@@ -14,34 +14,83 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include "arena.h"
+#include "gemm.h"
+#include "vector.h"
+
+#include <stdbool.h>
 #include <stdlib.h>
 
 // Structures
 
+/**
+ * @brief Alignment in bytes of matrix data and of every row; one cache line.
+ */
+#define MATRIX_ALIGNMENT 64
+
+/**
+ * @brief Describes who owns the memory behind a matrix, so matrix_free() releases it correctly.
+ */
+typedef enum {
+    MATRIX_STORAGE_ALIGNED, /**< Header and data share a single aligned heap allocation */
+    MATRIX_STORAGE_ALIAS,   /**< Header is owned; data borrows another matrix's memory */
+    MATRIX_STORAGE_ARENA,   /**< Header and data belong to an arena */
+    MATRIX_STORAGE_VIEW,    /**< Header is a value and data borrows part of another matrix */
+} matrix_storage_t;
+
 /**
  * @brief A structure representing a 2-dimensional matrix.
  *
  * A matrix is a rectangular array of rows and columns representing a 2-dimensional space.
- * This structure stores the number of rows and columns, along with a two-dimensional dynamic array
- * of floating-point values, which represent the components of the matrix.
+ * The elements are stored row-major in one contiguous, MATRIX_ALIGNMENT-aligned buffer. Rows are
+ * padded to a multiple of MATRIX_ALIGNMENT bytes, so every row starts on a cache line and the
+ * element at (row, column) is data[row * stride + column].
+ *
+ * A view (see matrix_view()) is a matrix_t whose data points into another matrix and whose stride
+ * is the parent's, so its rows need not be aligned. Every operation honors the stride and accepts
+ * views wherever it accepts matrices.
  *
- * @param elements A two-dimensional pointer to an array of floats, representing the matrix
- * elements.
+ * @param data     Contiguous row-major elements; rows * stride floats.
+ * @param elements Optional row-pointer view into data, NULL until matrix_row_view() builds it.
  * @param columns  The number of columns (width) of the matrix.
  * @param rows     The number of rows (height) of the matrix.
+ * @param stride   The number of floats between the starts of consecutive rows; at least columns.
+ * @param storage  Ownership of the memory behind the matrix.
  */
 typedef struct {
-    float** elements; ///< Two-dimensional array representing the matrix elements.
-    size_t  columns;  ///< The number of columns (width) of the matrix.
-    size_t  rows;     ///< The number of rows (height) of the matrix.
+    float*           data;     ///< Contiguous row-major elements.
+    float**          elements; ///< Optional row-pointer view, elements[row][column].
+    size_t           columns;  ///< The number of columns (width) of the matrix.
+    size_t           rows;     ///< The number of rows (height) of the matrix.
+    size_t           stride;   ///< The number of floats between the starts of consecutive rows.
+    matrix_storage_t storage;  ///< Ownership of the memory behind the matrix.
 } matrix_t;
 
+// Element access
+
+/**
+ * @brief Return a pointer to the first element of a row.
+ */
+static inline float* matrix_row(const matrix_t* matrix, size_t row) {
+    return matrix->data + row * matrix->stride;
+}
+
+/**
+ * @brief Return a pointer to the element at (row, column).
+ */
+static inline float* matrix_at(const matrix_t* matrix, size_t row, size_t column) {
+    return matrix->data + row * matrix->stride + column;
+}
+
 // Life-cycle operations
 
 /**
  * @brief Creates a new matrix with the specified number of rows and columns.
  * Initializes all elements to zero.
  *
+ * The header and the padded rows are carved out of a single aligned allocation, so creating and
+ * freeing a matrix costs one allocator call regardless of its size.
+ *
  * @param cols Number of columns.
  * @param rows Number of rows.
  *
@@ -50,13 +99,41 @@ typedef struct {
 matrix_t* matrix_create(size_t columns, size_t rows);
 
 /**
- * Free its memory. Safely handles NULL pointers.
+ * @brief Creates a new matrix inside an arena. Initializes all elements to zero.
+ *
+ * The structure and the data are bump-allocated from the arena, so the call never touches malloc.
+ * The matrix is released by arena_reset(); matrix_free() on it only releases a row view built by
+ * matrix_row_view().
+ *
+ * @param arena Arena to allocate from.
+ * @param cols Number of columns.
+ * @param rows Number of rows.
+ *
+ * @return Pointer to the newly created matrix or NULL if the arena is exhausted.
+ */
+matrix_t* matrix_create_in(arena_t* arena, size_t columns, size_t rows);
+
+/**
+ * Free its memory, including the row view if one was built. Safely handles NULL pointers.
+ *
+ * Shallow copies only release their own header and row view, never the shared data.
  *
  * @param matrix Pointer to the matrix to be destroyed.
- * @return true if the operation is successful, false otherwise.
  */
 void matrix_free(matrix_t* matrix);
 
+/**
+ * @brief Build, or return the already built, row-pointer view of a matrix.
+ *
+ * The view lets code written for the former array-of-rows layout keep using
+ * matrix->elements[row][column] while it migrates to matrix_at(). It costs one allocation of rows
+ * pointers, is owned by the matrix and is released by matrix_free().
+ *
+ * @param matrix Pointer to the matrix.
+ * @return The row pointers, also stored in matrix->elements, or NULL if allocation fails.
+ */
+float** matrix_row_view(matrix_t* matrix);
+
 /**
  * Creates a deep copy of a given matrix, duplicating all its elements.
  *
@@ -67,22 +144,78 @@ matrix_t* matrix_deep_copy(const matrix_t* matrix);
 
 /**
  * Creates a shallow copy of a given matrix. Only the matrix structure is duplicated, not the data.
+ * The copy has no row view of its own until matrix_row_view() builds one.
  *
  * @param matrix Pointer to the matrix to be copied.
  * @return Pointer to the new matrix structure or NULL if allocation fails.
  */
 matrix_t* matrix_shallow_copy(const matrix_t* matrix);
 
-// Additional operations (placeholders for future implementation)
+// Views
+//
+// Views are returned by value and reference the parent's memory without copying or allocating.
+// They stay valid as long as the parent does, and writes through a view change the parent. Views
+// of views are allowed. There is nothing to free unless matrix_row_view() was called on a view, in
+// which case matrix_free(&view) releases the row pointers only.
 
 /**
- * Adds two matrices and returns the result.
+ * @brief A rows x columns submatrix of a matrix, starting at (row, column).
  *
- * @param a Pointer to the first matrix.
- * @param b Pointer to the second matrix.
- * @return Pointer to the result matrix or NULL if the operation fails.
+ * @param matrix Pointer to the parent matrix.
+ * @param row First row of the view.
+ * @param column First column of the view.
+ * @param rows Number of rows of the view.
+ * @param columns Number of columns of the view.
+ * @return The view, or an empty view with NULL data if it does not fit inside the parent.
  */
-matrix_t* matrix_add(const matrix_t* a, const matrix_t* b);
+matrix_t
+matrix_view(const matrix_t* matrix, size_t row, size_t column, size_t rows, size_t columns);
+
+/**
+ * @brief One column of a matrix as a rows x 1 view whose stride steps from row to row.
+ *
+ * @param matrix Pointer to the parent matrix.
+ * @param column Index of the column.
+ * @return The view, or an empty view with NULL data if the column is out of range.
+ */
+matrix_t matrix_column_slice(const matrix_t* matrix, size_t column);
+
+/**
+ * @brief One row of a matrix as a vector_t, so every vector operation can work on it in place.
+ *
+ * Rows are contiguous, so the slice is an ordinary vector whose elements borrow the row. It is
+ * marked VECTOR_STORAGE_VIEW and vector_free() ignores it.
+ *
+ * @param matrix Pointer to the parent matrix.
+ * @param row Index of the row.
+ * @return The slice, or an empty vector with NULL elements if the row is out of range.
+ */
+vector_t matrix_row_slice(const matrix_t* matrix, size_t row);
+
+/**
+ * @brief Whether the memory spanned by two matrices or views overlaps.
+ *
+ * The span of a matrix runs from its first element to its last, padding between rows included, so
+ * two interleaved views, such as the even and odd columns of one parent, also count as overlapping.
+ */
+bool matrix_overlaps(const matrix_t* a, const matrix_t* b);
+
+// Arithmetic operations
+
+/**
+ * @brief Multiplies two matrices into an existing destination, dst = a b.
+ *
+ * The product is computed by gemm(), so it is cache-blocked, uses AVX2/FMA when available and
+ * spreads large products across the pool set with gemm_set_pool().
+ * dst must be a->rows x b->columns and must not overlap a or b.
+ *
+ * @param dst Destination matrix, overwritten.
+ * @param a Pointer to the left matrix, rows x k.
+ * @param b Pointer to the right matrix, k x columns.
+ * @return true on success, false if the shapes do not match, dst overlaps an operand, or the
+ *         packing buffers cannot be allocated.
+ */
+bool matrix_multiply_into(matrix_t* dst, const matrix_t* a, const matrix_t* b);
 
 /**
  * Multiplies two matrices and returns the result.
@@ -93,6 +226,37 @@ matrix_t* matrix_add(const matrix_t* a, const matrix_t* b);
  */
 matrix_t* matrix_multiply(const matrix_t* a, const matrix_t* b);
 
+// Transposition
+
+/**
+ * @brief Side of the square blocks that transposition recurses down to.
+ *
+ * Two 32 x 32 blocks of floats take 8 KiB, so a block and its transpose stay in the L1 cache.
+ */
+#define MATRIX_TRANSPOSE_BLOCK 32
+
+/**
+ * @brief Destinations larger than this many bytes are written with non-temporal stores.
+ *
+ * Above it the transpose would evict its own input, so each block is staged in a small buffer and
+ * streamed to memory a whole row at a time with simd_stream().
+ */
+#define MATRIX_TRANSPOSE_STREAM (1 << 21)
+
+/**
+ * @brief Transposes a matrix into an existing destination, dst = srcᵀ.
+ *
+ * The matrix is split cache-obliviously: the longer side is halved until blocks of at most
+ * MATRIX_TRANSPOSE_BLOCK x MATRIX_TRANSPOSE_BLOCK remain, which simd_transpose() moves through
+ * registers. Every cache level therefore works on blocks that fit it, whatever its size. Large
+ * destinations are written around the caches; see MATRIX_TRANSPOSE_STREAM.
+ *
+ * @param dst Destination matrix, src->columns x src->rows, overwritten.
+ * @param src Pointer to the matrix to transpose; must not overlap dst.
+ * @return true on success, false if the shapes do not match or dst overlaps src.
+ */
+bool matrix_transpose_into(matrix_t* dst, const matrix_t* src);
+
 /**
  * Transposes a matrix and returns the result.
  *
@@ -101,4 +265,26 @@ matrix_t* matrix_multiply(const matrix_t* a, const matrix_t* b);
  */
 matrix_t* matrix_transpose(const matrix_t* matrix);
 
+/**
+ * @brief Transposes a square matrix in place.
+ *
+ * Uses the same cache-oblivious recursion as matrix_transpose_into(): diagonal blocks are
+ * transposed through a small buffer, and each off-diagonal block is swapped with its mirror image.
+ *
+ * @param matrix Pointer to the square matrix to transpose.
+ * @return true on success, false if the matrix is NULL or not square.
+ */
+bool matrix_transpose_in_place(matrix_t* matrix);
+
+// Additional operations (placeholders for future implementation)
+
+/**
+ * Adds two matrices and returns the result.
+ *
+ * @param a Pointer to the first matrix.
+ * @param b Pointer to the second matrix.
+ * @return Pointer to the result matrix or NULL if the operation fails.
+ */
+matrix_t* matrix_add(const matrix_t* a, const matrix_t* b);
+
 #endif // MATRIX_H
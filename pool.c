@@ -0,0 +1,311 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file pool.c
+ *
+ * @brief A pthread worker pool for data-parallel loops
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+// pthread_setaffinity_np() and the CPU_* macros are GNU extensions
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
+#include "pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct pool {
+    pthread_t*      workers;    ///< Worker threads; there are threads - 1 of them.
+    size_t          threads;    ///< Threads executing jobs, including the caller.
+    pthread_mutex_t submit;     ///< Serializes jobs submitted from different threads.
+    pthread_mutex_t mutex;      ///< Guards generation, running and stop.
+    pthread_cond_t  wake;       ///< Signals the workers that a job or stop was posted.
+    pthread_cond_t  done;       ///< Signals the caller that the last worker finished.
+    size_t          generation; ///< Incremented once per job.
+    size_t          running;    ///< Workers still working on the current job.
+    bool            stop;       ///< Asks the workers to exit.
+
+    // Current job
+    pool_task_t   task;
+    void*         context;
+    size_t        n;
+    size_t        chunk;
+    size_t        chunks;
+    atomic_size_t next; ///< Next chunk to claim.
+
+    // One partial result per chunk for pool_reduce, grown on demand
+    float* partials;
+    size_t partials_capacity;
+};
+
+// Claim and run chunks of the current job until none are left
+static void pool_run_chunks(pool_t* pool) {
+    for (;;) {
+        size_t chunk = atomic_fetch_add_explicit(&pool->next, 1, memory_order_relaxed);
+        if (chunk >= pool->chunks) {
+            return;
+        }
+
+        size_t begin = chunk * pool->chunk;
+        size_t end   = begin + pool->chunk < pool->n ? begin + pool->chunk : pool->n;
+        pool->task(pool->context, chunk, begin, end);
+    }
+}
+
+static void* pool_worker(void* argument) {
+    pool_t* pool = (pool_t*) argument;
+    size_t  seen = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool_run_chunks(pool);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (0 == --pool->running) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+// Pool lifecycle
+pool_t* pool_create(size_t threads) {
+    if (0 == threads) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads     = online > 0 ? (size_t) online : 1;
+    }
+
+    pool_t* pool = (pool_t*) calloc(1, sizeof(pool_t));
+    if (NULL == pool) {
+        fprintf(stderr, "Failed to allocate %zu bytes to pool_t.\n", sizeof(pool_t));
+        return NULL;
+    }
+
+    pool->workers = (pthread_t*) malloc(threads * sizeof(pthread_t));
+    if (NULL == pool->workers) {
+        fprintf(stderr, "Failed to allocate %zu worker threads.\n", threads - 1);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->submit, NULL);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    atomic_init(&pool->next, 0);
+
+    // The caller always works, so only threads - 1 workers are started
+    pool->threads = 1;
+    for (size_t i = 0; i + 1 < threads; i++) {
+        if (0 != pthread_create(&pool->workers[i], NULL, pool_worker, pool)) {
+            fprintf(stderr, "Failed to start worker thread %zu of %zu.\n", i + 1, threads - 1);
+            pool_free(pool);
+            return NULL;
+        }
+        pool->threads++;
+    }
+
+    return pool;
+}
+
+void pool_free(pool_t* pool) {
+    if (NULL == pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (size_t i = 0; i + 1 < pool->threads; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->submit);
+
+    free(pool->partials);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t pool_threads(const pool_t* pool) {
+    return NULL == pool ? 1 : pool->threads;
+}
+
+bool pool_pin(pool_t* pool) {
+    if (NULL == pool) {
+        return false;
+    }
+
+#if defined(__linux__)
+    cpu_set_t allowed;
+    if (0 != pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed)) {
+        fprintf(stderr, "Failed to read the CPU affinity of the calling thread.\n");
+        return false;
+    }
+
+    const int cpus = CPU_COUNT(&allowed);
+    if (0 == cpus) {
+        return false;
+    }
+
+    bool pinned = true;
+    for (size_t thread = 0; thread < pool->threads; thread++) {
+        // Find the (thread mod cpus)-th allowed CPU
+        size_t skip = thread % (size_t) cpus;
+        size_t cpu  = 0;
+        for (; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed) && 0 == skip--) {
+                break;
+            }
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        // Thread 0 is the caller; the workers follow
+        pthread_t handle = 0 == thread ? pthread_self() : pool->workers[thread - 1];
+        if (0 != pthread_setaffinity_np(handle, sizeof(set), &set)) {
+            fprintf(stderr, "Failed to pin thread %zu to CPU %zu.\n", thread, cpu);
+            pinned = false;
+        }
+    }
+
+    return pinned;
+#else
+    fprintf(stderr, "Pinning threads is not supported on this platform.\n");
+    return false;
+#endif
+}
+
+// Post a job of several chunks to the workers, join in, and wait; the submit lock must be held
+static void pool_run(pool_t* pool, size_t n, size_t chunk, pool_task_t task, void* context) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->task    = task;
+    pool->context = context;
+    pool->n       = n;
+    pool->chunk   = chunk;
+    pool->chunks  = (n + chunk - 1) / chunk;
+    atomic_store_explicit(&pool->next, 0, memory_order_relaxed);
+    pool->running = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool_run_chunks(pool);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// Pool jobs
+void pool_for(pool_t* pool, size_t n, size_t chunk, pool_task_t task, void* context) {
+    if (0 == n) {
+        return;
+    }
+
+    if (0 == chunk || chunk > n) {
+        chunk = n;
+    }
+
+    const size_t chunks = (n + chunk - 1) / chunk;
+
+    // Nothing to share: run the same chunks on the caller
+    if (NULL == pool || 1 == pool->threads || 1 == chunks) {
+        for (size_t c = 0; c < chunks; c++) {
+            size_t begin = c * chunk;
+            size_t end   = begin + chunk < n ? begin + chunk : n;
+            task(context, c, begin, end);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&pool->submit);
+    pool_run(pool, n, chunk, task, context);
+    pthread_mutex_unlock(&pool->submit);
+}
+
+typedef struct {
+    pool_reduce_t reduce;
+    void*         context;
+    float*        partials;
+} pool_reduction_t;
+
+static void pool_reduce_task(void* context, size_t chunk, size_t begin, size_t end) {
+    pool_reduction_t* reduction = (pool_reduction_t*) context;
+    reduction->partials[chunk]  = reduction->reduce(reduction->context, begin, end);
+}
+
+float pool_reduce(pool_t* pool, size_t n, size_t chunk, pool_reduce_t reduce, void* context) {
+    if (0 == chunk || chunk > n) {
+        chunk = n;
+    }
+
+    const size_t chunks = 0 == n ? 0 : (n + chunk - 1) / chunk;
+    float        sum    = 0.0f;
+
+    // Serial path: the same partials, added in the same order as they are produced
+    if (NULL == pool || 1 == pool->threads || chunks <= 1) {
+        for (size_t c = 0; c < chunks; c++) {
+            size_t begin  = c * chunk;
+            size_t end    = begin + chunk < n ? begin + chunk : n;
+            sum          += reduce(context, begin, end);
+        }
+        return sum;
+    }
+
+    // The partials buffer is shared by every job, so hold the submit lock until it is summed
+    pthread_mutex_lock(&pool->submit);
+
+    if (chunks > pool->partials_capacity) {
+        float* partials = (float*) realloc(pool->partials, chunks * sizeof(float));
+        if (NULL == partials) {
+            pthread_mutex_unlock(&pool->submit);
+            fprintf(stderr, "Failed to allocate %zu partial sums; reducing serially.\n", chunks);
+            return pool_reduce(NULL, n, chunk, reduce, context);
+        }
+        pool->partials          = partials;
+        pool->partials_capacity = chunks;
+    }
+
+    pool_reduction_t reduction = {reduce, context, pool->partials};
+    pool_run(pool, n, chunk, pool_reduce_task, &reduction);
+
+    for (size_t c = 0; c < chunks; c++) {
+        sum += pool->partials[c];
+    }
+
+    pthread_mutex_unlock(&pool->submit);
+    return sum;
+}
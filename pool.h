@@ -0,0 +1,105 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file pool.h
+ *
+ * @brief A pthread worker pool for data-parallel loops
+ *
+ * A pool_t owns a fixed set of worker threads that sleep until a job is submitted. A job splits
+ * the range [0, n) into fixed-size chunks; the workers and the calling thread claim chunks until
+ * none are left, so uneven chunks balance themselves.
+ *
+ * Chunk boundaries depend only on n and the chunk size, never on the number of threads. Reductions
+ * store one partial result per chunk and combine them in chunk order, so their results are
+ * bit-identical for any thread count, including the serial fallback.
+ *
+ * A pool runs one job at a time; concurrent submissions from different threads are serialized.
+ * A task must not submit a job to the pool that is running it.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @brief Opaque worker pool.
+ */
+typedef struct pool pool_t;
+
+/**
+ * @brief Work on the elements [begin, end) of chunk number chunk.
+ */
+typedef void (*pool_task_t)(void* context, size_t chunk, size_t begin, size_t end);
+
+/**
+ * @brief Reduce the elements [begin, end) to a partial sum.
+ */
+typedef float (*pool_reduce_t)(void* context, size_t begin, size_t end);
+
+/**
+ * @brief Create a pool.
+ *
+ * @param threads Number of threads executing jobs, including the caller; 0 uses one per online CPU
+ * @return A pointer to the new pool, NULL on failure
+ */
+pool_t* pool_create(size_t threads);
+
+/**
+ * @brief Stop and join the workers, then free the pool. NULL is ignored.
+ */
+void pool_free(pool_t* pool);
+
+/**
+ * @brief Number of threads executing jobs, including the caller. A NULL pool has 1.
+ */
+size_t pool_threads(const pool_t* pool);
+
+/**
+ * @brief Pin each thread of the pool to its own CPU.
+ *
+ * The CPUs are taken in order from the affinity mask of the calling thread: the caller is pinned
+ * to the first and worker i to the (i + 1)-th, wrapping around when there are more threads than
+ * CPUs. Pinning keeps each thread's share of a job next to the caches it warmed on the previous
+ * job. It changes the affinity of the calling thread too, and is only supported on Linux.
+ *
+ * @param pool Pool to pin
+ * @return true if every thread was pinned, false otherwise
+ */
+bool pool_pin(pool_t* pool);
+
+/**
+ * @brief Run task over [0, n) in chunks of the given size and wait for it to finish.
+ *
+ * A NULL pool, a single-threaded pool or a range of a single chunk runs serially on the caller
+ * without waking any workers.
+ *
+ * @param pool Pool to run on, or NULL
+ * @param n Number of elements
+ * @param chunk Elements per chunk; the last chunk may be shorter
+ * @param task Function applied to each chunk
+ * @param context Passed through to task
+ */
+void pool_for(pool_t* pool, size_t n, size_t chunk, pool_task_t task, void* context);
+
+/**
+ * @brief Sum the partial results of reduce over [0, n) in chunks of the given size.
+ *
+ * The partial sums are added in chunk order, so the result does not depend on the thread count.
+ *
+ * @param pool Pool to run on, or NULL
+ * @param n Number of elements
+ * @param chunk Elements per chunk; the last chunk may be shorter
+ * @param reduce Function reducing each chunk
+ * @param context Passed through to reduce
+ * @return The sum of the partial results
+ */
+float pool_reduce(pool_t* pool, size_t n, size_t chunk, pool_reduce_t reduce, void* context);
+
+#endif // POOL_H
@@ -25,17 +25,17 @@ line_segment_t* create_line(size_t cols) {
         return NULL;
     }
 
-    line->start = create_vector(cols);
+    line->start = vector_create(cols);
     if (NULL == line->start) {
         fprintf(stderr, "Failed to allocate memory for line start.\n");
         free(line);
         return NULL;
     }
 
-    line->end = create_vector(cols);
+    line->end = vector_create(cols);
     if (NULL == line->end) {
         fprintf(stderr, "Failed to allocate memory for line end.\n");
-        free_vector(line->start);
+        vector_free(line->start);
         free(line);
         return NULL;
     }
@@ -50,11 +50,11 @@ void free_line(line_segment_t* line) {
     }
 
     if (line->start) {
-        free_vector(line->start);
+        vector_free(line->start);
     }
 
     if (line->end) {
-        free_vector(line->end);
+        vector_free(line->end);
     }
 
     free(line);
@@ -68,7 +68,7 @@ polygon_t* create_polygon(size_t max_vertices) {
         return NULL;
     }
 
-    polygon->vertices = create_vector(max_vertices);
+    polygon->vertices = vector_create(max_vertices);
     if (NULL == polygon->vertices) {
         fprintf(stderr, "Failed to allocate memory for polygon vertices.\n");
         free(polygon);
@@ -90,7 +90,7 @@ void free_polygon(polygon_t* polygon) {
     }
 
     if (polygon->vertices) {
-        free_vector(polygon->vertices);
+        vector_free(polygon->vertices);
     }
 
     free(polygon);
@@ -104,7 +104,7 @@ screen_space_t* create_screen_space(size_t max_vertices) {
         return NULL;
     }
 
-    screen->vertices = create_vector(max_vertices);
+    screen->vertices = vector_create(max_vertices);
     if (NULL == screen->vertices) {
         fprintf(stderr, "Failed to allocate memory for screen vertices.\n");
         free(screen);
@@ -126,8 +126,64 @@ void free_screen_space(screen_space_t* screen) {
     }
 
     if (screen->vertices) {
-        free_vector(screen->vertices);
+        vector_free(screen->vertices);
     }
 
     free(screen);
 }
+
+// Arena variants
+line_segment_t* create_line_in(arena_t* arena, size_t cols) {
+    line_segment_t* line
+        = (line_segment_t*) arena_alloc(arena, sizeof(line_segment_t), _Alignof(line_segment_t));
+    if (NULL == line) {
+        return NULL; // arena_alloc logs the error for us
+    }
+
+    line->start = vector_create_in(arena, cols);
+    line->end   = vector_create_in(arena, cols);
+    if (NULL == line->start || NULL == line->end) {
+        return NULL; // partial allocations are reclaimed with the rest of the arena
+    }
+
+    return line;
+}
+
+polygon_t* create_polygon_in(arena_t* arena, size_t max_vertices) {
+    polygon_t* polygon = (polygon_t*) arena_alloc(arena, sizeof(polygon_t), _Alignof(polygon_t));
+    if (NULL == polygon) {
+        return NULL; // arena_alloc logs the error for us
+    }
+
+    polygon->vertices = vector_create_in(arena, max_vertices);
+    if (NULL == polygon->vertices) {
+        return NULL; // partial allocations are reclaimed with the rest of the arena
+    }
+
+    polygon->vectices_max   = max_vertices;
+    polygon->vertices_count = 0;    // Initialize count of vertices
+    polygon->height         = 0.0f; // Default height
+    polygon->distance       = 0.0f; // Default distance
+
+    return polygon;
+}
+
+screen_space_t* create_screen_space_in(arena_t* arena, size_t max_vertices) {
+    screen_space_t* screen
+        = (screen_space_t*) arena_alloc(arena, sizeof(screen_space_t), _Alignof(screen_space_t));
+    if (NULL == screen) {
+        return NULL; // arena_alloc logs the error for us
+    }
+
+    screen->vertices = vector_create_in(arena, max_vertices);
+    if (NULL == screen->vertices) {
+        return NULL; // partial allocations are reclaimed with the rest of the arena
+    }
+
+    screen->vectices_max   = max_vertices;
+    screen->vertices_count = 0;    // Initialize count to 0
+    screen->depth          = 0.0f; // Default depth
+    screen->id             = 0;    // Default identifier
+
+    return screen;
+}
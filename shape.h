@@ -53,8 +53,8 @@ typedef struct {
  * @brief Represents a line segment with a start and end point
  */
 typedef struct {
-    float_point_t* start; /**< Start point of the line (run) */
-    float_point_t* end;   /**< End point of the line (rise) */
+    vector_t* start; /**< Start point of the line (run) */
+    vector_t* end;   /**< End point of the line (rise) */
 } line_segment_t;
 
 // Polygon structure
@@ -89,4 +89,12 @@ void       free_polygon(polygon_t* polygon);
 screen_space_t* create_screen_space(size_t max_vertices);
 void            free_screen_space(screen_space_t* screen);
 
+// Arena variants
+//
+// These allocate the shape and its vectors from a per-frame arena instead of the heap. The shapes
+// are released by arena_reset() and must not be passed to the free_* functions above.
+line_segment_t* create_line_in(arena_t* arena, size_t cols);
+polygon_t*      create_polygon_in(arena_t* arena, size_t max_vertices);
+screen_space_t* create_screen_space_in(arena_t* arena, size_t max_vertices);
+
 #endif // SHAPE_H
@@ -0,0 +1,769 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file simd.c
+ *
+ * @brief Runtime-dispatched SIMD kernels for float arrays
+ *
+ * Every reduction is expressed as a "step" that folds one register of elements into an accumulator.
+ * The SIMD_REDUCTION macro expands a step into a complete kernel with four independent accumulators
+ * and a masked tail step, once per instruction set level. Each level is compiled with a GCC/Clang
+ * target attribute, so no global -m flags are required and the binary still runs on baseline x86-64.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "simd.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define SIMD_X86 1
+    #include <immintrin.h>
+#else
+    #define SIMD_X86 0
+#endif
+
+typedef float (*simd_reduction_t)(const float* a, const float* b, size_t n);
+
+// Portable kernels
+
+static inline float scalar_sum_step(float acc, float a, float b) {
+    (void) b;
+    return acc + a;
+}
+
+static inline float scalar_sum_squares_step(float acc, float a, float b) {
+    (void) b;
+    return acc + a * a;
+}
+
+static inline float scalar_dot_step(float acc, float a, float b) {
+    return acc + a * b;
+}
+
+static inline float scalar_distance_squared_step(float acc, float a, float b) {
+    float d = a - b;
+    return acc + d * d;
+}
+
+#define SCALAR_REDUCTION(op)                                             \
+    static float scalar_##op(const float* a, const float* b, size_t n) { \
+        float  acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;       \
+        size_t i    = 0;                                                 \
+        for (; i + 4 <= n; i += 4) {                                     \
+            acc0 = scalar_##op##_step(acc0, a[i + 0], b[i + 0]);         \
+            acc1 = scalar_##op##_step(acc1, a[i + 1], b[i + 1]);         \
+            acc2 = scalar_##op##_step(acc2, a[i + 2], b[i + 2]);         \
+            acc3 = scalar_##op##_step(acc3, a[i + 3], b[i + 3]);         \
+        }                                                                \
+        for (; i < n; i++) {                                             \
+            acc0 = scalar_##op##_step(acc0, a[i], b[i]);                 \
+        }                                                                \
+        return (acc0 + acc1) + (acc2 + acc3);                            \
+    }
+
+SCALAR_REDUCTION(sum)
+SCALAR_REDUCTION(sum_squares)
+SCALAR_REDUCTION(dot)
+SCALAR_REDUCTION(distance_squared)
+
+#if SIMD_X86
+
+// Shared kernel template: four accumulators of `width` lanes, then one partial-register step
+    #define SIMD_REDUCTION(level, isa, vec, width, op)                                           \
+        __attribute__((target(isa))) static float level##_##op(                                  \
+            const float* a, const float* b, size_t n                                             \
+        ) {                                                                                      \
+            vec    acc0 = level##_zero(), acc1 = acc0, acc2 = acc0, acc3 = acc0;                 \
+            size_t i    = 0;                                                                     \
+            for (; i + 4 * (width) <= n; i += 4 * (width)) {                                     \
+                acc0 = level##_##op##_step(                                                      \
+                    acc0, level##_load(a + i), level##_load(b + i)                               \
+                );                                                                               \
+                acc1 = level##_##op##_step(                                                      \
+                    acc1, level##_load(a + i + (width)), level##_load(b + i + (width))           \
+                );                                                                               \
+                acc2 = level##_##op##_step(                                                      \
+                    acc2, level##_load(a + i + 2 * (width)), level##_load(b + i + 2 * (width))   \
+                );                                                                               \
+                acc3 = level##_##op##_step(                                                      \
+                    acc3, level##_load(a + i + 3 * (width)), level##_load(b + i + 3 * (width))   \
+                );                                                                               \
+            }                                                                                    \
+            for (; i + (width) <= n; i += (width)) {                                             \
+                acc0 = level##_##op##_step(acc0, level##_load(a + i), level##_load(b + i));      \
+            }                                                                                    \
+            if (i < n) {                                                                         \
+                acc0 = level##_##op##_step(                                                      \
+                    acc0, level##_load_partial(a + i, n - i), level##_load_partial(b + i, n - i) \
+                );                                                                               \
+            }                                                                                    \
+            return level##_hsum(level##_add(level##_add(acc0, acc1), level##_add(acc2, acc3)));  \
+        }
+
+// SSE2 kernels
+
+    #define SSE2 "sse2"
+
+__attribute__((target(SSE2))) static inline __m128 sse2_zero(void) {
+    return _mm_setzero_ps();
+}
+
+__attribute__((target(SSE2))) static inline __m128 sse2_load(const float* p) {
+    return _mm_loadu_ps(p);
+}
+
+// Lanes past count are zero, which every step treats as a no-op
+__attribute__((target(SSE2))) static inline __m128 sse2_load_partial(const float* p, size_t count) {
+    float lanes[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < count; i++) {
+        lanes[i] = p[i];
+    }
+    return _mm_loadu_ps(lanes);
+}
+
+__attribute__((target(SSE2))) static inline __m128 sse2_add(__m128 a, __m128 b) {
+    return _mm_add_ps(a, b);
+}
+
+__attribute__((target(SSE2))) static inline float sse2_hsum(__m128 v) {
+    __m128 shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums     = _mm_add_ps(v, shuffled);
+    shuffled        = _mm_movehl_ps(shuffled, sums);
+    sums            = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target(SSE2))) static inline __m128 sse2_sum_step(__m128 acc, __m128 a, __m128 b) {
+    (void) b;
+    return _mm_add_ps(acc, a);
+}
+
+__attribute__((target(SSE2))) static inline __m128
+sse2_sum_squares_step(__m128 acc, __m128 a, __m128 b) {
+    (void) b;
+    return _mm_add_ps(acc, _mm_mul_ps(a, a));
+}
+
+__attribute__((target(SSE2))) static inline __m128 sse2_dot_step(__m128 acc, __m128 a, __m128 b) {
+    return _mm_add_ps(acc, _mm_mul_ps(a, b));
+}
+
+__attribute__((target(SSE2))) static inline __m128
+sse2_distance_squared_step(__m128 acc, __m128 a, __m128 b) {
+    __m128 d = _mm_sub_ps(a, b);
+    return _mm_add_ps(acc, _mm_mul_ps(d, d));
+}
+
+SIMD_REDUCTION(sse2, SSE2, __m128, 4, sum)
+SIMD_REDUCTION(sse2, SSE2, __m128, 4, sum_squares)
+SIMD_REDUCTION(sse2, SSE2, __m128, 4, dot)
+SIMD_REDUCTION(sse2, SSE2, __m128, 4, distance_squared)
+
+// AVX2 kernels
+
+    #define AVX2 "avx2,fma"
+
+__attribute__((target(AVX2))) static inline __m256 avx2_zero(void) {
+    return _mm256_setzero_ps();
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_load(const float* p) {
+    return _mm256_loadu_ps(p);
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_load_partial(const float* p, size_t count) {
+    // Sliding window over the table yields a mask with the first count lanes set
+    static const int32_t mask_table[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+    __m256i mask = _mm256_loadu_si256((const __m256i*) (mask_table + 8 - count));
+    return _mm256_maskload_ps(p, mask);
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_add(__m256 a, __m256 b) {
+    return _mm256_add_ps(a, b);
+}
+
+__attribute__((target(AVX2))) static inline float avx2_hsum(__m256 v) {
+    __m128 low      = _mm256_castps256_ps128(v);
+    __m128 high     = _mm256_extractf128_ps(v, 1);
+    __m128 sums     = _mm_add_ps(low, high);
+    __m128 shuffled = _mm_movehdup_ps(sums);
+    sums            = _mm_add_ps(sums, shuffled);
+    shuffled        = _mm_movehl_ps(shuffled, sums);
+    sums            = _mm_add_ss(sums, shuffled);
+    return _mm_cvtss_f32(sums);
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_sum_step(__m256 acc, __m256 a, __m256 b) {
+    (void) b;
+    return _mm256_add_ps(acc, a);
+}
+
+__attribute__((target(AVX2))) static inline __m256
+avx2_sum_squares_step(__m256 acc, __m256 a, __m256 b) {
+    (void) b;
+    return _mm256_fmadd_ps(a, a, acc);
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_dot_step(__m256 acc, __m256 a, __m256 b) {
+    return _mm256_fmadd_ps(a, b, acc);
+}
+
+__attribute__((target(AVX2))) static inline __m256
+avx2_distance_squared_step(__m256 acc, __m256 a, __m256 b) {
+    __m256 d = _mm256_sub_ps(a, b);
+    return _mm256_fmadd_ps(d, d, acc);
+}
+
+SIMD_REDUCTION(avx2, AVX2, __m256, 8, sum)
+SIMD_REDUCTION(avx2, AVX2, __m256, 8, sum_squares)
+SIMD_REDUCTION(avx2, AVX2, __m256, 8, dot)
+SIMD_REDUCTION(avx2, AVX2, __m256, 8, distance_squared)
+
+// AVX-512 kernels
+
+    #define AVX512 "avx512f"
+
+__attribute__((target(AVX512))) static inline __m512 avx512_zero(void) {
+    return _mm512_setzero_ps();
+}
+
+__attribute__((target(AVX512))) static inline __m512 avx512_load(const float* p) {
+    return _mm512_loadu_ps(p);
+}
+
+__attribute__((target(AVX512))) static inline __m512
+avx512_load_partial(const float* p, size_t count) {
+    return _mm512_maskz_loadu_ps((__mmask16) ((1u << count) - 1), p);
+}
+
+__attribute__((target(AVX512))) static inline __m512 avx512_add(__m512 a, __m512 b) {
+    return _mm512_add_ps(a, b);
+}
+
+__attribute__((target(AVX512))) static inline float avx512_hsum(__m512 v) {
+    return _mm512_reduce_add_ps(v);
+}
+
+__attribute__((target(AVX512))) static inline __m512
+avx512_sum_step(__m512 acc, __m512 a, __m512 b) {
+    (void) b;
+    return _mm512_add_ps(acc, a);
+}
+
+__attribute__((target(AVX512))) static inline __m512
+avx512_sum_squares_step(__m512 acc, __m512 a, __m512 b) {
+    (void) b;
+    return _mm512_fmadd_ps(a, a, acc);
+}
+
+__attribute__((target(AVX512))) static inline __m512
+avx512_dot_step(__m512 acc, __m512 a, __m512 b) {
+    return _mm512_fmadd_ps(a, b, acc);
+}
+
+__attribute__((target(AVX512))) static inline __m512
+avx512_distance_squared_step(__m512 acc, __m512 a, __m512 b) {
+    __m512 d = _mm512_sub_ps(a, b);
+    return _mm512_fmadd_ps(d, d, acc);
+}
+
+SIMD_REDUCTION(avx512, AVX512, __m512, 16, sum)
+SIMD_REDUCTION(avx512, AVX512, __m512, 16, sum_squares)
+SIMD_REDUCTION(avx512, AVX512, __m512, 16, dot)
+SIMD_REDUCTION(avx512, AVX512, __m512, 16, distance_squared)
+
+#endif // SIMD_X86
+
+// Coordinate conversions
+//
+// sin/cos: the angle is reduced to r in [-π/4, π/4] by subtracting the nearest multiple k of π/2
+// (Cody-Waite, with π/2 split into three parts), then minimax polynomials for sin(r) and cos(r) are
+// combined according to the quadrant k mod 4. The three-part split keeps the reduction accurate
+// only while |θ| ≤ SIMD_SINCOS_MAX; angles beyond it, and non-finite ones, go through libm.
+//
+// atan2: the ratio min(|x|, |y|) / max(|x|, |y|) lies in [0, 1]. Ratios above tan(π/8) are mapped
+// through (t - 1) / (t + 1) so a short odd polynomial suffices, and the octant is restored from
+// the magnitudes and signs of x and y.
+//
+// The coefficients are the single-precision minimax sets from the Cephes library.
+
+typedef void (*simd_coordinate_t)(const float* a, const float* b, float* c, float* d, size_t n);
+
+#define SIMD_TWO_OVER_PI 0.636619772367581343f
+#define SIMD_PI_2_HIGH   1.5703125f
+#define SIMD_PI_2_MID    4.837512969970703125e-4f
+#define SIMD_PI_2_LOW    7.54978995489188216e-8f
+#define SIMD_SIN_C1      -1.6666654611e-1f
+#define SIMD_SIN_C2      8.3321608736e-3f
+#define SIMD_SIN_C3      -1.9515295891e-4f
+#define SIMD_COS_C1      4.166664568298827e-2f
+#define SIMD_COS_C2      -1.388731625493765e-3f
+#define SIMD_COS_C3      2.443315711809948e-5f
+#define SIMD_TAN_PI_8    0.414213562373095049f
+#define SIMD_ATAN_C1     -3.33329491539e-1f
+#define SIMD_ATAN_C2     1.99777106478e-1f
+#define SIMD_ATAN_C3     -1.38776856032e-1f
+#define SIMD_ATAN_C4     8.05374449538e-2f
+#define SIMD_PI          3.14159265358979323846f
+#define SIMD_PI_2        1.57079632679489661923f
+#define SIMD_PI_4        0.785398163397448309616f
+#define SIMD_SINCOS_MAX  4.0e4f
+
+static inline void scalar_sincos_step(float angle, float* sine, float* cosine) {
+    // Past the limit the reduction loses accuracy and k may not fit an int; NaN and ±∞ land here too
+    if (!(fabsf(angle) <= SIMD_SINCOS_MAX)) {
+        *sine   = sinf(angle);
+        *cosine = cosf(angle);
+        return;
+    }
+
+    float k = rintf(angle * SIMD_TWO_OVER_PI);
+    int   q = (int) k;
+    float r = ((angle - k * SIMD_PI_2_HIGH) - k * SIMD_PI_2_MID) - k * SIMD_PI_2_LOW;
+
+    float r2 = r * r;
+    float s  = r + r * r2 * (SIMD_SIN_C1 + r2 * (SIMD_SIN_C2 + r2 * SIMD_SIN_C3));
+    float c  = 1.0f - 0.5f * r2 + r2 * r2 * (SIMD_COS_C1 + r2 * (SIMD_COS_C2 + r2 * SIMD_COS_C3));
+
+    // Odd quadrants swap sin and cos; the sign follows the quadrant
+    float sin_r = (q & 1) ? c : s;
+    float cos_r = (q & 1) ? s : c;
+    *sine       = (q & 2) ? -sin_r : sin_r;
+    *cosine     = ((q + 1) & 2) ? -cos_r : cos_r;
+}
+
+static inline float scalar_atan2_step(float y, float x) {
+    float ax      = fabsf(x);
+    float ay      = fabsf(y);
+    float largest = ax > ay ? ax : ay;
+    float ratio   = (ax > ay ? ay : ax) / (largest > 0.0f ? largest : 1.0f);
+
+    // Fold ratios above tan(π/8) back into the accurate range of the polynomial
+    bool  folded = ratio > SIMD_TAN_PI_8;
+    float t      = folded ? (ratio - 1.0f) / (ratio + 1.0f) : ratio;
+    float z      = t * t;
+    float angle
+        = t + t * z * (SIMD_ATAN_C1 + z * (SIMD_ATAN_C2 + z * (SIMD_ATAN_C3 + z * SIMD_ATAN_C4)));
+    angle = folded ? angle + SIMD_PI_4 : angle;
+
+    // Restore the octant from the magnitudes and signs of x and y
+    angle = ay > ax ? SIMD_PI_2 - angle : angle;
+    angle = signbit(x) ? SIMD_PI - angle : angle;
+    return copysignf(angle, y);
+}
+
+static void scalar_polar_to_cartesian(
+    const float* radii, const float* angles, float* xs, float* ys, size_t n
+) {
+    for (size_t i = 0; i < n; i++) {
+        float sine, cosine;
+        scalar_sincos_step(angles[i], &sine, &cosine);
+        xs[i] = radii[i] * cosine;
+        ys[i] = radii[i] * sine;
+    }
+}
+
+static void scalar_cartesian_to_polar(
+    const float* xs, const float* ys, float* radii, float* angles, size_t n
+) {
+    for (size_t i = 0; i < n; i++) {
+        float x   = xs[i];
+        float y   = ys[i];
+        radii[i]  = sqrtf(x * x + y * y);
+        angles[i] = scalar_atan2_step(y, x);
+    }
+}
+
+#if SIMD_X86
+
+// AVX2 coordinate kernels; the wider levels reuse these
+
+__attribute__((target(AVX2))) static inline void
+avx2_sincos_step(__m256 angle, __m256* sine, __m256* cosine) {
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+
+    // Lanes past the limit (or NaN) are reduced as 0 here and patched through libm at the end
+    __m256 magnitude = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), angle);
+    __m256 inside    = _mm256_cmp_ps(magnitude, _mm256_set1_ps(SIMD_SINCOS_MAX), _CMP_LE_OQ);
+    __m256 reduced   = _mm256_and_ps(angle, inside);
+
+    __m256 k = _mm256_round_ps(
+        _mm256_mul_ps(reduced, _mm256_set1_ps(SIMD_TWO_OVER_PI)),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC
+    );
+    __m256i q = _mm256_cvtps_epi32(k);
+    __m256  r = _mm256_fnmadd_ps(k, _mm256_set1_ps(SIMD_PI_2_HIGH), reduced);
+    r         = _mm256_fnmadd_ps(k, _mm256_set1_ps(SIMD_PI_2_MID), r);
+    r         = _mm256_fnmadd_ps(k, _mm256_set1_ps(SIMD_PI_2_LOW), r);
+
+    __m256 r2 = _mm256_mul_ps(r, r);
+    __m256 s  = _mm256_fmadd_ps(r2, _mm256_set1_ps(SIMD_SIN_C3), _mm256_set1_ps(SIMD_SIN_C2));
+    s         = _mm256_fmadd_ps(r2, s, _mm256_set1_ps(SIMD_SIN_C1));
+    s         = _mm256_fmadd_ps(_mm256_mul_ps(r, r2), s, r);
+    __m256 c  = _mm256_fmadd_ps(r2, _mm256_set1_ps(SIMD_COS_C3), _mm256_set1_ps(SIMD_COS_C2));
+    c         = _mm256_fmadd_ps(r2, c, _mm256_set1_ps(SIMD_COS_C1));
+    __m256 c0 = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2, _mm256_set1_ps(1.0f));
+    c         = _mm256_fmadd_ps(_mm256_mul_ps(r2, r2), c, c0);
+
+    __m256 swap     = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(q, one), one));
+    __m256 sin_r    = _mm256_blendv_ps(s, c, swap);
+    __m256 cos_r    = _mm256_blendv_ps(c, s, swap);
+    __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, two), 30));
+    __m256 cos_sign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(q, one), two), 30)
+    );
+    *sine   = _mm256_xor_ps(sin_r, sin_sign);
+    *cosine = _mm256_xor_ps(cos_r, cos_sign);
+
+    int outside = ~_mm256_movemask_ps(inside) & 0xFF;
+    if (0 != outside) {
+        float angles[8], sines[8], cosines[8];
+        _mm256_storeu_ps(angles, angle);
+        _mm256_storeu_ps(sines, *sine);
+        _mm256_storeu_ps(cosines, *cosine);
+        for (int lane = 0; lane < 8; lane++) {
+            if (outside & (1 << lane)) {
+                sines[lane]   = sinf(angles[lane]);
+                cosines[lane] = cosf(angles[lane]);
+            }
+        }
+        *sine   = _mm256_loadu_ps(sines);
+        *cosine = _mm256_loadu_ps(cosines);
+    }
+}
+
+__attribute__((target(AVX2))) static inline __m256 avx2_atan2_step(__m256 y, __m256 x) {
+    const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+    const __m256 zero      = _mm256_setzero_ps();
+
+    __m256 ax       = _mm256_andnot_ps(sign_mask, x);
+    __m256 ay       = _mm256_andnot_ps(sign_mask, y);
+    __m256 largest  = _mm256_max_ps(ax, ay);
+    __m256 smallest = _mm256_min_ps(ax, ay);
+    __m256 ratio    = _mm256_div_ps(smallest, largest);
+    ratio           = _mm256_blendv_ps(ratio, zero, _mm256_cmp_ps(largest, zero, _CMP_EQ_OQ));
+
+    __m256 folded = _mm256_cmp_ps(ratio, _mm256_set1_ps(SIMD_TAN_PI_8), _CMP_GT_OQ);
+    __m256 t      = _mm256_blendv_ps(
+        ratio,
+        _mm256_div_ps(
+            _mm256_sub_ps(ratio, _mm256_set1_ps(1.0f)), _mm256_add_ps(ratio, _mm256_set1_ps(1.0f))
+        ),
+        folded
+    );
+    __m256 z     = _mm256_mul_ps(t, t);
+    __m256 p     = _mm256_fmadd_ps(z, _mm256_set1_ps(SIMD_ATAN_C4), _mm256_set1_ps(SIMD_ATAN_C3));
+    p            = _mm256_fmadd_ps(z, p, _mm256_set1_ps(SIMD_ATAN_C2));
+    p            = _mm256_fmadd_ps(z, p, _mm256_set1_ps(SIMD_ATAN_C1));
+    __m256 angle = _mm256_fmadd_ps(_mm256_mul_ps(t, z), p, t);
+    angle        = _mm256_blendv_ps(angle, _mm256_add_ps(angle, _mm256_set1_ps(SIMD_PI_4)), folded);
+
+    angle = _mm256_blendv_ps(
+        angle, _mm256_sub_ps(_mm256_set1_ps(SIMD_PI_2), angle), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ)
+    );
+    angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(SIMD_PI), angle), x); // sign of x
+    return _mm256_or_ps(angle, _mm256_and_ps(y, sign_mask));                         // sign of y
+}
+
+__attribute__((target(AVX2))) static void
+avx2_polar_to_cartesian(const float* radii, const float* angles, float* xs, float* ys, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 sine, cosine;
+        avx2_sincos_step(_mm256_loadu_ps(angles + i), &sine, &cosine);
+        __m256 r = _mm256_loadu_ps(radii + i);
+        _mm256_storeu_ps(xs + i, _mm256_mul_ps(r, cosine));
+        _mm256_storeu_ps(ys + i, _mm256_mul_ps(r, sine));
+    }
+    scalar_polar_to_cartesian(radii + i, angles + i, xs + i, ys + i, n - i);
+}
+
+__attribute__((target(AVX2))) static void
+avx2_cartesian_to_polar(const float* xs, const float* ys, float* radii, float* angles, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        _mm256_storeu_ps(radii + i, _mm256_sqrt_ps(_mm256_fmadd_ps(x, x, _mm256_mul_ps(y, y))));
+        _mm256_storeu_ps(angles + i, avx2_atan2_step(y, x));
+    }
+    scalar_cartesian_to_polar(xs + i, ys + i, radii + i, angles + i, n - i);
+}
+
+#endif // SIMD_X86
+
+// Matrix kernels
+//
+// A block is transposed in width x width tiles held in registers: each tile is loaded row by row,
+// transposed with unpack and shuffle instructions, and stored row by row into the destination.
+// Rows and columns left over at the edges fall back to the portable kernel.
+
+typedef void (*simd_transpose_t)(
+    const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns
+);
+
+typedef void (*simd_stream_t)(float* dst, const float* src, size_t n);
+
+static void scalar_stream(float* dst, const float* src, size_t n) {
+    memcpy(dst, src, n * sizeof(float));
+}
+
+static void scalar_transpose(
+    const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns
+) {
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t j = 0; j < columns; j++) {
+            dst[j * ldd + i] = src[i * lds + j];
+        }
+    }
+}
+
+#if SIMD_X86
+
+// Full width x width tiles through level##_transpose_tile, the edges through the portable kernel
+    #define SIMD_TRANSPOSE(level, isa, width)                                                 \
+        __attribute__((target(isa))) static void level##_transpose(                           \
+            const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns \
+        ) {                                                                                   \
+            size_t i = 0;                                                                     \
+            for (; i + (width) <= rows; i += (width)) {                                       \
+                size_t j = 0;                                                                 \
+                for (; j + (width) <= columns; j += (width)) {                                \
+                    level##_transpose_tile(src + i * lds + j, lds, dst + j * ldd + i, ldd);   \
+                }                                                                             \
+                scalar_transpose(                                                             \
+                    src + i * lds + j, lds, dst + j * ldd + i, ldd, (width), columns - j      \
+                );                                                                            \
+            }                                                                                 \
+            scalar_transpose(src + i * lds, lds, dst + i, ldd, rows - i, columns);            \
+        }
+
+__attribute__((target(SSE2))) static inline void
+sse2_transpose_tile(const float* src, size_t lds, float* dst, size_t ldd) {
+    __m128 r0 = _mm_loadu_ps(src + 0 * lds);
+    __m128 r1 = _mm_loadu_ps(src + 1 * lds);
+    __m128 r2 = _mm_loadu_ps(src + 2 * lds);
+    __m128 r3 = _mm_loadu_ps(src + 3 * lds);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst + 0 * ldd, r0);
+    _mm_storeu_ps(dst + 1 * ldd, r1);
+    _mm_storeu_ps(dst + 2 * ldd, r2);
+    _mm_storeu_ps(dst + 3 * ldd, r3);
+}
+
+// 8 x 8 in three rounds: interleave pairs of rows, then pairs of pairs, then swap 128-bit halves
+__attribute__((target(AVX2))) static inline void
+avx2_transpose_tile(const float* src, size_t lds, float* dst, size_t ldd) {
+    __m256 r[8], t[8];
+
+    for (size_t i = 0; i < 8; i++) {
+        r[i] = _mm256_loadu_ps(src + i * lds);
+    }
+
+    for (size_t i = 0; i < 8; i += 2) {
+        t[i]     = _mm256_unpacklo_ps(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+
+    for (size_t i = 0; i < 8; i += 4) {
+        r[i]     = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        _mm256_storeu_ps(dst + i * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+        _mm256_storeu_ps(dst + (i + 4) * ldd, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+}
+
+SIMD_TRANSPOSE(sse2, SSE2, 4)
+SIMD_TRANSPOSE(avx2, AVX2, 8)
+
+// Plain stores up to the first 16-byte boundary of dst, then whole vectors past the caches
+__attribute__((target(SSE2))) static void sse2_stream(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i < n && 0 != ((uintptr_t) (dst + i) & 15); i++) {
+        dst[i] = src[i];
+    }
+    for (; i + 4 <= n; i += 4) {
+        _mm_stream_ps(dst + i, _mm_loadu_ps(src + i));
+    }
+    for (; i < n; i++) {
+        dst[i] = src[i];
+    }
+}
+
+#endif // SIMD_X86
+
+// Dispatch
+
+typedef struct {
+    simd_reduction_t sum;
+    simd_reduction_t sum_squares;
+    simd_reduction_t dot;
+    simd_reduction_t distance_squared;
+    simd_coordinate_t polar_to_cartesian;
+    simd_coordinate_t cartesian_to_polar;
+    simd_transpose_t  transpose;
+    simd_stream_t     stream;
+} simd_kernels_t;
+
+static const simd_kernels_t simd_kernel_table[SIMD_MAX] = {
+    [SIMD_SCALAR] = {
+        scalar_sum,
+        scalar_sum_squares,
+        scalar_dot,
+        scalar_distance_squared,
+        scalar_polar_to_cartesian,
+        scalar_cartesian_to_polar,
+        scalar_transpose,
+        scalar_stream,
+    },
+#if SIMD_X86
+    [SIMD_SSE2] = {
+        sse2_sum,
+        sse2_sum_squares,
+        sse2_dot,
+        sse2_distance_squared,
+        scalar_polar_to_cartesian,
+        scalar_cartesian_to_polar,
+        sse2_transpose,
+        sse2_stream,
+    },
+    [SIMD_AVX2] = {
+        avx2_sum,
+        avx2_sum_squares,
+        avx2_dot,
+        avx2_distance_squared,
+        avx2_polar_to_cartesian,
+        avx2_cartesian_to_polar,
+        avx2_transpose,
+        sse2_stream,
+    },
+    [SIMD_AVX512] = {
+        avx512_sum,
+        avx512_sum_squares,
+        avx512_dot,
+        avx512_distance_squared,
+        avx2_polar_to_cartesian,
+        avx2_cartesian_to_polar,
+        avx2_transpose,
+        sse2_stream,
+    },
+#endif
+};
+
+static simd_level_t          simd_level   = SIMD_SCALAR;
+static const simd_kernels_t* simd_kernels = &simd_kernel_table[SIMD_SCALAR];
+
+simd_level_t simd_detect(void) {
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+simd_level_t simd_get_level(void) {
+    return simd_level;
+}
+
+simd_level_t simd_set_level(simd_level_t level) {
+    simd_level_t detected = simd_detect();
+    if (level > detected || level >= SIMD_MAX) {
+        level = detected;
+    }
+
+    simd_level   = level;
+    simd_kernels = &simd_kernel_table[level];
+
+    return level;
+}
+
+const char* simd_level_name(simd_level_t level) {
+    switch (level) {
+        case SIMD_SCALAR:
+            return "scalar";
+        case SIMD_SSE2:
+            return "sse2";
+        case SIMD_AVX2:
+            return "avx2";
+        case SIMD_AVX512:
+            return "avx512";
+        default:
+            return "unknown";
+    }
+}
+
+// Select the widest supported kernels once, before main() runs
+__attribute__((constructor)) static void simd_initialize(void) {
+    simd_set_level(SIMD_MAX);
+}
+
+// Reductions
+float simd_sum(const float* x, size_t n) {
+    return simd_kernels->sum(x, x, n);
+}
+
+float simd_sum_squares(const float* x, size_t n) {
+    return simd_kernels->sum_squares(x, x, n);
+}
+
+float simd_dot(const float* a, const float* b, size_t n) {
+    return simd_kernels->dot(a, b, n);
+}
+
+float simd_distance_squared(const float* a, const float* b, size_t n) {
+    return simd_kernels->distance_squared(a, b, n);
+}
+
+// Coordinate conversions
+void simd_polar_to_cartesian(
+    const float* radii, const float* angles, float* xs, float* ys, size_t n
+) {
+    simd_kernels->polar_to_cartesian(radii, angles, xs, ys, n);
+}
+
+void simd_cartesian_to_polar(
+    const float* xs, const float* ys, float* radii, float* angles, size_t n
+) {
+    simd_kernels->cartesian_to_polar(xs, ys, radii, angles, n);
+}
+
+// Matrix kernels
+void simd_transpose(
+    const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns
+) {
+    simd_kernels->transpose(src, lds, dst, ldd, rows, columns);
+}
+
+void simd_stream(float* dst, const float* src, size_t n) {
+    simd_kernels->stream(dst, src, n);
+}
+
+void simd_stream_fence(void) {
+#if SIMD_X86
+    // Streaming stores are weakly ordered; order them before every store that follows
+    _mm_sfence();
+#endif
+}
@@ -0,0 +1,142 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file simd.h
+ *
+ * @brief Runtime-dispatched SIMD kernels for float arrays
+ *
+ * The kernels are compiled for SSE2, AVX2 and AVX-512 alongside a portable fallback. The widest
+ * instruction set supported by the running CPU is detected with CPUID once at startup, so a single
+ * binary runs on every x86-64 machine and uses the best kernel available. Non-x86 targets always
+ * use the portable kernels.
+ *
+ * All reductions use several independent accumulators to hide floating-point add latency, so their
+ * results may differ from a serial left-to-right sum in the last bits.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Instruction set levels, ordered from narrowest to widest
+ */
+typedef enum {
+    SIMD_SCALAR, /**< Portable C kernels */
+    SIMD_SSE2,   /**< 128-bit SSE2 kernels */
+    SIMD_AVX2,   /**< 256-bit AVX2 + FMA kernels */
+    SIMD_AVX512, /**< 512-bit AVX-512F kernels */
+    SIMD_MAX     /**< Number of instruction set levels */
+} simd_level_t;
+
+/**
+ * @brief Return the widest instruction set level supported by the running CPU
+ */
+simd_level_t simd_detect(void);
+
+/**
+ * @brief Return the instruction set level currently used by the kernels
+ */
+simd_level_t simd_get_level(void);
+
+/**
+ * @brief Force the kernels to a given instruction set level
+ *
+ * Requests wider than the detected level are clamped to it. Intended for benchmarking and
+ * debugging; the level is selected automatically at startup.
+ *
+ * @param level Requested instruction set level
+ * @return The level actually selected
+ */
+simd_level_t simd_set_level(simd_level_t level);
+
+/**
+ * @brief Return a human readable name for an instruction set level
+ */
+const char* simd_level_name(simd_level_t level);
+
+// Reductions
+
+/**
+ * @brief Sum of the elements of x
+ */
+float simd_sum(const float* x, size_t n);
+
+/**
+ * @brief Sum of the squared elements of x
+ */
+float simd_sum_squares(const float* x, size_t n);
+
+/**
+ * @brief Dot product of a and b
+ */
+float simd_dot(const float* a, const float* b, size_t n);
+
+/**
+ * @brief Sum of the squared differences of a and b
+ */
+float simd_distance_squared(const float* a, const float* b, size_t n);
+
+// Coordinate conversions
+
+/**
+ * @brief Convert arrays of polar coordinates to cartesian coordinates with polynomial sin/cos
+ *
+ * x[i] = r[i] cos θ[i] and y[i] = r[i] sin θ[i]. The polynomial path covers |θ| ≤ 4e4, with a
+ * maximum absolute error of sin and cos of 1e-7 for |θ| ≤ 1000 and below 5e-7 up to 4e4. Larger
+ * angles, ±∞ and NaN are passed to libm sinf/cosf one element at a time, so they stay correct but
+ * run much slower.
+ */
+void simd_polar_to_cartesian(
+    const float* radii, const float* angles, float* xs, float* ys, size_t n
+);
+
+/**
+ * @brief Convert arrays of cartesian coordinates to polar coordinates with a polynomial atan2
+ *
+ * r[i] = √(x[i]² + y[i]²) and θ[i] = atan2(y[i], x[i]) in [-π, π]. The maximum absolute error of θ
+ * is 3e-7 radians, including the signed zero and axis cases handled by atan2f.
+ */
+void simd_cartesian_to_polar(
+    const float* xs, const float* ys, float* radii, float* angles, size_t n
+);
+
+// Matrix kernels
+
+/**
+ * @brief Transpose a rows x columns block: dst[j * ldd + i] = src[i * lds + j]
+ *
+ * Full 4 x 4 (SSE2) or 8 x 8 (AVX2 and wider) tiles are transposed in registers. The block is
+ * walked tile by tile in one pass, so it should be small enough for src and dst to stay in the L1
+ * cache; larger matrices are split into such blocks by matrix_transpose_into(). src and dst must
+ * not overlap.
+ *
+ * @param lds Floats between consecutive rows of src
+ * @param ldd Floats between consecutive rows of dst
+ */
+void simd_transpose(
+    const float* src, size_t lds, float* dst, size_t ldd, size_t rows, size_t columns
+);
+
+/**
+ * @brief Copy n floats with non-temporal stores that bypass the caches
+ *
+ * Meant for output that will not be read again soon and is larger than the caches. Writing it
+ * directly saves the read-for-ownership of every destination line and leaves the caches to the
+ * input. Call simd_stream_fence() after the last copy, before the data is shared with another
+ * thread. Without SIMD this is memcpy().
+ */
+void simd_stream(float* dst, const float* src, size_t n);
+
+/**
+ * @brief Order the preceding simd_stream() stores before any later store
+ */
+void simd_stream_fence(void);
+
+#endif // SIMD_H
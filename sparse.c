@@ -0,0 +1,378 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file sparse.c
+ *
+ * @brief Compressed sparse row (CSR) matrices for data that is mostly zeros
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "sparse.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alignment in bytes of the header and each array
+#define SPARSE_ALIGNMENT 64
+
+// Parts of a parallel multiply per thread, and at most in total
+#define SPARSE_PARTS_PER_THREAD 4
+#define SPARSE_MAX_PARTS        256
+
+static pool_t* sparse_pool = NULL;
+
+void sparse_set_pool(pool_t* pool) {
+    sparse_pool = pool;
+}
+
+pool_t* sparse_get_pool(void) {
+    return sparse_pool;
+}
+
+static size_t sparse_round_up(size_t bytes) {
+    return (bytes + SPARSE_ALIGNMENT - 1) / SPARSE_ALIGNMENT * SPARSE_ALIGNMENT;
+}
+
+// Life-cycle operations
+
+sparse_t* sparse_create(size_t rows, size_t columns, size_t nonzeros) {
+    if (columns > UINT32_MAX) {
+        fprintf(stderr, "Sparse matrices hold at most %u columns, not %zu.\n", UINT32_MAX, columns);
+        return NULL;
+    }
+
+    if (rows >= SIZE_MAX / sizeof(size_t) - 1 || nonzeros > SIZE_MAX / 16) {
+        fprintf(stderr, "Sparse matrix with %zu rows, %zu nonzeros is too large.\n", rows, nonzeros);
+        return NULL;
+    }
+
+    // Header, offsets, indices and values, each starting on its own cache line
+    const size_t header  = sparse_round_up(sizeof(sparse_t));
+    const size_t offsets = sparse_round_up((rows + 1) * sizeof(size_t));
+    const size_t indices = sparse_round_up(nonzeros * sizeof(uint32_t));
+    const size_t values  = sparse_round_up(nonzeros * sizeof(float));
+    const size_t size    = header + offsets + indices + values;
+
+    unsigned char* block = (unsigned char*) aligned_alloc(SPARSE_ALIGNMENT, size);
+    if (NULL == block) {
+        fprintf(stderr, "Failed to allocate %zu bytes to sparse_t.\n", size);
+        return NULL;
+    }
+
+    sparse_t* sparse       = (sparse_t*) block;
+    sparse->row_offsets    = (size_t*) (block + header);
+    sparse->column_indices = (uint32_t*) (block + header + offsets);
+    sparse->values         = (float*) (block + header + offsets + indices);
+    sparse->rows           = rows;
+    sparse->columns        = columns;
+    sparse->nonzeros       = nonzeros;
+
+    memset(sparse->row_offsets, 0, (rows + 1) * sizeof(size_t));
+
+    return sparse;
+}
+
+void sparse_free(sparse_t* sparse) {
+    free(sparse); // the header owns the block holding every array
+}
+
+sparse_t* sparse_from_matrix(const matrix_t* matrix, float tolerance) {
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    // Count first so the arrays are allocated once at their final size
+    size_t nonzeros = 0;
+    for (size_t row = 0; row < matrix->rows; row++) {
+        const float* elements = matrix_row(matrix, row);
+        for (size_t column = 0; column < matrix->columns; column++) {
+            nonzeros += fabsf(elements[column]) > tolerance;
+        }
+    }
+
+    sparse_t* sparse = sparse_create(matrix->rows, matrix->columns, nonzeros);
+    if (NULL == sparse) {
+        return NULL;
+    }
+
+    size_t k = 0;
+    for (size_t row = 0; row < matrix->rows; row++) {
+        const float* elements = matrix_row(matrix, row);
+        for (size_t column = 0; column < matrix->columns; column++) {
+            if (fabsf(elements[column]) > tolerance) {
+                sparse->column_indices[k] = (uint32_t) column;
+                sparse->values[k]         = elements[column];
+                k++;
+            }
+        }
+        sparse->row_offsets[row + 1] = k;
+    }
+
+    return sparse;
+}
+
+matrix_t* sparse_to_matrix(const sparse_t* sparse) {
+    if (NULL == sparse) {
+        return NULL;
+    }
+
+    matrix_t* matrix = matrix_create(sparse->columns, sparse->rows);
+    if (NULL == matrix) {
+        return NULL;
+    }
+
+    for (size_t row = 0; row < sparse->rows; row++) {
+        float* elements = matrix_row(matrix, row);
+        for (size_t k = sparse->row_offsets[row]; k < sparse->row_offsets[row + 1]; k++) {
+            elements[sparse->column_indices[k]] = sparse->values[k];
+        }
+    }
+
+    return matrix;
+}
+
+// Building from triplets
+
+sparse_builder_t* sparse_builder_create(size_t rows, size_t columns) {
+    if (columns > UINT32_MAX) {
+        fprintf(stderr, "Sparse matrices hold at most %u columns, not %zu.\n", UINT32_MAX, columns);
+        return NULL;
+    }
+
+    sparse_builder_t* builder = (sparse_builder_t*) calloc(1, sizeof(sparse_builder_t));
+    if (NULL == builder) {
+        fprintf(stderr, "Failed to allocate %zu bytes to sparse_builder_t.\n", sizeof(*builder));
+        return NULL;
+    }
+
+    builder->rows    = rows;
+    builder->columns = columns;
+
+    return builder;
+}
+
+void sparse_builder_free(sparse_builder_t* builder) {
+    if (NULL == builder) {
+        return;
+    }
+
+    free(builder->entries);
+    free(builder);
+}
+
+bool sparse_builder_add(sparse_builder_t* builder, size_t row, size_t column, float value) {
+    if (NULL == builder) {
+        return false;
+    }
+
+    if (row >= builder->rows || column >= builder->columns) {
+        fprintf(
+            stderr,
+            "Position (%zu, %zu) is outside a %zux%zu sparse matrix.\n",
+            row,
+            column,
+            builder->rows,
+            builder->columns
+        );
+        return false;
+    }
+
+    // Grow geometrically so repeated adds are amortized O(1)
+    if (builder->count == builder->capacity) {
+        size_t          capacity = builder->capacity ? builder->capacity * 2 : 64;
+        sparse_entry_t* entries
+            = (sparse_entry_t*) realloc(builder->entries, capacity * sizeof(sparse_entry_t));
+        if (NULL == entries) {
+            fprintf(stderr, "Failed to grow the sparse builder to %zu entries.\n", capacity);
+            return false;
+        }
+        builder->entries  = entries;
+        builder->capacity = capacity;
+    }
+
+    builder->entries[builder->count++] = (sparse_entry_t) {row, column, value};
+
+    return true;
+}
+
+static int sparse_entry_compare(const void* a, const void* b) {
+    const sparse_entry_t* x = (const sparse_entry_t*) a;
+    const sparse_entry_t* y = (const sparse_entry_t*) b;
+
+    if (x->row != y->row) {
+        return x->row < y->row ? -1 : 1;
+    }
+    if (x->column != y->column) {
+        return x->column < y->column ? -1 : 1;
+    }
+    return 0;
+}
+
+sparse_t* sparse_builder_build(const sparse_builder_t* builder) {
+    if (NULL == builder) {
+        return NULL;
+    }
+
+    // Sort a copy so the builder can keep growing
+    sparse_entry_t* sorted = NULL;
+    if (builder->count > 0) {
+        sorted = (sparse_entry_t*) malloc(builder->count * sizeof(sparse_entry_t));
+        if (NULL == sorted) {
+            fprintf(stderr, "Failed to allocate %zu entries to sort.\n", builder->count);
+            return NULL;
+        }
+        memcpy(sorted, builder->entries, builder->count * sizeof(sparse_entry_t));
+        qsort(sorted, builder->count, sizeof(sparse_entry_t), sparse_entry_compare);
+    }
+
+    // Triplets at the same position collapse into one nonzero
+    size_t nonzeros = 0;
+    for (size_t i = 0; i < builder->count; i++) {
+        nonzeros += 0 == i || 0 != sparse_entry_compare(&sorted[i - 1], &sorted[i]);
+    }
+
+    sparse_t* sparse = sparse_create(builder->rows, builder->columns, nonzeros);
+    if (NULL == sparse) {
+        free(sorted);
+        return NULL;
+    }
+
+    size_t k = 0;
+    for (size_t i = 0; i < builder->count; i++) {
+        if (i > 0 && 0 == sparse_entry_compare(&sorted[i - 1], &sorted[i])) {
+            sparse->values[k - 1] += sorted[i].value;
+            continue;
+        }
+        sparse->column_indices[k] = (uint32_t) sorted[i].column;
+        sparse->values[k]         = sorted[i].value;
+        sparse->row_offsets[sorted[i].row + 1]++;
+        k++;
+    }
+
+    // Per-row counts to offsets
+    for (size_t row = 0; row < sparse->rows; row++) {
+        sparse->row_offsets[row + 1] += sparse->row_offsets[row];
+    }
+
+    free(sorted);
+    return sparse;
+}
+
+// Arithmetic operations
+
+// y[row] = A[row] · x for the rows [begin, end)
+static void
+sparse_multiply_rows(const sparse_t* sparse, const float* x, float* y, size_t begin, size_t end) {
+    const size_t*   offsets = sparse->row_offsets;
+    const uint32_t* columns = sparse->column_indices;
+    const float*    values  = sparse->values;
+
+    for (size_t row = begin; row < end; row++) {
+        float sum = 0.0f;
+        for (size_t k = offsets[row]; k < offsets[row + 1]; k++) {
+            sum += values[k] * x[columns[k]];
+        }
+        y[row] = sum;
+    }
+}
+
+typedef struct {
+    const sparse_t* sparse;
+    const float*    x;
+    float*          y;
+    size_t          bounds[SPARSE_MAX_PARTS + 1]; ///< First row of every part, then rows.
+} sparse_multiply_job_t;
+
+static void sparse_multiply_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    sparse_multiply_job_t* job = (sparse_multiply_job_t*) context;
+    for (size_t part = begin; part < end; part++) {
+        const size_t first = job->bounds[part], last = job->bounds[part + 1];
+        sparse_multiply_rows(job->sparse, job->x, job->y, first, last);
+    }
+}
+
+// First row whose nonzeros start at or after target
+static size_t sparse_row_at(const sparse_t* sparse, size_t target) {
+    size_t low = 0, high = sparse->rows;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (sparse->row_offsets[middle] < target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+vector_t* sparse_multiply_vector_into(vector_t* dst, const sparse_t* sparse, const vector_t* x) {
+    if (NULL == dst || NULL == sparse || NULL == x) {
+        return NULL;
+    }
+
+    if (x->dimensions != sparse->columns || dst->dimensions != sparse->rows) {
+        fprintf(
+            stderr,
+            "Cannot multiply a %zux%zu sparse matrix by a vector of dimension %zu into a vector of "
+            "dimension %zu.\n",
+            sparse->rows,
+            sparse->columns,
+            x->dimensions,
+            dst->dimensions
+        );
+        return NULL;
+    }
+
+    if (dst->elements < x->elements + x->dimensions
+        && x->elements < dst->elements + dst->dimensions) {
+        fprintf(stderr, "A sparse product cannot overwrite the vector it multiplies.\n");
+        return NULL;
+    }
+
+    const size_t threads = pool_threads(sparse_pool);
+    if (threads < 2 || sparse->nonzeros < SPARSE_PARALLEL_THRESHOLD) {
+        sparse_multiply_rows(sparse, x->elements, dst->elements, 0, sparse->rows);
+        return dst;
+    }
+
+    // Split the rows into parts holding about the same number of nonzeros
+    size_t parts = threads * SPARSE_PARTS_PER_THREAD;
+    parts        = parts < SPARSE_MAX_PARTS ? parts : SPARSE_MAX_PARTS;
+
+    sparse_multiply_job_t job = {sparse, x->elements, dst->elements, {0}};
+    for (size_t part = 1; part < parts; part++) {
+        job.bounds[part] = sparse_row_at(sparse, sparse->nonzeros / parts * part);
+    }
+    job.bounds[parts] = sparse->rows;
+
+    pool_for(sparse_pool, parts, 1, sparse_multiply_task, &job);
+
+    return dst;
+}
+
+vector_t* sparse_multiply_vector(const sparse_t* sparse, const vector_t* x) {
+    if (NULL == sparse || NULL == x) {
+        return NULL;
+    }
+
+    vector_t* product = vector_create(sparse->rows);
+    if (NULL == product) {
+        return NULL;
+    }
+
+    if (NULL == sparse_multiply_vector_into(product, sparse, x)) {
+        vector_free(product);
+        return NULL;
+    }
+
+    return product;
+}
@@ -0,0 +1,193 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file sparse.h
+ *
+ * @brief Compressed sparse row (CSR) matrices for data that is mostly zeros
+ *
+ * A sparse_t stores only the nonzero elements of a matrix, row by row: the values and their
+ * column indices in two parallel arrays, and for every row the offset of its first nonzero. A
+ * matrix that is 99% zeros takes about 1% of the memory of a matrix_t, and multiplying it by a
+ * vector touches only the nonzeros.
+ *
+ * A sparse_t is built either from a dense matrix_t or from (row, column, value) triplets collected
+ * in any order by a sparse_builder_t. Once built it is immutable.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "matrix.h"
+#include "pool.h"
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Structures
+
+/**
+ * @brief A rows x columns matrix in compressed sparse row format.
+ *
+ * The nonzeros of row r are values[row_offsets[r]] to values[row_offsets[r + 1] - 1], and their
+ * columns are the matching entries of column_indices, in increasing order. Column indices are 32
+ * bits wide to halve the index traffic of a multiply, so a matrix has at most UINT32_MAX columns.
+ * The header and the three arrays share a single allocation.
+ *
+ * @param row_offsets    rows + 1 offsets into values; the last one is nonzeros.
+ * @param column_indices The column of every nonzero.
+ * @param values         The value of every nonzero.
+ * @param rows           The number of rows of the matrix.
+ * @param columns        The number of columns of the matrix.
+ * @param nonzeros       The number of stored elements.
+ */
+typedef struct {
+    size_t*   row_offsets;    ///< rows + 1 offsets into values; the last one is nonzeros.
+    uint32_t* column_indices; ///< The column of every nonzero.
+    float*    values;         ///< The value of every nonzero.
+    size_t    rows;           ///< The number of rows of the matrix.
+    size_t    columns;        ///< The number of columns of the matrix.
+    size_t    nonzeros;       ///< The number of stored elements.
+} sparse_t;
+
+/**
+ * @brief One (row, column, value) triplet of a sparse matrix under construction.
+ */
+typedef struct {
+    size_t row;    ///< The row of the element.
+    size_t column; ///< The column of the element.
+    float  value;  ///< The value of the element.
+} sparse_entry_t;
+
+/**
+ * @brief Collects triplets in coordinate (COO) format and compresses them into a sparse_t.
+ *
+ * @param entries  The triplets added so far, in insertion order.
+ * @param count    The number of triplets added so far.
+ * @param capacity The number of triplets entries can hold before it must grow.
+ * @param rows     The number of rows of the matrix being built.
+ * @param columns  The number of columns of the matrix being built.
+ */
+typedef struct {
+    sparse_entry_t* entries;  ///< The triplets added so far, in insertion order.
+    size_t          count;    ///< The number of triplets added so far.
+    size_t          capacity; ///< The number of triplets entries can hold before it must grow.
+    size_t          rows;     ///< The number of rows of the matrix being built.
+    size_t          columns;  ///< The number of columns of the matrix being built.
+} sparse_builder_t;
+
+// Parallel execution
+
+/**
+ * @brief Multiplies by matrices with at least this many nonzeros run on the pool, if one is set.
+ */
+#define SPARSE_PARALLEL_THRESHOLD (1 << 16)
+
+/**
+ * @brief Set the pool used to parallelize sparse matrix-vector multiplies.
+ *
+ * The rows are split into a few parts per thread, each holding about the same number of nonzeros,
+ * so rows of very different lengths still balance. Each row is summed by exactly one thread in the
+ * same order as the serial code, so results are bit-identical for any thread count.
+ *
+ * @param pool Pool to use, or NULL to run serially (the default)
+ */
+void sparse_set_pool(pool_t* pool);
+
+/**
+ * @brief Return the pool used to parallelize sparse matrix-vector multiplies, or NULL.
+ */
+pool_t* sparse_get_pool(void);
+
+// Life-cycle operations
+
+/**
+ * @brief Create a sparse matrix with room for nonzeros elements, all rows empty.
+ *
+ * Meant for code that fills the arrays directly; the builder and sparse_from_matrix() are easier.
+ *
+ * @return Pointer to the new matrix, or NULL if allocation fails or columns exceeds UINT32_MAX.
+ */
+sparse_t* sparse_create(size_t rows, size_t columns, size_t nonzeros);
+
+/**
+ * @brief Free a sparse matrix. Safely handles NULL pointers.
+ */
+void sparse_free(sparse_t* sparse);
+
+/**
+ * @brief Compress a dense matrix, keeping the elements whose magnitude exceeds tolerance.
+ *
+ * @param matrix Dense matrix or view
+ * @param tolerance Largest magnitude treated as zero; 0 keeps every element that is not 0
+ * @return Pointer to the new sparse matrix or NULL on failure.
+ */
+sparse_t* sparse_from_matrix(const matrix_t* matrix, float tolerance);
+
+/**
+ * @brief Expand a sparse matrix into a new dense matrix.
+ *
+ * @return Pointer to the new matrix or NULL if allocation fails.
+ */
+matrix_t* sparse_to_matrix(const sparse_t* sparse);
+
+// Building from triplets
+
+/**
+ * @brief Create an empty builder for a rows x columns matrix.
+ *
+ * @return Pointer to the new builder or NULL on failure.
+ */
+sparse_builder_t* sparse_builder_create(size_t rows, size_t columns);
+
+/**
+ * @brief Free a builder and its triplets. Safely handles NULL pointers.
+ */
+void sparse_builder_free(sparse_builder_t* builder);
+
+/**
+ * @brief Add value at (row, column). Triplets may come in any order.
+ *
+ * The triplet array grows geometrically, so adding is amortized O(1).
+ *
+ * @return true on success, false if the position is out of range or the array cannot grow.
+ */
+bool sparse_builder_add(sparse_builder_t* builder, size_t row, size_t column, float value);
+
+/**
+ * @brief Compress the triplets into a new sparse matrix.
+ *
+ * Triplets are sorted by row and column, and triplets at the same position are summed. Explicitly
+ * added zeros are kept. The builder is left unchanged, so more triplets can be added and the
+ * matrix built again.
+ *
+ * @return Pointer to the new sparse matrix or NULL on failure.
+ */
+sparse_t* sparse_builder_build(const sparse_builder_t* builder);
+
+// Arithmetic operations
+
+/**
+ * @brief Multiply a sparse matrix by a vector into an existing vector, dst = A x.
+ *
+ * @param dst Destination with sparse->rows dimensions; must not overlap x.
+ * @param sparse Matrix A.
+ * @param x Vector with sparse->columns dimensions.
+ * @return dst on success, NULL if the dimensions do not match or dst overlaps x.
+ */
+vector_t* sparse_multiply_vector_into(vector_t* dst, const sparse_t* sparse, const vector_t* x);
+
+/**
+ * @brief Multiply a sparse matrix by a vector, returning A x as a new vector.
+ *
+ * @return Pointer to the new vector or NULL on failure.
+ */
+vector_t* sparse_multiply_vector(const sparse_t* sparse, const vector_t* x);
+
+#endif // SPARSE_H
@@ -0,0 +1,257 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file stats.c
+ *
+ * @brief Streaming statistics over float data
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#include "stats.h"
+#include "simd.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Leaves of the pairwise recursion are summed by the SIMD kernels
+#define STATS_PAIRWISE_BLOCK 256
+
+// Independent lanes for the compensated and deviation loops
+#define STATS_LANES 8
+
+// Summation
+static float stats_pairwise_sum(const float* x, size_t n) {
+    if (n <= STATS_PAIRWISE_BLOCK) {
+        return simd_sum(x, n);
+    }
+
+    // Split on a block boundary so every leaf except the last is a full block
+    size_t half = (n / 2 + STATS_PAIRWISE_BLOCK - 1) / STATS_PAIRWISE_BLOCK * STATS_PAIRWISE_BLOCK;
+    return stats_pairwise_sum(x, half) + stats_pairwise_sum(x + half, n - half);
+}
+
+static float stats_kahan_sum(const float* x, size_t n) {
+    float  sum[STATS_LANES]          = {0};
+    float  compensation[STATS_LANES] = {0};
+    size_t i                         = 0;
+
+    for (; i + STATS_LANES <= n; i += STATS_LANES) {
+        for (size_t l = 0; l < STATS_LANES; l++) {
+            float y         = x[i + l] - compensation[l];
+            float t         = sum[l] + y;
+            compensation[l] = (t - sum[l]) - y;
+            sum[l]          = t;
+        }
+    }
+
+    for (; i < n; i++) {
+        float y         = x[i] - compensation[0];
+        float t         = sum[0] + y;
+        compensation[0] = (t - sum[0]) - y;
+        sum[0]          = t;
+    }
+
+    // Combine the lanes with one more compensated pass
+    float total = 0.0f, c = 0.0f;
+    for (size_t l = 0; l < STATS_LANES; l++) {
+        float y = (sum[l] - compensation[l]) - c;
+        float t = total + y;
+        c       = (t - total) - y;
+        total   = t;
+    }
+
+    return total;
+}
+
+float stats_sum(const float* x, size_t n, summation_t summation) {
+    switch (summation) {
+        case SUMMATION_PAIRWISE:
+            return stats_pairwise_sum(x, n);
+        case SUMMATION_KAHAN:
+            return stats_kahan_sum(x, n);
+        case SUMMATION_NAIVE:
+        default:
+            return simd_sum(x, n);
+    }
+}
+
+// The moving average is a serial recurrence by definition
+float stats_ema(const float* x, size_t n, float alpha) {
+    if (NULL == x || 0 == n) {
+        return NAN;
+    }
+
+    float ema = x[0];
+    for (size_t i = 1; i < n; i++) {
+        ema += alpha * (x[i] - ema); // m(n + 1) = (1 - α) m(n) + α x(n + 1)
+    }
+    return ema;
+}
+
+// Chunk reduction
+
+// Sum of squared deviations from mean, accumulated in lanes per block and pairwise across blocks
+static float stats_deviation_sum(const float* x, size_t n, float mean) {
+    if (n > STATS_PAIRWISE_BLOCK) {
+        size_t half
+            = (n / 2 + STATS_PAIRWISE_BLOCK - 1) / STATS_PAIRWISE_BLOCK * STATS_PAIRWISE_BLOCK;
+        return stats_deviation_sum(x, half, mean) + stats_deviation_sum(x + half, n - half, mean);
+    }
+
+    float  lanes[STATS_LANES] = {0};
+    size_t i                  = 0;
+    for (; i + STATS_LANES <= n; i += STATS_LANES) {
+        for (size_t l = 0; l < STATS_LANES; l++) {
+            float d   = x[i + l] - mean;
+            lanes[l] += d * d;
+        }
+    }
+    for (; i < n; i++) {
+        float d   = x[i] - mean;
+        lanes[0] += d * d;
+    }
+
+    float sum = 0.0f;
+    for (size_t l = 0; l < STATS_LANES; l++) {
+        sum += lanes[l];
+    }
+    return sum;
+}
+
+static void stats_extrema(const float* x, size_t n, float* min, float* max) {
+    float  lo[STATS_LANES], hi[STATS_LANES];
+    size_t i = 0;
+
+    for (size_t l = 0; l < STATS_LANES; l++) {
+        lo[l] = *min;
+        hi[l] = *max;
+    }
+
+    // Comparisons with NaN are false, so NaN samples never replace an extremum
+    for (; i + STATS_LANES <= n; i += STATS_LANES) {
+        for (size_t l = 0; l < STATS_LANES; l++) {
+            lo[l] = x[i + l] < lo[l] ? x[i + l] : lo[l];
+            hi[l] = x[i + l] > hi[l] ? x[i + l] : hi[l];
+        }
+    }
+    for (; i < n; i++) {
+        lo[0] = x[i] < lo[0] ? x[i] : lo[0];
+        hi[0] = x[i] > hi[0] ? x[i] : hi[0];
+    }
+
+    for (size_t l = 0; l < STATS_LANES; l++) {
+        *min = lo[l] < *min ? lo[l] : *min;
+        *max = hi[l] > *max ? hi[l] : *max;
+    }
+}
+
+// Stats lifecycle
+void stats_init(stats_t* stats, float alpha, summation_t summation) {
+    if (NULL == stats) {
+        return;
+    }
+
+    if (!(alpha > 0.0f && alpha <= 1.0f)) {
+        fprintf(stderr, "Smoothing factor %f is outside (0, 1]; using 1.\n", alpha);
+        alpha = 1.0f;
+    }
+
+    stats->count     = 0;
+    stats->mean      = 0.0f;
+    stats->m2        = 0.0f;
+    stats->min       = INFINITY;
+    stats->max       = -INFINITY;
+    stats->ema       = NAN;
+    stats->first     = NAN;
+    stats->alpha     = alpha;
+    stats->summation = summation;
+}
+
+// Stats operations
+void stats_push(stats_t* stats, float x) {
+    if (0 == stats->count) {
+        stats->first = x;
+        stats->ema   = x;
+    } else {
+        stats->ema += stats->alpha * (x - stats->ema); // m(n + 1) = (1 - α) m(n) + α x(n + 1)
+    }
+
+    // Welford's update
+    stats->count++;
+    float delta  = x - stats->mean;
+    stats->mean += delta / (float) stats->count;
+    stats->m2   += delta * (x - stats->mean);
+
+    stats->min = x < stats->min ? x : stats->min;
+    stats->max = x > stats->max ? x : stats->max;
+}
+
+void stats_update(stats_t* stats, const float* x, size_t n) {
+    if (NULL == stats || NULL == x || 0 == n) {
+        return;
+    }
+
+    // Reduce the chunk on its own, then fold it in as a second accumulator
+    stats_t chunk = *stats;
+    chunk.count   = n;
+    chunk.mean    = stats_sum(x, n, stats->summation) / (float) n;
+    chunk.m2      = stats_deviation_sum(x, n, chunk.mean);
+    chunk.min     = INFINITY;
+    chunk.max     = -INFINITY;
+    chunk.first   = x[0];
+    chunk.ema     = stats_ema(x, n, stats->alpha);
+    stats_extrema(x, n, &chunk.min, &chunk.max);
+
+    stats_merge(stats, &chunk);
+}
+
+void stats_merge(stats_t* dst, const stats_t* src) {
+    if (NULL == dst || NULL == src || 0 == src->count) {
+        return;
+    }
+
+    if (0 == dst->count) {
+        summation_t summation = dst->summation;
+        *dst                  = *src;
+        dst->summation        = summation;
+        return;
+    }
+
+    // Chan et al. parallel combination of count, mean and m2
+    float  delta = src->mean - dst->mean;
+    size_t count = dst->count + src->count;
+    float  ratio = (float) src->count / (float) count;
+
+    dst->m2   += src->m2 + delta * delta * (float) dst->count * ratio;
+    dst->mean += delta * ratio;
+    dst->count = count;
+
+    dst->min = src->min < dst->min ? src->min : dst->min;
+    dst->max = src->max > dst->max ? src->max : dst->max;
+
+    // src's average was seeded with its first sample instead of continuing from dst's average:
+    // ema(dst then src) = ema(src) + (1 - α)^n(src) (ema(dst) - first(src))
+    float decay = powf(1.0f - dst->alpha, (float) src->count);
+    dst->ema    = src->ema + decay * (dst->ema - src->first);
+}
+
+float stats_variance(const stats_t* stats) {
+    if (NULL == stats || 0 == stats->count) {
+        return NAN;
+    }
+
+    return stats->m2 / (float) stats->count;
+}
+
+float stats_sample_variance(const stats_t* stats) {
+    if (NULL == stats || stats->count < 2) {
+        return NAN;
+    }
+
+    return stats->m2 / (float) (stats->count - 1);
+}
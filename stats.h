@@ -0,0 +1,136 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file stats.h
+ *
+ * @brief Streaming statistics over float data
+ *
+ * A stats_t accumulates count, mean, variance, minimum, maximum and an exponential moving average
+ * (the low-pass filter) over data fed in arbitrary chunks. Accumulators filled independently, for
+ * example one per thread, can be merged into one result afterwards.
+ *
+ * Everything is accumulated in single precision. Accuracy comes from the algorithms instead of
+ * wider types: chunk sums use compensated (Kahan) or pairwise summation, and chunks are combined
+ * with the parallel form of Welford's update (Chan et al.), so the mean of 10^8 floats stays
+ * accurate without switching to double.
+ *
+ * References:
+ * https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+ * https://www.cs.princeton.edu/courses/archive/fall08/cos436/Duda/PR_learn/mean.htm
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdlib.h>
+
+/**
+ * @brief Summation algorithms, from fastest to most accurate.
+ */
+typedef enum {
+    SUMMATION_NAIVE,    /**< SIMD multi-accumulator sum; error grows with n */
+    SUMMATION_PAIRWISE, /**< Pairwise sum over SIMD blocks; error grows with log n */
+    SUMMATION_KAHAN,    /**< Compensated sum; error independent of n */
+} summation_t;
+
+/**
+ * @brief Running statistics over a stream of floats.
+ *
+ * @param count     Number of samples seen.
+ * @param mean      Running mean.
+ * @param m2        Sum of squared deviations from the mean; variance is m2 / count.
+ * @param min       Smallest sample seen (NaN samples are ignored).
+ * @param max       Largest sample seen (NaN samples are ignored).
+ * @param ema       Exponential moving average, m(n + 1) = (1 - α) m(n) + α x(n + 1).
+ * @param first     First sample seen; required to merge moving averages.
+ * @param alpha     Smoothing factor α of the moving average, in (0, 1].
+ * @param summation Summation algorithm used for each chunk.
+ */
+typedef struct {
+    size_t      count;     ///< Number of samples seen.
+    float       mean;      ///< Running mean.
+    float       m2;        ///< Sum of squared deviations from the mean.
+    float       min;       ///< Smallest sample seen.
+    float       max;       ///< Largest sample seen.
+    float       ema;       ///< Exponential moving average.
+    float       first;     ///< First sample seen.
+    float       alpha;     ///< Smoothing factor of the moving average.
+    summation_t summation; ///< Summation algorithm used for each chunk.
+} stats_t;
+
+/**
+ * @brief Sum an array of floats with the given summation algorithm.
+ *
+ * @param x Input array
+ * @param n Number of elements
+ * @param summation Summation algorithm
+ * @return The sum of the elements
+ */
+float stats_sum(const float* x, size_t n, summation_t summation);
+
+/**
+ * @brief Exponential moving average of an array of floats, seeded with its first element.
+ *
+ * Reads the array once, for callers that need the average without the rest of a stats_t.
+ *
+ * @param x Input array
+ * @param n Number of elements
+ * @param alpha Smoothing factor of the moving average, in (0, 1]
+ * @return The moving average after the last element, or NaN if there are none
+ */
+float stats_ema(const float* x, size_t n, float alpha);
+
+/**
+ * @brief Reset a stats accumulator.
+ *
+ * @param stats Accumulator to reset
+ * @param alpha Smoothing factor of the moving average, in (0, 1]
+ * @param summation Summation algorithm used for each chunk
+ */
+void stats_init(stats_t* stats, float alpha, summation_t summation);
+
+/**
+ * @brief Feed one sample into the accumulator.
+ */
+void stats_push(stats_t* stats, float x);
+
+/**
+ * @brief Feed a chunk of samples into the accumulator.
+ *
+ * The chunk is reduced on its own, with the configured summation algorithm and a second pass for
+ * the squared deviations while it is still in cache, and then merged into the running totals.
+ *
+ * @param stats Accumulator to update
+ * @param x Chunk of samples
+ * @param n Number of samples in the chunk
+ */
+void stats_update(stats_t* stats, const float* x, size_t n);
+
+/**
+ * @brief Merge the accumulator src into dst.
+ *
+ * Count, mean, variance, minimum and maximum do not depend on the merge order. The moving average
+ * does: the result equals feeding dst's samples followed by src's samples. Both accumulators must
+ * use the same alpha.
+ *
+ * @param dst Accumulator receiving the merged result
+ * @param src Accumulator to merge; left unchanged
+ */
+void stats_merge(stats_t* dst, const stats_t* src);
+
+/**
+ * @brief Population variance of the samples seen, or NaN if there are none.
+ */
+float stats_variance(const stats_t* stats);
+
+/**
+ * @brief Sample (Bessel-corrected) variance of the samples seen, or NaN if there are fewer than 2.
+ */
+float stats_sample_variance(const stats_t* stats);
+
+#endif // STATS_H
@@ -12,80 +12,2347 @@
  */
 
 #include "tensor.h"
+#include "simd.h"
+#include "stats.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #define TENSOR_X86 1
+    #include <immintrin.h>
+#else
+    #define TENSOR_X86 0
+#endif
+
+// Bytes reserved for the header, so the data after it starts on a TENSOR_ALIGNMENT boundary
+#define TENSOR_HEADER_SIZE \
+    ((sizeof(tensor_t) + TENSOR_ALIGNMENT - 1) / TENSOR_ALIGNMENT * TENSOR_ALIGNMENT)
+
+// The header of a mapped tensor also remembers the mapping, so tensor_free() can release it
+typedef struct {
+    tensor_t tensor; ///< First, so the tensor's address is the mapping's.
+    void*    address;
+    size_t   length;
+} tensor_mapping_t;
+
+// Tensor lifecycle
+tensor_t* tensor_create_nd(size_t rank, const size_t* shape) {
+    if (rank > TENSOR_MAX_RANK) {
+        fprintf(stderr, "Tensors have at most %d dimensions, not %zu.\n", TENSOR_MAX_RANK, rank);
+        return NULL;
+    }
+
+    // Count the elements, guarding the byte size against overflow
+    const size_t limit = (SIZE_MAX - TENSOR_HEADER_SIZE - TENSOR_ALIGNMENT) / sizeof(float);
+    size_t       size  = 1;
+    for (size_t i = 0; i < rank; i++) {
+        if (0 != shape[i] && size > limit / shape[i]) {
+            fprintf(stderr, "Tensor of rank %zu is too large.\n", rank);
+            return NULL;
+        }
+        size *= shape[i];
+    }
+
+    // Pad the data to the alignment too, as aligned_alloc requires
+    const size_t bytes = size * sizeof(float);
+    const size_t total
+        = TENSOR_HEADER_SIZE + (bytes + TENSOR_ALIGNMENT - 1) / TENSOR_ALIGNMENT * TENSOR_ALIGNMENT;
+
+    unsigned char* block = (unsigned char*) aligned_alloc(TENSOR_ALIGNMENT, total);
+    if (NULL == block) {
+        fprintf(stderr, "Failed to allocate %zu bytes to tensor_t.\n", total);
+        return NULL;
+    }
+
+    tensor_t* tensor  = (tensor_t*) block;
+    tensor->data      = (float*) (block + TENSOR_HEADER_SIZE);
+    tensor->elements  = NULL;
+    tensor->rank      = rank;
+    tensor->size      = size;
+    tensor->storage   = TENSOR_STORAGE_ALIGNED;
+    tensor->read_only = false;
+
+    // Row-major strides: each is the product of the extents after it
+    ptrdiff_t stride = 1;
+    for (size_t i = TENSOR_MAX_RANK; i-- > 0;) {
+        tensor->shape[i]   = i < rank ? shape[i] : 1;
+        tensor->strides[i] = i < rank ? stride : 0;
+        stride            *= i < rank ? (ptrdiff_t) shape[i] : 1;
+    }
+
+    memset(tensor->data, 0, bytes);
+
+    return tensor;
+}
 
-// Tensor operations
 tensor_t* tensor_create(size_t columns, size_t rows, size_t layers) {
-    // Allocate memory for the tensor structure
-    tensor_t* tensor = (tensor_t*) malloc(sizeof(tensor_t));
+    const size_t shape[3] = {layers, rows, columns};
+    return tensor_create_nd(3, shape);
+}
+
+void tensor_free(tensor_t* tensor) {
     if (NULL == tensor) {
-        fprintf(stderr, "Failed to allocate memory for tensor_t.\n");
-        return NULL;
+        return;
     }
 
-    tensor->columns = columns;
-    tensor->rows    = rows;
-    tensor->layers  = layers;
+    // The element view is always a separate heap allocation owned by this header
+    free(tensor->elements);
+    tensor->elements = NULL;
 
-    // Allocate memory for the 3D array
-    tensor->elements = (float***) malloc(layers * sizeof(float**));
-    if (NULL == tensor->elements) {
-        fprintf(stderr, "Failed to allocate memory for tensor elements.\n");
+    // A view's header is a value owned by the caller; aligned data lives in the header's block
+    if (TENSOR_STORAGE_MAPPED == tensor->storage) {
+        tensor_mapping_t* mapping = (tensor_mapping_t*) tensor;
+        munmap(mapping->address, mapping->length);
+        free(mapping);
+    } else if (TENSOR_STORAGE_VIEW != tensor->storage) {
         free(tensor);
+    }
+}
+
+float*** tensor_element_view(tensor_t* tensor) {
+    if (NULL == tensor) {
         return NULL;
     }
 
-    for (size_t d = 0; d < layers; ++d) {
-        tensor->elements[d] = (float**) malloc(rows * sizeof(float*));
-        if (NULL == tensor->elements[d]) {
-            fprintf(stderr, "Failed to allocate memory for tensor rows.\n");
-            for (size_t i = 0; i < d; ++i) {
-                free(tensor->elements[i]);
-            }
-            free(tensor->elements);
-            free(tensor);
+    if (NULL != tensor->elements) {
+        return tensor->elements;
+    }
+
+    if (3 != tensor->rank || (tensor->shape[2] > 1 && 1 != tensor->strides[2])) {
+        fprintf(stderr, "Only rank-3 tensors with unit column stride have an element view.\n");
+        return NULL;
+    }
+
+    // Layer pointers first, then every row pointer, in one allocation
+    const size_t layers = tensor->shape[0];
+    const size_t rows   = tensor->shape[1];
+    const size_t count  = layers + layers * rows;
+
+    float*** elements = (float***) malloc((count ? count : 1) * sizeof(float*));
+    if (NULL == elements) {
+        fprintf(stderr, "Failed to allocate %zu element view pointers.\n", count);
+        return NULL;
+    }
+
+    float** row_pointers = (float**) (elements + layers);
+    for (size_t layer = 0; layer < layers; layer++) {
+        elements[layer] = row_pointers + layer * rows;
+        for (size_t row = 0; row < rows; row++) {
+            elements[layer][row] = tensor_at3(tensor, layer, row, 0);
+        }
+    }
+
+    tensor->elements = elements;
+    return elements;
+}
+
+bool tensor_is_contiguous(const tensor_t* tensor) {
+    if (NULL == tensor) {
+        return false;
+    }
+
+    if (0 == tensor->size) {
+        return true;
+    }
+
+    // Extents of 1 may have any stride, since they are never stepped over
+    ptrdiff_t expected = 1;
+    for (size_t i = tensor->rank; i-- > 0;) {
+        if (1 != tensor->shape[i] && expected != tensor->strides[i]) {
+            return false;
+        }
+        expected *= (ptrdiff_t) tensor->shape[i];
+    }
+
+    return true;
+}
+
+// Parallel execution
+static pool_t* tensor_pool = NULL;
+
+void tensor_set_pool(pool_t* pool) {
+    tensor_pool = pool;
+}
+
+pool_t* tensor_get_pool(void) {
+    return tensor_pool;
+}
+
+// Iteration spaces
+
+/**
+ * Operations walk the index space of up to TENSOR_OPERANDS tensors at once. Dimensions of extent 1
+ * are dropped, and a dimension is merged into the one before it when, in every operand, stepping
+ * over the whole dimension lands exactly on the next element of the previous one. Contiguous
+ * tensors of any shape then become one long run, and the innermost dimension left is the one
+ * kernels loop over.
+ */
+#define TENSOR_OPERANDS 3
+
+typedef struct {
+    size_t    rank;
+    size_t    shape[TENSOR_MAX_RANK];
+    ptrdiff_t strides[TENSOR_OPERANDS][TENSOR_MAX_RANK]; ///< Per operand, 0 where it repeats.
+} tensor_space_t;
+
+// Append a dimension, outermost first; operands not taking part pass a stride of 0
+static void tensor_space_push(tensor_space_t* space, size_t extent, const ptrdiff_t* strides) {
+    if (1 == extent) {
+        return;
+    }
+
+    const size_t last  = space->rank - 1;
+    bool         merge = space->rank > 0;
+    for (size_t k = 0; k < TENSOR_OPERANDS && merge; k++) {
+        merge = space->strides[k][last] == strides[k] * (ptrdiff_t) extent;
+    }
+
+    const size_t i = merge ? last : space->rank++;
+    space->shape[i] = merge ? space->shape[i] * extent : extent;
+    for (size_t k = 0; k < TENSOR_OPERANDS; k++) {
+        space->strides[k][i] = strides[k];
+    }
+}
+
+// A space left without dimensions is a single element, visited as one run of length 1
+static void tensor_space_finish(tensor_space_t* space) {
+    if (0 == space->rank) {
+        space->rank     = 1;
+        space->shape[0] = 1;
+        for (size_t k = 0; k < TENSOR_OPERANDS; k++) {
+            space->strides[k][0] = 0;
+        }
+    }
+}
+
+// A position in the row-major order of a space, with the offset of that element in each operand
+typedef struct {
+    size_t    index[TENSOR_MAX_RANK];
+    ptrdiff_t offsets[TENSOR_OPERANDS];
+    size_t    position;
+} tensor_cursor_t;
+
+static void tensor_cursor_start(tensor_cursor_t* cursor, const tensor_space_t* space, size_t at) {
+    size_t rest      = at;
+    cursor->position = at;
+    memset(cursor->offsets, 0, sizeof(cursor->offsets));
+
+    // An extent of 0 only occurs in spaces that are never stepped into
+    for (size_t i = space->rank; i-- > 0;) {
+        const size_t extent  = space->shape[i] > 0 ? space->shape[i] : 1;
+        cursor->index[i]     = rest % extent;
+        rest                /= extent;
+        for (size_t k = 0; k < TENSOR_OPERANDS; k++) {
+            cursor->offsets[k] += (ptrdiff_t) cursor->index[i] * space->strides[k][i];
+        }
+    }
+}
+
+// Length of the run from the cursor to the end of the innermost dimension, or to end if sooner
+static size_t
+tensor_cursor_run(const tensor_cursor_t* cursor, const tensor_space_t* space, size_t end) {
+    const size_t left = space->shape[space->rank - 1] - cursor->index[space->rank - 1];
+    return left < end - cursor->position ? left : end - cursor->position;
+}
+
+// Step over a run, carrying into the outer dimensions and rewinding each one that wrapped around
+static void tensor_cursor_advance(tensor_cursor_t* cursor, const tensor_space_t* space, size_t n) {
+    const size_t last    = space->rank - 1;
+    cursor->position    += n;
+    cursor->index[last] += n;
+    for (size_t k = 0; k < TENSOR_OPERANDS; k++) {
+        cursor->offsets[k] += (ptrdiff_t) n * space->strides[k][last];
+    }
+
+    for (size_t i = last; i > 0 && cursor->index[i] == space->shape[i]; i--) {
+        cursor->index[i] = 0;
+        cursor->index[i - 1]++;
+        for (size_t k = 0; k < TENSOR_OPERANDS; k++) {
+            cursor->offsets[k] += space->strides[k][i - 1]
+                                  - (ptrdiff_t) space->shape[i] * space->strides[k][i];
+        }
+    }
+}
+
+// Element-wise kernels
+
+// One innermost run of n elements; each pointer steps by its own stride, 0 for a repeated operand
+typedef void (*tensor_kernel_t)(
+    float* dst, ptrdiff_t sd, const float* a, ptrdiff_t sa, const float* b, ptrdiff_t sb, size_t n
+);
+
+// The unit-stride and repeated-operand loops are kept apart so the compiler vectorizes each one
+#define TENSOR_KERNEL(attribute, name, expression)                                \
+    attribute static void name(                                                   \
+        float*       dst,                                                         \
+        ptrdiff_t    sd,                                                          \
+        const float* a,                                                           \
+        ptrdiff_t    sa,                                                          \
+        const float* b,                                                           \
+        ptrdiff_t    sb,                                                          \
+        size_t       n                                                            \
+    ) {                                                                           \
+        if (1 == sd && 1 == sa && 1 == sb) {                                      \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const float x = a[i], y = b[i];                                   \
+                dst[i]        = (expression);                                     \
+            }                                                                     \
+        } else if (1 == sd && 1 == sa && 0 == sb) {                               \
+            const float y = *b;                                                   \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const float x = a[i];                                             \
+                dst[i]        = (expression);                                     \
+            }                                                                     \
+        } else if (1 == sd && 0 == sa && 1 == sb) {                               \
+            const float x = *a;                                                   \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const float y = b[i];                                             \
+                dst[i]        = (expression);                                     \
+            }                                                                     \
+        } else {                                                                  \
+            for (size_t i = 0; i < n; i++) {                                      \
+                const float x = a[(ptrdiff_t) i * sa], y = b[(ptrdiff_t) i * sb]; \
+                dst[(ptrdiff_t) i * sd] = (expression);                           \
+            }                                                                     \
+        }                                                                         \
+    }
+
+// One kernel per tensor_operator_t, in the same order
+#define TENSOR_KERNELS(attribute, prefix)                     \
+    TENSOR_KERNEL(attribute, prefix##_add, x + y)             \
+    TENSOR_KERNEL(attribute, prefix##_subtract, x - y)        \
+    TENSOR_KERNEL(attribute, prefix##_multiply, x * y)        \
+    TENSOR_KERNEL(attribute, prefix##_divide, x / y)          \
+    TENSOR_KERNEL(attribute, prefix##_maximum, x > y ? x : y) \
+    TENSOR_KERNEL(attribute, prefix##_minimum, x < y ? x : y) \
+    static const tensor_kernel_t prefix##_kernels[] = {       \
+        prefix##_add,                                         \
+        prefix##_subtract,                                    \
+        prefix##_multiply,                                    \
+        prefix##_divide,                                      \
+        prefix##_maximum,                                     \
+        prefix##_minimum,                                     \
+    };
+
+// Portable kernels, vectorized for the baseline instruction set
+TENSOR_KERNELS(, scalar)
+
+#if TENSOR_X86
+// The same loops built for 256-bit registers; only called after simd_get_level() checks for AVX2
+TENSOR_KERNELS(__attribute__((target("avx2"))), avx2)
+#endif
+
+static tensor_kernel_t tensor_kernel(tensor_operator_t operation) {
+#if TENSOR_X86
+    if (simd_get_level() >= SIMD_AVX2) {
+        return avx2_kernels[operation];
+    }
+#endif
+    return scalar_kernels[operation];
+}
+
+// Element-wise operations
+
+// One element-wise operation over the iteration space of dst, a and b, in that operand order
+typedef struct {
+    float*          dst;
+    const float*    a;
+    const float*    b;
+    tensor_kernel_t kernel;
+    tensor_space_t  space;
+} tensor_elementwise_job_t;
+
+static void tensor_elementwise_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const tensor_elementwise_job_t* job   = (const tensor_elementwise_job_t*) context;
+    const tensor_space_t*           space = &job->space;
+    const size_t                    last  = space->rank - 1;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+        job->kernel(
+            job->dst + cursor.offsets[0],
+            space->strides[0][last],
+            job->a + cursor.offsets[1],
+            space->strides[1][last],
+            job->b + cursor.offsets[2],
+            space->strides[2][last],
+            n
+        );
+        tensor_cursor_advance(&cursor, space, n);
+    }
+}
+
+static void tensor_print_shape(const tensor_t* tensor) {
+    fprintf(stderr, "{");
+    for (size_t i = 0; i < tensor->rank; i++) {
+        fprintf(stderr, "%s%zu", i > 0 ? ", " : "", tensor->shape[i]);
+    }
+    fprintf(stderr, "}");
+}
+
+// A loaded tensor, and every view of it, reads a PROT_READ mapping, so writing its elements would
+// fault
+static bool tensor_writable(const tensor_t* dst) {
+    if (dst->read_only) {
+        fprintf(stderr, "Destination tensor is a read-only mapping of a file.\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool tensor_broadcast_shape(const tensor_t* a, const tensor_t* b, size_t* rank, size_t* shape) {
+    const size_t broadcast = a->rank > b->rank ? a->rank : b->rank;
+
+    for (size_t i = 0; i < broadcast; i++) {
+        // Right-align both shapes; missing leading dimensions have extent 1
+        const size_t ea = i + a->rank >= broadcast ? a->shape[i + a->rank - broadcast] : 1;
+        const size_t eb = i + b->rank >= broadcast ? b->shape[i + b->rank - broadcast] : 1;
+
+        if (ea != eb && 1 != ea && 1 != eb) {
+            fprintf(stderr, "Tensor shapes do not broadcast. Cannot combine shapes ");
+            tensor_print_shape(a);
+            fprintf(stderr, " and ");
+            tensor_print_shape(b);
+            fprintf(stderr, ".\n");
+            return false;
+        }
+
+        shape[i] = 1 == ea ? eb : ea;
+    }
+
+    *rank = broadcast;
+    return true;
+}
+
+// The lowest and one past the highest element a tensor can touch, for overlap checks
+static void tensor_span(const tensor_t* tensor, const float** low, const float** high) {
+    ptrdiff_t first = 0, last = 0;
+    for (size_t i = 0; i < tensor->rank; i++) {
+        const ptrdiff_t reach = (ptrdiff_t) (tensor->shape[i] - 1) * tensor->strides[i];
+        first                += reach < 0 ? reach : 0;
+        last                 += reach > 0 ? reach : 0;
+    }
+
+    *low  = tensor->data + first;
+    *high = tensor->data + last + 1;
+}
+
+// Broadcast strides of an operand against the rank dimensions of dst: 0 where it is repeated
+static void tensor_broadcast_strides(const tensor_t* tensor, size_t rank, ptrdiff_t* strides) {
+    for (size_t i = 0; i < rank; i++) {
+        const size_t j = i + tensor->rank - rank; // Wraps around for padded dimensions
+        strides[i]     = i + tensor->rank >= rank && tensor->shape[j] > 1 ? tensor->strides[j] : 0;
+    }
+}
+
+// An operand may share memory with dst only if every element lines up with the one it produces
+static bool tensor_overlap_is_safe(const tensor_t* dst, const tensor_t* src, const ptrdiff_t* s) {
+    const float *dst_low, *dst_high, *src_low, *src_high;
+    tensor_span(dst, &dst_low, &dst_high);
+    tensor_span(src, &src_low, &src_high);
+
+    if (dst_high <= src_low || src_high <= dst_low) {
+        return true;
+    }
+
+    if (dst->data != src->data) {
+        return false;
+    }
+
+    for (size_t i = 0; i < dst->rank; i++) {
+        if (dst->shape[i] > 1 && dst->strides[i] != s[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+tensor_t* tensor_elementwise_operation_into(
+    tensor_t* dst, const tensor_t* a, const tensor_t* b, tensor_operator_t operation
+) {
+    if (NULL == dst || NULL == a || NULL == b) {
+        return NULL;
+    }
+
+    if (!tensor_writable(dst)) {
+        return NULL;
+    }
+
+    if ((unsigned) operation > TENSOR_MINIMUM) {
+        fprintf(stderr, "Unknown tensor operation %d.\n", (int) operation);
+        return NULL;
+    }
+
+    size_t rank;
+    size_t shape[TENSOR_MAX_RANK];
+    if (!tensor_broadcast_shape(a, b, &rank, shape)) {
+        return NULL;
+    }
+
+    if (dst->rank != rank || 0 != memcmp(dst->shape, shape, rank * sizeof(size_t))) {
+        fprintf(stderr, "Destination tensor has shape ");
+        tensor_print_shape(dst);
+        fprintf(stderr, " but the operands broadcast to a shape of rank %zu.\n", rank);
+        return NULL;
+    }
+
+    if (0 == dst->size) {
+        return dst;
+    }
+
+    for (size_t i = 0; i < rank; i++) {
+        if (shape[i] > 1 && 0 == dst->strides[i]) {
+            fprintf(stderr, "Destination tensor repeats elements along dimension %zu.\n", i);
             return NULL;
         }
+    }
+
+    ptrdiff_t strides[TENSOR_OPERANDS][TENSOR_MAX_RANK];
+    memcpy(strides[0], dst->strides, rank * sizeof(ptrdiff_t));
+    tensor_broadcast_strides(a, rank, strides[1]);
+    tensor_broadcast_strides(b, rank, strides[2]);
+
+    if (!tensor_overlap_is_safe(dst, a, strides[1])
+        || !tensor_overlap_is_safe(dst, b, strides[2])) {
+        fprintf(stderr, "Destination tensor overlaps an operand with a different layout.\n");
+        return NULL;
+    }
+
+    tensor_elementwise_job_t job = {dst->data, a->data, b->data, tensor_kernel(operation), {0}};
+    for (size_t i = 0; i < rank; i++) {
+        const ptrdiff_t operands[TENSOR_OPERANDS] = {strides[0][i], strides[1][i], strides[2][i]};
+        tensor_space_push(&job.space, shape[i], operands);
+    }
+    tensor_space_finish(&job.space);
+
+    if (dst->size < TENSOR_PARALLEL_THRESHOLD) {
+        tensor_elementwise_task(&job, 0, 0, dst->size);
+    } else {
+        pool_for(tensor_pool, dst->size, TENSOR_PARALLEL_CHUNK, tensor_elementwise_task, &job);
+    }
+
+    return dst;
+}
+
+tensor_t*
+tensor_elementwise_operation(const tensor_t* a, const tensor_t* b, tensor_operator_t operation) {
+    if (NULL == a || NULL == b) {
+        return NULL;
+    }
+
+    size_t rank;
+    size_t shape[TENSOR_MAX_RANK];
+    if (!tensor_broadcast_shape(a, b, &rank, shape)) {
+        return NULL;
+    }
+
+    tensor_t* c = tensor_create_nd(rank, shape);
+    if (NULL == c) {
+        return NULL; // tensor_create_nd logs the error for us
+    }
+
+    return tensor_elementwise_operation_into(c, a, b, operation);
+}
+
+tensor_t* tensor_add(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_ADD);
+}
+
+tensor_t* tensor_subtract(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_SUBTRACT);
+}
+
+tensor_t* tensor_multiply(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_MULTIPLY);
+}
+
+tensor_t* tensor_divide(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_DIVIDE);
+}
+
+tensor_t* tensor_maximum(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_MAXIMUM);
+}
+
+tensor_t* tensor_minimum(const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation(a, b, TENSOR_MINIMUM);
+}
+
+tensor_t* tensor_add_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_ADD);
+}
+
+tensor_t* tensor_subtract_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_SUBTRACT);
+}
+
+tensor_t* tensor_multiply_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_MULTIPLY);
+}
+
+tensor_t* tensor_divide_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_DIVIDE);
+}
+
+tensor_t* tensor_maximum_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_MAXIMUM);
+}
+
+tensor_t* tensor_minimum_into(tensor_t* dst, const tensor_t* a, const tensor_t* b) {
+    return tensor_elementwise_operation_into(dst, a, b, TENSOR_MINIMUM);
+}
+
+// Views
+
+// A view of the same elements as tensor, with nothing of its own to free; a view of a mapped
+// tensor stays read-only
+static tensor_t tensor_view_of(const tensor_t* tensor) {
+    tensor_t view = *tensor;
+    view.elements = NULL;
+    view.storage  = TENSOR_STORAGE_VIEW;
+    return view;
+}
+
+// The view returned on failure: no data, rank 0 and no elements
+static tensor_t tensor_view_empty(void) {
+    tensor_t view = {0};
+    view.storage  = TENSOR_STORAGE_VIEW;
+    return view;
+}
+
+// Count the elements of a view, and restore extents of 1 and strides of 0 past its rank
+static tensor_t tensor_view_finish(tensor_t view) {
+    view.size = 1;
+    for (size_t i = 0; i < TENSOR_MAX_RANK; i++) {
+        if (i < view.rank) {
+            view.size *= view.shape[i];
+        } else {
+            view.shape[i]   = 1;
+            view.strides[i] = 0;
+        }
+    }
+    return view;
+}
+
+/**
+ * Strides that visit the elements of tensor in the same order under a new shape, as NumPy finds
+ * them without copying. The dimensions of extent 1 are dropped, then the old and the new extents
+ * are matched in groups with equal products. Each group of old dimensions must be laid out back
+ * to back, and is then split along the new extents of its group.
+ */
+static bool tensor_reshape_strides(
+    const tensor_t* tensor, size_t rank, const size_t* shape, ptrdiff_t* strides
+) {
+    size_t    old_rank = 0;
+    size_t    old_shape[TENSOR_MAX_RANK];
+    ptrdiff_t old_strides[TENSOR_MAX_RANK];
+    for (size_t i = 0; i < tensor->rank; i++) {
+        if (1 != tensor->shape[i]) {
+            old_shape[old_rank]     = tensor->shape[i];
+            old_strides[old_rank++] = tensor->strides[i];
+        }
+    }
+
+    // Both shapes multiply out to the same non-zero size, so each group closes before either ends
+    size_t oi = 0, oj = 1, ni = 0, nj = 1;
+    while (ni < rank && oi < old_rank) {
+        size_t new_product = shape[ni];
+        size_t old_product = old_shape[oi];
+        while (new_product != old_product) {
+            if (new_product < old_product) {
+                new_product *= shape[nj++];
+            } else {
+                old_product *= old_shape[oj++];
+            }
+        }
 
-        for (size_t r = 0; r < rows; ++r) {
-            tensor->elements[d][r] = (float*) calloc(columns, sizeof(float));
-            if (NULL == tensor->elements[d][r]) {
-                fprintf(stderr, "Failed to allocate memory for tensor columns.\n");
-                for (size_t j = 0; j < r; ++j) {
-                    free(tensor->elements[d][j]);
-                }
-                free(tensor->elements[d]);
-                for (size_t i = 0; i < d; ++i) {
-                    for (size_t j = 0; j < rows; ++j) {
-                        free(tensor->elements[i][j]);
-                    }
-                    free(tensor->elements[i]);
-                }
-                free(tensor->elements);
-                free(tensor);
-                return NULL;
+        for (size_t k = oi; k + 1 < oj; k++) {
+            if (old_strides[k] != (ptrdiff_t) old_shape[k + 1] * old_strides[k + 1]) {
+                return false;
             }
         }
+
+        strides[nj - 1] = old_strides[oj - 1];
+        for (size_t k = nj - 1; k > ni; k--) {
+            strides[k - 1] = strides[k] * (ptrdiff_t) shape[k];
+        }
+
+        ni = nj++;
+        oi = oj++;
+    }
+
+    // Trailing extents of 1 are never stepped over, so any stride does
+    for (; ni < rank; ni++) {
+        strides[ni] = ni > 0 ? strides[ni - 1] : 1;
+    }
+
+    return true;
+}
+
+tensor_t tensor_reshape(const tensor_t* tensor, size_t rank, const size_t* shape) {
+    if (NULL == tensor || rank > TENSOR_MAX_RANK || (rank > 0 && NULL == shape)) {
+        fprintf(stderr, "Cannot reshape to rank %zu.\n", rank);
+        return tensor_view_empty();
+    }
+
+    // The size must match exactly, without trusting a product that overflowed
+    size_t size = 1;
+    bool   fits = true, empty = false;
+    for (size_t i = 0; i < rank; i++) {
+        fits  = fits && (0 == shape[i] || size <= SIZE_MAX / shape[i]);
+        empty = empty || 0 == shape[i];
+        size *= shape[i];
+    }
+
+    if (empty ? 0 != tensor->size : !fits || size != tensor->size) {
+        fprintf(stderr, "Cannot reshape a tensor of shape ");
+        tensor_print_shape(tensor);
+        fprintf(stderr, " to a rank %zu shape of a different size.\n", rank);
+        return tensor_view_empty();
+    }
+
+    tensor_t view = tensor_view_of(tensor);
+    view.rank     = rank;
+    for (size_t i = 0; i < rank; i++) {
+        view.shape[i] = shape[i];
+    }
+
+    if (0 == tensor->size || tensor_is_contiguous(tensor)) {
+        ptrdiff_t stride = 1;
+        for (size_t i = rank; i-- > 0;) {
+            view.strides[i]  = stride;
+            stride          *= (ptrdiff_t) shape[i];
+        }
+    } else if (!tensor_reshape_strides(tensor, rank, shape, view.strides)) {
+        fprintf(stderr, "Reshaping this view needs a copy; call tensor_contiguous() first.\n");
+        return tensor_view_empty();
     }
 
-    return tensor;
+    return tensor_view_finish(view);
 }
 
-void tensor_free(tensor_t* tensor) {
-    if (NULL == tensor) {
-        return;
+tensor_t tensor_permute(const tensor_t* tensor, const size_t* axes) {
+    if (NULL == tensor || (tensor->rank > 0 && NULL == axes)) {
+        fprintf(stderr, "Cannot permute without a tensor and its axes.\n");
+        return tensor_view_empty();
     }
 
-    for (size_t d = 0; d < tensor->layers; ++d) {
-        for (size_t r = 0; r < tensor->rows; ++r) {
-            free(tensor->elements[d][r]);
+    tensor_t view = tensor_view_of(tensor);
+    unsigned seen = 0;
+    for (size_t i = 0; i < tensor->rank; i++) {
+        if (axes[i] >= tensor->rank || 0 != (seen & TENSOR_AXIS(axes[i]))) {
+            fprintf(stderr, "Axes are not a permutation of %zu dimensions.\n", tensor->rank);
+            return tensor_view_empty();
         }
-        free(tensor->elements[d]);
+        seen            |= TENSOR_AXIS(axes[i]);
+        view.shape[i]    = tensor->shape[axes[i]];
+        view.strides[i]  = tensor->strides[axes[i]];
     }
 
-    free(tensor->elements);
-    free(tensor);
+    return view;
+}
+
+tensor_t tensor_transpose(const tensor_t* tensor, size_t first, size_t second) {
+    if (NULL == tensor || first >= tensor->rank || second >= tensor->rank) {
+        fprintf(stderr, "Cannot swap axes %zu and %zu.\n", first, second);
+        return tensor_view_empty();
+    }
+
+    size_t axes[TENSOR_MAX_RANK];
+    for (size_t i = 0; i < tensor->rank; i++) {
+        axes[i] = i;
+    }
+    axes[first]  = second;
+    axes[second] = first;
+
+    return tensor_permute(tensor, axes);
+}
+
+tensor_t tensor_slice(
+    const tensor_t* tensor, size_t axis, size_t start, size_t count, ptrdiff_t step
+) {
+    if (NULL == tensor || axis >= tensor->rank || 0 == step) {
+        fprintf(stderr, "Cannot slice axis %zu with a step of %td.\n", axis, step);
+        return tensor_view_empty();
+    }
+
+    // Room left from start in the direction of step, in whole steps
+    const size_t extent   = tensor->shape[axis];
+    const size_t distance = step > 0 ? (size_t) step : (size_t) 0 - (size_t) step;
+    const size_t room     = step > 0 ? extent - 1 - start : start;
+    if (count > 0 && (start >= extent || count - 1 > room / distance)) {
+        fprintf(
+            stderr,
+            "A slice of %zu elements from %zu with a step of %td does not fit in %zu.\n",
+            count,
+            start,
+            step,
+            extent
+        );
+        return tensor_view_empty();
+    }
+
+    tensor_t view = tensor_view_of(tensor);
+    if (count > 0) {
+        view.data += (ptrdiff_t) start * tensor->strides[axis];
+    }
+    // Past one element the step is shorter than the axis, so the product cannot overflow
+    view.shape[axis]   = count;
+    view.strides[axis] = count > 1 ? tensor->strides[axis] * step : tensor->strides[axis];
+
+    return tensor_view_finish(view);
+}
+
+tensor_t tensor_squeeze(const tensor_t* tensor, unsigned axes) {
+    if (NULL == tensor) {
+        return tensor_view_empty();
+    }
+
+    if (tensor->rank < sizeof(unsigned) * 8 && 0 != axes >> tensor->rank) {
+        fprintf(stderr, "Axes mask 0x%x selects axes beyond rank %zu.\n", axes, tensor->rank);
+        return tensor_view_empty();
+    }
+
+    tensor_t view = tensor_view_of(tensor);
+    view.rank     = 0;
+    for (size_t i = 0; i < tensor->rank; i++) {
+        if (0 == (axes & TENSOR_AXIS(i))) {
+            view.shape[view.rank]     = tensor->shape[i];
+            view.strides[view.rank++] = tensor->strides[i];
+        } else if (1 != tensor->shape[i]) {
+            fprintf(stderr, "Cannot squeeze axis %zu of extent %zu.\n", i, tensor->shape[i]);
+            return tensor_view_empty();
+        }
+    }
+
+    return tensor_view_finish(view);
+}
+
+tensor_t tensor_unsqueeze(const tensor_t* tensor, size_t axis) {
+    if (NULL == tensor || axis > tensor->rank || TENSOR_MAX_RANK == tensor->rank) {
+        fprintf(stderr, "Cannot insert an axis at %zu.\n", axis);
+        return tensor_view_empty();
+    }
+
+    tensor_t view = tensor_view_of(tensor);
+    for (size_t i = tensor->rank; i > axis; i--) {
+        view.shape[i]   = tensor->shape[i - 1];
+        view.strides[i] = tensor->strides[i - 1];
+    }
+
+    // The stride stepping over the whole next dimension, so a contiguous tensor stays contiguous
+    view.shape[axis]   = 1;
+    view.strides[axis] = axis < tensor->rank
+                             ? (ptrdiff_t) tensor->shape[axis] * tensor->strides[axis]
+                             : 1;
+    view.rank++;
+
+    return tensor_view_finish(view);
+}
+
+// Copies
+
+// Side of the square tiles a transposing copy moves through the L1 cache
+#define TENSOR_COPY_BLOCK 32
+
+// Rows of tiles handed out at a time; each band is then split into blocks recursively
+#define TENSOR_COPY_BAND 256
+
+// Destinations of more bytes than this are written around the caches, as by matrix_transpose_into()
+#define TENSOR_COPY_STREAM (1 << 21)
+
+/**
+ * One copy from src to dst. Runs follow the innermost dimension of the space. Tiles pair the
+ * innermost dimension, along which dst is written, with the dimension src is closest to
+ * contiguous along, and the space holds all the other dimensions.
+ */
+typedef struct {
+    float*         dst;
+    const float*   src;
+    tensor_space_t space;     ///< dst, then src.
+    size_t         rows;      ///< Tiles: extent of the dimension src is read along.
+    size_t         columns;   ///< Tiles: extent of the innermost dimension.
+    ptrdiff_t      row[2];    ///< Tiles: strides of dst and src along rows.
+    ptrdiff_t      column[2]; ///< Tiles: strides of dst and src along columns.
+    bool           stream;    ///< Write unit-stride runs of dst with non-temporal stores.
+} tensor_copy_job_t;
+
+static void tensor_copy_runs_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const tensor_copy_job_t* job   = (const tensor_copy_job_t*) context;
+    const tensor_space_t*    space = &job->space;
+    const ptrdiff_t          ds    = space->strides[0][space->rank - 1];
+    const ptrdiff_t          ss    = space->strides[1][space->rank - 1];
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+        float*       d = job->dst + cursor.offsets[0];
+        const float* s = job->src + cursor.offsets[1];
+
+        if (1 == ds && 1 == ss && job->stream) {
+            simd_stream(d, s, n);
+        } else if (1 == ds && 1 == ss) {
+            memcpy(d, s, n * sizeof(float));
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                d[(ptrdiff_t) i * ds] = s[(ptrdiff_t) i * ss];
+            }
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+
+    if (job->stream) {
+        simd_stream_fence();
+    }
+}
+
+// Copy a rows x columns tile, reading src down its rows and writing dst along its columns
+static void tensor_copy_tile(
+    const tensor_copy_job_t* job, float* d, const float* s, size_t rows, size_t columns
+) {
+    const ptrdiff_t dr = job->row[0], sr = job->row[1];
+    const ptrdiff_t dc = job->column[0], sc = job->column[1];
+
+    // dst[r * dr + c] = src[c * sc + r] is a matrix transpose
+    if (1 == sr && 1 == dc && sc > 0 && dr > 0) {
+        if (!job->stream) {
+            simd_transpose(s, (size_t) sc, d, (size_t) dr, columns, rows);
+            return;
+        }
+
+        // Streamed, it goes through a tile in the L1 cache whose rows are then written out whole
+        _Alignas(TENSOR_ALIGNMENT) float tile[TENSOR_COPY_BLOCK * TENSOR_COPY_BLOCK];
+
+        simd_transpose(s, (size_t) sc, tile, columns, columns, rows);
+        for (size_t r = 0; r < rows; r++) {
+            simd_stream(d + (ptrdiff_t) r * dr, tile + r * columns, columns);
+        }
+        return;
+    }
+
+    for (size_t c = 0; c < columns; c++) {
+        for (size_t r = 0; r < rows; r++) {
+            d[(ptrdiff_t) r * dr + (ptrdiff_t) c * dc] = s[(ptrdiff_t) r * sr + (ptrdiff_t) c * sc];
+        }
+    }
+}
+
+// Split a block side in half, rounded up to whole tiles
+static size_t tensor_copy_half(size_t size) {
+    return (size / 2 + TENSOR_COPY_BLOCK - 1) / TENSOR_COPY_BLOCK * TENSOR_COPY_BLOCK;
+}
+
+// Copy a rows x columns block, halving the longer side until a tile remains, so that every cache
+// level works on blocks that fit it, as matrix_transpose_into() does
+static void tensor_copy_block(
+    const tensor_copy_job_t* job, float* d, const float* s, size_t rows, size_t columns
+) {
+    if (rows <= TENSOR_COPY_BLOCK && columns <= TENSOR_COPY_BLOCK) {
+        tensor_copy_tile(job, d, s, rows, columns);
+    } else if (rows >= columns) {
+        const size_t half = tensor_copy_half(rows);
+        tensor_copy_block(job, d, s, half, columns);
+        tensor_copy_block(
+            job,
+            d + (ptrdiff_t) half * job->row[0],
+            s + (ptrdiff_t) half * job->row[1],
+            rows - half,
+            columns
+        );
+    } else {
+        const size_t half = tensor_copy_half(columns);
+        tensor_copy_block(job, d, s, rows, half);
+        tensor_copy_block(
+            job,
+            d + (ptrdiff_t) half * job->column[0],
+            s + (ptrdiff_t) half * job->column[1],
+            rows,
+            columns - half
+        );
+    }
+}
+
+// Each unit is one band of TENSOR_COPY_BAND rows at one position of the space
+static void tensor_copy_tiles_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const tensor_copy_job_t* job   = (const tensor_copy_job_t*) context;
+    const size_t             bands = (job->rows + TENSOR_COPY_BAND - 1) / TENSOR_COPY_BAND;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, &job->space, begin / bands);
+
+    for (size_t unit = begin; unit < end; unit++) {
+        const size_t row = unit % bands * TENSOR_COPY_BAND;
+        if (unit > begin && 0 == row) {
+            tensor_cursor_advance(&cursor, &job->space, 1);
+        }
+
+        const size_t rows = job->rows - row < TENSOR_COPY_BAND ? job->rows - row : TENSOR_COPY_BAND;
+        tensor_copy_block(
+            job,
+            job->dst + cursor.offsets[0] + (ptrdiff_t) row * job->row[0],
+            job->src + cursor.offsets[1] + (ptrdiff_t) row * job->row[1],
+            rows,
+            job->columns
+        );
+    }
+
+    if (job->stream) {
+        simd_stream_fence();
+    }
+}
+
+tensor_t* tensor_copy_into(tensor_t* dst, const tensor_t* src) {
+    if (NULL == dst || NULL == src) {
+        return NULL;
+    }
+
+    if (!tensor_writable(dst)) {
+        return NULL;
+    }
+
+    size_t rank;
+    size_t shape[TENSOR_MAX_RANK];
+    if (!tensor_broadcast_shape(dst, src, &rank, shape)) {
+        return NULL;
+    }
+
+    if (dst->rank != rank || 0 != memcmp(dst->shape, shape, rank * sizeof(size_t))) {
+        fprintf(stderr, "Destination tensor has shape ");
+        tensor_print_shape(dst);
+        fprintf(stderr, " but the source broadcasts to a shape of rank %zu.\n", rank);
+        return NULL;
+    }
+
+    if (0 == dst->size) {
+        return dst;
+    }
+
+    for (size_t i = 0; i < rank; i++) {
+        if (shape[i] > 1 && 0 == dst->strides[i]) {
+            fprintf(stderr, "Destination tensor repeats elements along dimension %zu.\n", i);
+            return NULL;
+        }
+    }
+
+    ptrdiff_t strides[2][TENSOR_MAX_RANK];
+    memcpy(strides[0], dst->strides, rank * sizeof(ptrdiff_t));
+    tensor_broadcast_strides(src, rank, strides[1]);
+
+    if (!tensor_overlap_is_safe(dst, src, strides[1])) {
+        fprintf(stderr, "Destination tensor overlaps the source with a different layout.\n");
+        return NULL;
+    }
+
+    // Overlapping safely means every element would be copied onto itself
+    if (dst->data == src->data) {
+        return dst;
+    }
+
+    tensor_space_t space = {0};
+    for (size_t i = 0; i < rank; i++) {
+        const ptrdiff_t operands[TENSOR_OPERANDS] = {strides[0][i], strides[1][i], 0};
+        tensor_space_push(&space, shape[i], operands);
+    }
+    tensor_space_finish(&space);
+
+    // The dimension src is closest to contiguous along; a repeated one costs nothing to read
+    const size_t last = space.rank - 1;
+    size_t       axis = last;
+    for (size_t i = 0; i < last && 0 != space.strides[1][last]; i++) {
+        const ptrdiff_t stride = space.strides[1][i];
+        if (0 != stride && llabs(stride) < llabs(space.strides[1][axis])) {
+            axis = i;
+        }
+    }
+
+    tensor_copy_job_t job = {dst->data, src->data, {0}, 0, 0, {0}, {0}, false};
+    job.stream            = dst->size * sizeof(float) > TENSOR_COPY_STREAM;
+
+    if (axis == last) {
+        job.space = space;
+        if (dst->size < TENSOR_PARALLEL_THRESHOLD) {
+            tensor_copy_runs_task(&job, 0, 0, dst->size);
+        } else {
+            pool_for(tensor_pool, dst->size, TENSOR_PARALLEL_CHUNK, tensor_copy_runs_task, &job);
+        }
+        return dst;
+    }
+
+    // Tiles over the innermost dimension and axis, for every position of the others
+    job.rows      = space.shape[axis];
+    job.columns   = space.shape[last];
+    job.row[0]    = space.strides[0][axis];
+    job.row[1]    = space.strides[1][axis];
+    job.column[0] = space.strides[0][last];
+    job.column[1] = space.strides[1][last];
+    for (size_t i = 0; i < last; i++) {
+        if (i != axis) {
+            const ptrdiff_t operands[TENSOR_OPERANDS]
+                = {space.strides[0][i], space.strides[1][i], 0};
+            tensor_space_push(&job.space, space.shape[i], operands);
+        }
+    }
+    tensor_space_finish(&job.space);
+
+    const size_t bands = (job.rows + TENSOR_COPY_BAND - 1) / TENSOR_COPY_BAND;
+    const size_t units = dst->size / (job.rows * job.columns) * bands;
+    if (dst->size < TENSOR_PARALLEL_THRESHOLD) {
+        tensor_copy_tiles_task(&job, 0, 0, units);
+    } else {
+        const size_t band  = TENSOR_COPY_BAND * job.columns;
+        const size_t chunk = band < TENSOR_PARALLEL_CHUNK ? TENSOR_PARALLEL_CHUNK / band : 1;
+        pool_for(tensor_pool, units, chunk, tensor_copy_tiles_task, &job);
+    }
+
+    return dst;
+}
+
+tensor_t* tensor_contiguous(const tensor_t* tensor) {
+    if (NULL == tensor) {
+        return NULL;
+    }
+
+    tensor_t* copy = tensor_create_nd(tensor->rank, tensor->shape);
+    if (NULL == copy) {
+        return NULL; // tensor_create_nd logs the error for us
+    }
+
+    if (NULL == tensor_copy_into(copy, tensor)) {
+        tensor_free(copy);
+        return NULL;
+    }
+
+    return copy;
+}
+
+// Reduction kernels
+
+// Accumulators of the portable horizontal kernels, and results per block of the vertical ones
+#define TENSOR_REDUCE_LANES 8
+#define TENSOR_REDUCE_BLOCK 1024
+
+// Whether x takes over from max as the largest so far: a larger number, or the first NaN. The
+// operators are bitwise so the vertical kernels compile to compares and blends instead of branches.
+#define TENSOR_REDUCE_GREATER(x, max) (((x) > (max)) | (((x) != (x)) & ((max) == (max))))
+
+typedef struct {
+    float (*run_max)(const float* x, size_t n);
+    float (*run_deviations)(const float* x, size_t n, float mean);
+    void (*block_sum)(float* acc, const float* row, size_t m);
+    void (*block_deviations)(float* acc, const float* row, const float* mean, size_t m);
+    void (*block_max)(float* acc, const float* row, size_t m);
+    void (*block_argmax)(float* acc, size_t* index, const float* row, size_t k, size_t m);
+} tensor_reduce_kernels_t;
+
+// Portable horizontal kernels: one contiguous run into independent accumulators
+
+static float scalar_run_max(const float* x, size_t n) {
+    float  lanes[TENSOR_REDUCE_LANES];
+    float  max = -INFINITY;
+    size_t i   = 0;
+
+    for (size_t l = 0; l < TENSOR_REDUCE_LANES; l++) {
+        lanes[l] = -INFINITY;
+    }
+    for (; i + TENSOR_REDUCE_LANES <= n; i += TENSOR_REDUCE_LANES) {
+        for (size_t l = 0; l < TENSOR_REDUCE_LANES; l++) {
+            lanes[l] = TENSOR_REDUCE_GREATER(x[i + l], lanes[l]) ? x[i + l] : lanes[l];
+        }
+    }
+    for (size_t l = 0; l < TENSOR_REDUCE_LANES; l++) {
+        max = TENSOR_REDUCE_GREATER(lanes[l], max) ? lanes[l] : max;
+    }
+    for (; i < n; i++) {
+        max = TENSOR_REDUCE_GREATER(x[i], max) ? x[i] : max;
+    }
+
+    return max;
+}
+
+static float scalar_run_deviations(const float* x, size_t n, float mean) {
+    float  lanes[TENSOR_REDUCE_LANES] = {0};
+    float  sum                        = 0.0f;
+    size_t i                          = 0;
+
+    for (; i + TENSOR_REDUCE_LANES <= n; i += TENSOR_REDUCE_LANES) {
+        for (size_t l = 0; l < TENSOR_REDUCE_LANES; l++) {
+            const float d  = x[i + l] - mean;
+            lanes[l]      += d * d;
+        }
+    }
+    for (; i < n; i++) {
+        const float d  = x[i] - mean;
+        sum           += d * d;
+    }
+    for (size_t l = 0; l < TENSOR_REDUCE_LANES; l++) {
+        sum += lanes[l];
+    }
+
+    return sum;
+}
+
+// Vertical kernels fold one row into m accumulators; plain loops the compiler vectorizes
+#define TENSOR_BLOCK_KERNELS(attribute, prefix)                                        \
+    attribute static void prefix##_block_sum(float* acc, const float* row, size_t m) { \
+        for (size_t j = 0; j < m; j++) {                                               \
+            acc[j] += row[j];                                                          \
+        }                                                                              \
+    }                                                                                  \
+                                                                                       \
+    attribute static void prefix##_block_deviations(                                   \
+        float* acc, const float* row, const float* mean, size_t m                      \
+    ) {                                                                                \
+        for (size_t j = 0; j < m; j++) {                                               \
+            const float d  = row[j] - mean[j];                                         \
+            acc[j]        += d * d;                                                    \
+        }                                                                              \
+    }                                                                                  \
+                                                                                       \
+    attribute static void prefix##_block_max(float* acc, const float* row, size_t m) { \
+        for (size_t j = 0; j < m; j++) {                                               \
+            const int take = TENSOR_REDUCE_GREATER(row[j], acc[j]);                    \
+            acc[j]         = take ? row[j] : acc[j];                                   \
+        }                                                                              \
+    }                                                                                  \
+                                                                                       \
+    attribute static void prefix##_block_argmax(                                       \
+        float* acc, size_t* index, const float* row, size_t k, size_t m                \
+    ) {                                                                                \
+        for (size_t j = 0; j < m; j++) {                                               \
+            const int take = TENSOR_REDUCE_GREATER(row[j], acc[j]);                    \
+            acc[j]         = take ? row[j] : acc[j];                                   \
+            index[j]       = take ? k : index[j];                                      \
+        }                                                                              \
+    }
+
+TENSOR_BLOCK_KERNELS(, scalar)
+
+static const tensor_reduce_kernels_t scalar_reduce_kernels = {
+    scalar_run_max,
+    scalar_run_deviations,
+    scalar_block_sum,
+    scalar_block_deviations,
+    scalar_block_max,
+    scalar_block_argmax,
+};
+
+#if TENSOR_X86
+
+// SIMD horizontal kernels: four accumulators of one register each, then a scalar tail. maxps
+// returns its second operand when either is NaN, so the running maxima skip NaNs and a separate
+// mask remembers whether any was seen.
+
+__attribute__((target("sse2"))) static float sse2_hmax(__m128 v) {
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse2"))) static float sse2_hsum(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+__attribute__((target("sse2"))) static float sse2_run_max(const float* x, size_t n) {
+    __m128 m0 = _mm_set1_ps(-INFINITY), m1 = m0, m2 = m0, m3 = m0;
+    __m128 nan = _mm_setzero_ps();
+    size_t i   = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128 x0 = _mm_loadu_ps(x + i), x1 = _mm_loadu_ps(x + i + 4);
+        const __m128 x2 = _mm_loadu_ps(x + i + 8), x3 = _mm_loadu_ps(x + i + 12);
+        m0              = _mm_max_ps(x0, m0);
+        m1              = _mm_max_ps(x1, m1);
+        m2              = _mm_max_ps(x2, m2);
+        m3              = _mm_max_ps(x3, m3);
+        nan             = _mm_or_ps(nan, _mm_cmpunord_ps(x0, x1));
+        nan             = _mm_or_ps(nan, _mm_cmpunord_ps(x2, x3));
+    }
+
+    float max  = sse2_hmax(_mm_max_ps(_mm_max_ps(m0, m1), _mm_max_ps(m2, m3)));
+    bool  seen = 0 != _mm_movemask_ps(nan);
+    for (; i < n; i++) {
+        max   = x[i] > max ? x[i] : max;
+        seen |= x[i] != x[i];
+    }
+
+    return seen ? NAN : max;
+}
+
+__attribute__((target("sse2"))) static float
+sse2_run_deviations(const float* x, size_t n, float mean) {
+    const __m128 center = _mm_set1_ps(mean);
+    __m128       s0 = _mm_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t       i  = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m128 d0 = _mm_sub_ps(_mm_loadu_ps(x + i), center);
+        const __m128 d1 = _mm_sub_ps(_mm_loadu_ps(x + i + 4), center);
+        const __m128 d2 = _mm_sub_ps(_mm_loadu_ps(x + i + 8), center);
+        const __m128 d3 = _mm_sub_ps(_mm_loadu_ps(x + i + 12), center);
+        s0              = _mm_add_ps(s0, _mm_mul_ps(d0, d0));
+        s1              = _mm_add_ps(s1, _mm_mul_ps(d1, d1));
+        s2              = _mm_add_ps(s2, _mm_mul_ps(d2, d2));
+        s3              = _mm_add_ps(s3, _mm_mul_ps(d3, d3));
+    }
+
+    float sum = sse2_hsum(_mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3)));
+    for (; i < n; i++) {
+        const float d  = x[i] - mean;
+        sum           += d * d;
+    }
+
+    return sum;
+}
+
+__attribute__((target("avx2,fma"))) static float avx2_run_max(const float* x, size_t n) {
+    __m256 m0 = _mm256_set1_ps(-INFINITY), m1 = m0, m2 = m0, m3 = m0;
+    __m256 nan = _mm256_setzero_ps();
+    size_t i   = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256 x0 = _mm256_loadu_ps(x + i), x1 = _mm256_loadu_ps(x + i + 8);
+        const __m256 x2 = _mm256_loadu_ps(x + i + 16), x3 = _mm256_loadu_ps(x + i + 24);
+        m0              = _mm256_max_ps(x0, m0);
+        m1              = _mm256_max_ps(x1, m1);
+        m2              = _mm256_max_ps(x2, m2);
+        m3              = _mm256_max_ps(x3, m3);
+        nan             = _mm256_or_ps(nan, _mm256_cmp_ps(x0, x1, _CMP_UNORD_Q));
+        nan             = _mm256_or_ps(nan, _mm256_cmp_ps(x2, x3, _CMP_UNORD_Q));
+    }
+
+    const __m256 m    = _mm256_max_ps(_mm256_max_ps(m0, m1), _mm256_max_ps(m2, m3));
+    const __m128 half = _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+    float        max  = sse2_hmax(half);
+    bool         seen = 0 != _mm256_movemask_ps(nan);
+    for (; i < n; i++) {
+        max   = x[i] > max ? x[i] : max;
+        seen |= x[i] != x[i];
+    }
+
+    return seen ? NAN : max;
+}
+
+__attribute__((target("avx2,fma"))) static float
+avx2_run_deviations(const float* x, size_t n, float mean) {
+    const __m256 center = _mm256_set1_ps(mean);
+    __m256       s0 = _mm256_setzero_ps(), s1 = s0, s2 = s0, s3 = s0;
+    size_t       i  = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        const __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), center);
+        const __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), center);
+        const __m256 d2 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 16), center);
+        const __m256 d3 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 24), center);
+        s0              = _mm256_fmadd_ps(d0, d0, s0);
+        s1              = _mm256_fmadd_ps(d1, d1, s1);
+        s2              = _mm256_fmadd_ps(d2, d2, s2);
+        s3              = _mm256_fmadd_ps(d3, d3, s3);
+    }
+
+    const __m256 s    = _mm256_add_ps(_mm256_add_ps(s0, s1), _mm256_add_ps(s2, s3));
+    const __m128 half = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+    float        sum  = sse2_hsum(half);
+    for (; i < n; i++) {
+        const float d  = x[i] - mean;
+        sum           += d * d;
+    }
+
+    return sum;
+}
+
+TENSOR_BLOCK_KERNELS(__attribute__((target("avx2"))), avx2)
+
+static const tensor_reduce_kernels_t sse2_reduce_kernels = {
+    sse2_run_max,
+    sse2_run_deviations,
+    scalar_block_sum,
+    scalar_block_deviations,
+    scalar_block_max,
+    scalar_block_argmax,
+};
+
+static const tensor_reduce_kernels_t avx2_reduce_kernels = {
+    avx2_run_max,
+    avx2_run_deviations,
+    avx2_block_sum,
+    avx2_block_deviations,
+    avx2_block_max,
+    avx2_block_argmax,
+};
+
+#endif // TENSOR_X86
+
+static const tensor_reduce_kernels_t* tensor_reduce_kernels(void) {
+#if TENSOR_X86
+    if (simd_get_level() >= SIMD_AVX2) {
+        return &avx2_reduce_kernels;
+    }
+    if (simd_get_level() >= SIMD_SSE2) {
+        return &sse2_reduce_kernels;
+    }
+#endif
+    return &scalar_reduce_kernels;
+}
+
+// Reductions
+
+// argmax shares the reduction engine, writing indices instead of values
+#define TENSOR_REDUCE_ARGMAX ((tensor_reduction_t) (TENSOR_REDUCE_VARIANCE + 1))
+
+// One reduction of the reduced space of src for every element of the kept space
+typedef struct {
+    const float*                   src;
+    float*                         dst;       ///< Reduced values, or NULL for argmax.
+    size_t*                        indices;   ///< Positions of the maxima for argmax, or NULL.
+    tensor_reduction_t             reduction;
+    const tensor_reduce_kernels_t* kernels;
+    size_t                         count;     ///< Elements reduced into each result.
+    tensor_space_t                 outputs;   ///< Kept dimensions; strides into src, then dst.
+    tensor_space_t                 reduced;   ///< Reduced dimensions; strides into src.
+} tensor_reduce_job_t;
+
+// The reduction of a range of elements, in a form that merges with the next range
+typedef struct {
+    size_t count;
+    float  sum;
+    float  mean;
+    float  m2;     ///< Sum of squared deviations from the mean.
+    float  max;
+    size_t argmax; ///< Position of max in the reduced space.
+} tensor_partial_t;
+
+typedef enum {
+    TENSOR_RUN_SUM,
+    TENSOR_RUN_DEVIATIONS,
+    TENSOR_RUN_MAX,
+} tensor_run_t;
+
+// A run with a stride other than 1 has no SIMD kernel; it is only met by views and awkward axes
+static float
+tensor_run_strided(const float* x, ptrdiff_t stride, size_t n, tensor_run_t run, float mean) {
+    float result = TENSOR_RUN_MAX == run ? -INFINITY : 0.0f;
+
+    for (size_t i = 0; i < n; i++) {
+        const float v = x[(ptrdiff_t) i * stride];
+        if (TENSOR_RUN_SUM == run) {
+            result += v;
+        } else if (TENSOR_RUN_DEVIATIONS == run) {
+            result += (v - mean) * (v - mean);
+        } else {
+            result = TENSOR_REDUCE_GREATER(v, result) ? v : result;
+        }
+    }
+
+    return result;
+}
+
+// Reduce the elements [begin, end) of the reduced space at base, one run at a time
+static float tensor_reduce_runs(
+    const tensor_reduce_job_t* job,
+    const float*               base,
+    size_t                     begin,
+    size_t                     end,
+    tensor_run_t               run,
+    float                      mean
+) {
+    const tensor_space_t* space  = &job->reduced;
+    const ptrdiff_t       stride = space->strides[0][space->rank - 1];
+    float                 result = TENSOR_RUN_MAX == run ? -INFINITY : 0.0f;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+        const float* x = base + cursor.offsets[0];
+
+        float value;
+        if (1 != stride) {
+            value = tensor_run_strided(x, stride, n, run, mean);
+        } else if (TENSOR_RUN_SUM == run) {
+            value = stats_sum(x, n, SUMMATION_PAIRWISE);
+        } else if (TENSOR_RUN_DEVIATIONS == run) {
+            value = job->kernels->run_deviations(x, n, mean);
+        } else {
+            value = job->kernels->run_max(x, n);
+        }
+
+        if (TENSOR_RUN_MAX == run) {
+            result = TENSOR_REDUCE_GREATER(value, result) ? value : result;
+        } else {
+            result += value;
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+
+    return result;
+}
+
+// The first position in [begin, end) of the reduced space at base holding value, or a NaN
+static size_t tensor_reduce_find(
+    const tensor_reduce_job_t* job, const float* base, size_t begin, size_t end, float value
+) {
+    const tensor_space_t* space  = &job->reduced;
+    const ptrdiff_t       stride = space->strides[0][space->rank - 1];
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+        const float* x = base + cursor.offsets[0];
+
+        for (size_t i = 0; i < n; i++) {
+            const float v = x[(ptrdiff_t) i * stride];
+            if (v == value || (v != v && value != value)) {
+                return cursor.position + i;
+            }
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+
+    return begin;
+}
+
+static tensor_partial_t tensor_reduce_partial(
+    const tensor_reduce_job_t* job, const float* base, size_t begin, size_t end
+) {
+    tensor_partial_t partial = {end - begin, 0.0f, 0.0f, 0.0f, -INFINITY, begin};
+
+    switch (job->reduction) {
+        case TENSOR_REDUCE_SUM:
+        case TENSOR_REDUCE_MEAN:
+            partial.sum = tensor_reduce_runs(job, base, begin, end, TENSOR_RUN_SUM, 0.0f);
+            break;
+        case TENSOR_REDUCE_VARIANCE:
+            // Two passes: the deviations are taken from the mean of this range while it is in cache
+            partial.sum  = tensor_reduce_runs(job, base, begin, end, TENSOR_RUN_SUM, 0.0f);
+            partial.mean = partial.sum / (float) partial.count;
+            partial.m2
+                = tensor_reduce_runs(job, base, begin, end, TENSOR_RUN_DEVIATIONS, partial.mean);
+            break;
+        default:
+            partial.max = tensor_reduce_runs(job, base, begin, end, TENSOR_RUN_MAX, 0.0f);
+            if (TENSOR_REDUCE_ARGMAX == job->reduction) {
+                partial.argmax = tensor_reduce_find(job, base, begin, end, partial.max);
+            }
+            break;
+    }
+
+    return partial;
+}
+
+// Fold the partial of the range that follows into dst; Chan et al. for the mean and m2
+static void tensor_partial_merge(tensor_partial_t* dst, const tensor_partial_t* src) {
+    if (0 == src->count) {
+        return;
+    }
+
+    if (0 == dst->count) {
+        *dst = *src;
+        return;
+    }
+
+    const float  delta = src->mean - dst->mean;
+    const size_t count = dst->count + src->count;
+    const float  ratio = (float) src->count / (float) count;
+
+    dst->m2   += src->m2 + delta * delta * (float) dst->count * ratio;
+    dst->mean += delta * ratio;
+    dst->sum  += src->sum;
+    dst->count = count;
+
+    if (TENSOR_REDUCE_GREATER(src->max, dst->max)) {
+        dst->max    = src->max;
+        dst->argmax = src->argmax;
+    }
+}
+
+static void
+tensor_reduce_store(const tensor_reduce_job_t* job, ptrdiff_t offset, const tensor_partial_t* p) {
+    switch (job->reduction) {
+        case TENSOR_REDUCE_SUM:
+            job->dst[offset] = p->sum;
+            break;
+        case TENSOR_REDUCE_MEAN:
+            job->dst[offset] = p->sum / (float) p->count;
+            break;
+        case TENSOR_REDUCE_VARIANCE:
+            job->dst[offset] = p->m2 / (float) p->count;
+            break;
+        case TENSOR_REDUCE_MAX:
+            job->dst[offset] = p->max;
+            break;
+        default:
+            job->indices[offset] = p->argmax;
+            break;
+    }
+}
+
+// Horizontal: each result in [begin, end) reduces its own elements, contiguous or not
+static void tensor_reduce_horizontal_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const tensor_reduce_job_t* job   = (const tensor_reduce_job_t*) context;
+    const tensor_space_t*      space = &job->outputs;
+    const size_t               last  = space->rank - 1;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+
+        for (size_t k = 0; k < n; k++) {
+            const ptrdiff_t  from = cursor.offsets[0] + (ptrdiff_t) k * space->strides[0][last];
+            const ptrdiff_t  to   = cursor.offsets[1] + (ptrdiff_t) k * space->strides[1][last];
+            tensor_partial_t p    = tensor_reduce_partial(job, job->src + from, 0, job->count);
+            tensor_reduce_store(job, to, &p);
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+}
+
+// Fold every row of m neighboring results at base into acc, or their squared deviations from mean
+static void tensor_reduce_rows(
+    const tensor_reduce_job_t* job,
+    const float*               base,
+    size_t                     m,
+    float*                     acc,
+    size_t*                    index,
+    const float*               mean
+) {
+    const tensor_reduce_kernels_t* kernels = job->kernels;
+    const tensor_space_t*          space   = &job->reduced;
+    const ptrdiff_t                stride  = space->strides[0][space->rank - 1];
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, 0);
+
+    while (cursor.position < job->count) {
+        const size_t n = tensor_cursor_run(&cursor, space, job->count);
+
+        for (size_t k = 0; k < n; k++) {
+            const float* row = base + cursor.offsets[0] + (ptrdiff_t) k * stride;
+            if (NULL != mean) {
+                kernels->block_deviations(acc, row, mean, m);
+            } else if (TENSOR_REDUCE_ARGMAX == job->reduction) {
+                kernels->block_argmax(acc, index, row, cursor.position + k, m);
+            } else if (TENSOR_REDUCE_MAX == job->reduction) {
+                kernels->block_max(acc, row, m);
+            } else {
+                kernels->block_sum(acc, row, m);
+            }
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+}
+
+// Reduce m neighboring, contiguous results at once, reading src one row at a time
+static void
+tensor_reduce_block(const tensor_reduce_job_t* job, const float* base, ptrdiff_t offset, size_t m) {
+    const ptrdiff_t step    = job->outputs.strides[1][job->outputs.rank - 1];
+    const bool      maximum = TENSOR_REDUCE_MAX == job->reduction
+                         || TENSOR_REDUCE_ARGMAX == job->reduction;
+
+    float  acc[TENSOR_REDUCE_BLOCK];
+    float  mean[TENSOR_REDUCE_BLOCK];
+    size_t index[TENSOR_REDUCE_BLOCK];
+    for (size_t j = 0; j < m; j++) {
+        acc[j]   = maximum ? -INFINITY : 0.0f;
+        index[j] = 0;
+    }
+
+    tensor_reduce_rows(job, base, m, acc, index, NULL);
+
+    if (TENSOR_REDUCE_VARIANCE == job->reduction) {
+        for (size_t j = 0; j < m; j++) {
+            mean[j] = acc[j] / (float) job->count;
+            acc[j]  = 0.0f;
+        }
+        tensor_reduce_rows(job, base, m, acc, index, mean);
+    }
+
+    for (size_t j = 0; j < m; j++) {
+        const ptrdiff_t at = offset + (ptrdiff_t) j * step;
+        switch (job->reduction) {
+            case TENSOR_REDUCE_MEAN:
+            case TENSOR_REDUCE_VARIANCE:
+                job->dst[at] = acc[j] / (float) job->count;
+                break;
+            case TENSOR_REDUCE_SUM:
+            case TENSOR_REDUCE_MAX:
+                job->dst[at] = acc[j];
+                break;
+            default:
+                job->indices[at] = index[j];
+                break;
+        }
+    }
+}
+
+// Vertical: runs of results in [begin, end) that neighbor in src, TENSOR_REDUCE_BLOCK at a time
+static void tensor_reduce_vertical_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const tensor_reduce_job_t* job   = (const tensor_reduce_job_t*) context;
+    const tensor_space_t*      space = &job->outputs;
+    const size_t               last  = space->rank - 1;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, space, begin);
+
+    while (cursor.position < end) {
+        const size_t n = tensor_cursor_run(&cursor, space, end);
+
+        for (size_t j = 0; j < n; j += TENSOR_REDUCE_BLOCK) {
+            const size_t    m      = n - j < TENSOR_REDUCE_BLOCK ? n - j : TENSOR_REDUCE_BLOCK;
+            const ptrdiff_t offset = cursor.offsets[1] + (ptrdiff_t) j * space->strides[1][last];
+            tensor_reduce_block(job, job->src + cursor.offsets[0] + (ptrdiff_t) j, offset, m);
+        }
+
+        tensor_cursor_advance(&cursor, space, n);
+    }
+}
+
+// Partial reductions of one large result, one per TENSOR_PARALLEL_CHUNK of its elements
+typedef struct {
+    const tensor_reduce_job_t* job;
+    const float*               base;
+    tensor_partial_t*          partials;
+} tensor_reduce_split_t;
+
+static void tensor_reduce_split_task(void* context, size_t chunk, size_t begin, size_t end) {
+    tensor_reduce_split_t* split = (tensor_reduce_split_t*) context;
+    split->partials[chunk]       = tensor_reduce_partial(split->job, split->base, begin, end);
+}
+
+static bool tensor_reduce_split(const tensor_reduce_job_t* job, size_t outputs) {
+    const size_t      chunks   = (job->count + TENSOR_PARALLEL_CHUNK - 1) / TENSOR_PARALLEL_CHUNK;
+    tensor_partial_t* partials = (tensor_partial_t*) malloc(chunks * sizeof(tensor_partial_t));
+    if (NULL == partials) {
+        fprintf(stderr, "Failed to allocate %zu partial reductions.\n", chunks);
+        return false;
+    }
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, &job->outputs, 0);
+
+    for (size_t i = 0; i < outputs; i++) {
+        tensor_reduce_split_t split = {job, job->src + cursor.offsets[0], partials};
+        pool_for(tensor_pool, job->count, TENSOR_PARALLEL_CHUNK, tensor_reduce_split_task, &split);
+
+        // Combine in chunk order, whichever threads computed the chunks
+        tensor_partial_t result = partials[0];
+        for (size_t c = 1; c < chunks; c++) {
+            tensor_partial_merge(&result, &partials[c]);
+        }
+        tensor_reduce_store(job, cursor.offsets[1], &result);
+
+        tensor_cursor_advance(&cursor, &job->outputs, 1);
+    }
+
+    free(partials);
+    return true;
+}
+
+// Reduce src over axes into values at dst, or indices for argmax, laid out with dst_strides
+static bool tensor_reduce_execute(
+    const tensor_t*    src,
+    unsigned           axes,
+    tensor_reduction_t reduction,
+    float*             dst,
+    size_t*            indices,
+    const ptrdiff_t*   dst_strides
+) {
+    if (0 != (axes >> src->rank)) {
+        fprintf(stderr, "Axes mask 0x%x selects axes beyond rank %zu.\n", axes, src->rank);
+        return false;
+    }
+
+    tensor_reduce_job_t job = {
+        .src       = src->data,
+        .dst       = dst,
+        .indices   = indices,
+        .reduction = reduction,
+        .kernels   = tensor_reduce_kernels(),
+        .count     = 1,
+    };
+    size_t outputs = 1;
+
+    for (size_t i = 0; i < src->rank; i++) {
+        if (axes & TENSOR_AXIS(i)) {
+            const ptrdiff_t strides[TENSOR_OPERANDS] = {src->strides[i], 0, 0};
+            tensor_space_push(&job.reduced, src->shape[i], strides);
+            job.count *= src->shape[i];
+        } else {
+            const ptrdiff_t strides[TENSOR_OPERANDS] = {src->strides[i], dst_strides[i], 0};
+            tensor_space_push(&job.outputs, src->shape[i], strides);
+            outputs *= src->shape[i];
+        }
+    }
+    tensor_space_finish(&job.reduced);
+    tensor_space_finish(&job.outputs);
+
+    if (TENSOR_REDUCE_ARGMAX == reduction && 0 == job.count) {
+        fprintf(stderr, "Cannot find the largest of 0 elements.\n");
+        return false;
+    }
+
+    if (0 == outputs) {
+        return true;
+    }
+
+    if (job.count >= TENSOR_PARALLEL_THRESHOLD) {
+        return tensor_reduce_split(&job, outputs);
+    }
+
+    // Results are read row by row when they are neighbors in src and their elements are not
+    const bool vertical = 1 == job.outputs.strides[0][job.outputs.rank - 1]
+                          && 1 != job.reduced.strides[0][job.reduced.rank - 1];
+
+    // Each chunk covers about TENSOR_PARALLEL_CHUNK elements of src, and whole vertical blocks
+    const size_t reduced = job.count > 0 ? job.count : 1;
+    size_t       chunk   = TENSOR_PARALLEL_CHUNK > reduced ? TENSOR_PARALLEL_CHUNK / reduced : 1;
+    pool_t*      pool    = src->size >= TENSOR_PARALLEL_THRESHOLD ? tensor_pool : NULL;
+
+    if (vertical) {
+        chunk = (chunk + TENSOR_REDUCE_BLOCK - 1) / TENSOR_REDUCE_BLOCK * TENSOR_REDUCE_BLOCK;
+        pool_for(pool, outputs, chunk, tensor_reduce_vertical_task, &job);
+    } else {
+        pool_for(pool, outputs, chunk, tensor_reduce_horizontal_task, &job);
+    }
+
+    return true;
+}
+
+tensor_t* tensor_reduce_into(
+    tensor_t* dst, const tensor_t* src, unsigned axes, tensor_reduction_t reduction
+) {
+    if (NULL == dst || NULL == src) {
+        return NULL;
+    }
+
+    if (!tensor_writable(dst)) {
+        return NULL;
+    }
+
+    if ((unsigned) reduction > TENSOR_REDUCE_VARIANCE) {
+        fprintf(stderr, "Unknown tensor reduction %d.\n", (int) reduction);
+        return NULL;
+    }
+
+    bool fits = dst->rank == src->rank;
+    for (size_t i = 0; i < src->rank && fits; i++) {
+        fits = dst->shape[i] == (axes & TENSOR_AXIS(i) ? 1 : src->shape[i]);
+    }
+
+    if (!fits) {
+        fprintf(stderr, "Destination tensor has shape ");
+        tensor_print_shape(dst);
+        fprintf(stderr, " but reducing shape ");
+        tensor_print_shape(src);
+        fprintf(stderr, " over axes 0x%x needs extents of 1 on the reduced axes.\n", axes);
+        return NULL;
+    }
+
+    if (0 == dst->size) {
+        return dst;
+    }
+
+    for (size_t i = 0; i < dst->rank; i++) {
+        if (dst->shape[i] > 1 && 0 == dst->strides[i]) {
+            fprintf(stderr, "Destination tensor repeats elements along dimension %zu.\n", i);
+            return NULL;
+        }
+    }
+
+    if (src->size > 0) {
+        const float *dst_low, *dst_high, *src_low, *src_high;
+        tensor_span(dst, &dst_low, &dst_high);
+        tensor_span(src, &src_low, &src_high);
+        if (dst_low < src_high && src_low < dst_high) {
+            fprintf(stderr, "Destination tensor overlaps the tensor being reduced.\n");
+            return NULL;
+        }
+    }
+
+    return tensor_reduce_execute(src, axes, reduction, dst->data, NULL, dst->strides) ? dst : NULL;
+}
+
+tensor_t* tensor_reduce(const tensor_t* src, unsigned axes, tensor_reduction_t reduction) {
+    if (NULL == src) {
+        return NULL;
+    }
+
+    size_t shape[TENSOR_MAX_RANK];
+    for (size_t i = 0; i < src->rank; i++) {
+        shape[i] = axes & TENSOR_AXIS(i) ? 1 : src->shape[i];
+    }
+
+    tensor_t* c = tensor_create_nd(src->rank, shape);
+    if (NULL == c) {
+        return NULL; // tensor_create_nd logs the error for us
+    }
+
+    if (NULL == tensor_reduce_into(c, src, axes, reduction)) {
+        tensor_free(c);
+        return NULL;
+    }
+
+    return c;
+}
+
+float tensor_reduce_all(const tensor_t* src, tensor_reduction_t reduction) {
+    if (NULL == src || (unsigned) reduction > TENSOR_REDUCE_VARIANCE) {
+        return NAN;
+    }
+
+    // Every axis is reduced, so the result has no strides to follow
+    const ptrdiff_t strides[TENSOR_MAX_RANK] = {0};
+    const unsigned  axes                     = TENSOR_AXIS(src->rank) - 1;
+    float           result                   = NAN;
+    tensor_reduce_execute(src, axes, reduction, &result, NULL, strides);
+
+    return result;
+}
+
+// Row-major strides of the results of reducing src over axes, for the indices of argmax
+static size_t tensor_argmax_strides(const tensor_t* src, unsigned axes, ptrdiff_t* strides) {
+    size_t count = 1;
+    for (size_t i = src->rank; i-- > 0;) {
+        strides[i]  = (ptrdiff_t) count;
+        count      *= axes & TENSOR_AXIS(i) ? 1 : src->shape[i];
+    }
+
+    return count;
+}
+
+size_t* tensor_argmax_into(size_t* indices, const tensor_t* src, unsigned axes) {
+    if (NULL == indices || NULL == src) {
+        return NULL;
+    }
+
+    ptrdiff_t strides[TENSOR_MAX_RANK];
+    tensor_argmax_strides(src, axes, strides);
+
+    if (!tensor_reduce_execute(src, axes, TENSOR_REDUCE_ARGMAX, NULL, indices, strides)) {
+        return NULL;
+    }
+
+    return indices;
+}
+
+size_t* tensor_argmax(const tensor_t* src, unsigned axes) {
+    if (NULL == src) {
+        return NULL;
+    }
+
+    ptrdiff_t    strides[TENSOR_MAX_RANK];
+    const size_t count = tensor_argmax_strides(src, axes, strides);
+
+    size_t* indices = (size_t*) malloc((count ? count : 1) * sizeof(size_t));
+    if (NULL == indices) {
+        fprintf(stderr, "Failed to allocate %zu argmax indices.\n", count);
+        return NULL;
+    }
+
+    if (NULL == tensor_argmax_into(indices, src, axes)) {
+        free(indices);
+        return NULL;
+    }
+
+    return indices;
+}
+
+size_t tensor_argmax_all(const tensor_t* src) {
+    if (NULL == src || 0 == src->size) {
+        return SIZE_MAX;
+    }
+
+    const ptrdiff_t strides[TENSOR_MAX_RANK] = {0};
+    size_t          index                    = SIZE_MAX;
+    const unsigned  axes                     = TENSOR_AXIS(src->rank) - 1;
+    tensor_reduce_execute(src, axes, TENSOR_REDUCE_ARGMAX, NULL, &index, strides);
+
+    return index;
+}
+
+// Tensor files
+
+static const char tensor_file_magic[8] = {'T', 'E', 'N', 'S', 'O', 'R', 0, 0};
+
+#define TENSOR_FILE_BYTE_ORDER 0x01020304u
+
+// The elements follow the header at the next TENSOR_ALIGNMENT boundary
+#define TENSOR_FILE_DATA_OFFSET \
+    ((sizeof(tensor_file_header_t) + TENSOR_ALIGNMENT - 1) / TENSOR_ALIGNMENT * TENSOR_ALIGNMENT)
+
+_Static_assert(sizeof(tensor_file_header_t) == 176, "The tensor file header must not be padded.");
+
+struct tensor_writer {
+    FILE*  file;
+    char*  path;    ///< Kept to remove an incomplete file.
+    size_t size;    ///< Elements the header declares.
+    size_t written; ///< Elements written so far.
+    bool   failed;
+};
+
+// Check the header against the length of the file, and count the elements it declares
+static bool tensor_file_check(
+    const tensor_file_header_t* header, size_t length, const char* path, size_t* size
+) {
+    if (0 != memcmp(header->magic, tensor_file_magic, sizeof(tensor_file_magic))) {
+        fprintf(stderr, "%s is not a tensor file.\n", path);
+        return false;
+    }
+
+    if (TENSOR_FILE_BYTE_ORDER != header->byte_order) {
+        fprintf(stderr, "Tensor file %s was written with the other byte order.\n", path);
+        return false;
+    }
+
+    if (0 == header->version || header->version > TENSOR_FILE_VERSION
+        || TENSOR_FILE_FLOAT32 != header->dtype) {
+        fprintf(
+            stderr,
+            "Tensor file %s has version %u and type %u; only versions 1-%d of type %d are read.\n",
+            path,
+            (unsigned) header->version,
+            (unsigned) header->dtype,
+            TENSOR_FILE_VERSION,
+            TENSOR_FILE_FLOAT32
+        );
+        return false;
+    }
+
+    const uint64_t alignment = header->alignment;
+    if (header->rank > TENSOR_MAX_RANK || alignment < sizeof(float)
+        || 0 != (alignment & (alignment - 1)) || 0 != header->data_offset % alignment
+        || header->data_offset < sizeof(tensor_file_header_t)) {
+        fprintf(stderr, "Tensor file %s has a malformed header.\n", path);
+        return false;
+    }
+
+    if (header->data_offset > length || header->data_bytes > length - header->data_offset) {
+        fprintf(stderr, "Tensor file %s is truncated.\n", path);
+        return false;
+    }
+
+    // Every element must lie in the data: the offset of the last one is below the count
+    const uint64_t count = header->data_bytes / sizeof(float);
+    uint64_t       last  = 0;
+    *size                = 1;
+    for (size_t i = 0; i < header->rank; i++) {
+        const uint64_t extent = header->shape[i];
+        const int64_t  stride = header->strides[i];
+        if (stride < 0 || (extent > 1 && (uint64_t) stride > (count - last) / (extent - 1))) {
+            fprintf(stderr, "Tensor file %s has strides reaching past its data.\n", path);
+            return false;
+        }
+        if (extent > 1) {
+            last += (extent - 1) * (uint64_t) stride;
+        }
+
+        if (0 != extent && *size > SIZE_MAX / extent) {
+            fprintf(stderr, "Tensor file %s is too large to address.\n", path);
+            return false;
+        }
+        *size *= (size_t) extent;
+    }
+
+    if (*size > 0 && last >= count) {
+        fprintf(stderr, "Tensor file %s has strides reaching past its data.\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+tensor_t* tensor_load(const char* path) {
+    if (NULL == path) {
+        fprintf(stderr, "Cannot load a tensor from a NULL path.\n");
+        return NULL;
+    }
+
+    const int fd = open(path, O_RDONLY);
+    if (-1 == fd) {
+        fprintf(stderr, "Failed to open tensor file %s: %s.\n", path, strerror(errno));
+        return NULL;
+    }
+
+    struct stat info;
+    if (0 != fstat(fd, &info)) {
+        fprintf(stderr, "Failed to inspect tensor file %s: %s.\n", path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    const size_t length = (size_t) info.st_size;
+    if (info.st_size < (off_t) sizeof(tensor_file_header_t)) {
+        fprintf(stderr, "%s is too short to be a tensor file.\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    // Nothing is read here; pages are faulted in as they are touched, the header's first
+    void* address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == address) {
+        fprintf(stderr, "Failed to map tensor file %s: %s.\n", path, strerror(errno));
+        return NULL;
+    }
+
+    const tensor_file_header_t* header = (const tensor_file_header_t*) address;
+
+    size_t size;
+    if (!tensor_file_check(header, length, path, &size)) {
+        munmap(address, length);
+        return NULL;
+    }
+
+    tensor_mapping_t* mapping = (tensor_mapping_t*) malloc(sizeof(tensor_mapping_t));
+    if (NULL == mapping) {
+        fprintf(stderr, "Failed to allocate %zu bytes to tensor_t.\n", sizeof(tensor_mapping_t));
+        munmap(address, length);
+        return NULL;
+    }
+    mapping->address = address;
+    mapping->length  = length;
+
+    tensor_t* tensor  = &mapping->tensor;
+    tensor->data      = (float*) ((unsigned char*) address + header->data_offset);
+    tensor->elements  = NULL;
+    tensor->rank      = header->rank;
+    tensor->size      = size;
+    tensor->storage   = TENSOR_STORAGE_MAPPED;
+    tensor->read_only = true;
+    for (size_t i = 0; i < TENSOR_MAX_RANK; i++) {
+        tensor->shape[i]   = i < tensor->rank ? (size_t) header->shape[i] : 1;
+        tensor->strides[i] = i < tensor->rank ? (ptrdiff_t) header->strides[i] : 0;
+    }
+
+    return tensor;
+}
+
+tensor_writer_t* tensor_writer_open(const char* path, size_t rank, const size_t* shape) {
+    if (NULL == path || (rank > 0 && NULL == shape)) {
+        fprintf(stderr, "Cannot write a tensor file without a path and a shape.\n");
+        return NULL;
+    }
+
+    if (rank > TENSOR_MAX_RANK) {
+        fprintf(stderr, "Tensors have at most %d dimensions, not %zu.\n", TENSOR_MAX_RANK, rank);
+        return NULL;
+    }
+
+    tensor_file_header_t header = {0};
+    memcpy(header.magic, tensor_file_magic, sizeof(tensor_file_magic));
+    header.version     = TENSOR_FILE_VERSION;
+    header.byte_order  = TENSOR_FILE_BYTE_ORDER;
+    header.dtype       = TENSOR_FILE_FLOAT32;
+    header.rank        = (uint32_t) rank;
+    header.alignment   = TENSOR_ALIGNMENT;
+    header.data_offset = TENSOR_FILE_DATA_OFFSET;
+
+    // Row-major strides as in tensor_create_nd(), guarding the byte size against overflow
+    size_t    size   = 1;
+    ptrdiff_t stride = 1;
+    for (size_t i = TENSOR_MAX_RANK; i-- > 0;) {
+        header.shape[i]   = i < rank ? shape[i] : 1;
+        header.strides[i] = i < rank ? stride : 0;
+        if (i < rank && 0 != shape[i] && size > PTRDIFF_MAX / sizeof(float) / shape[i]) {
+            fprintf(stderr, "Tensor of rank %zu is too large.\n", rank);
+            return NULL;
+        }
+        size   *= i < rank ? shape[i] : 1;
+        stride *= i < rank ? (ptrdiff_t) shape[i] : 1;
+    }
+    header.data_bytes = size * sizeof(float);
+
+    tensor_writer_t* writer = (tensor_writer_t*) malloc(sizeof(tensor_writer_t));
+    char*            copy   = (char*) malloc(strlen(path) + 1);
+    if (NULL == writer || NULL == copy) {
+        fprintf(stderr, "Failed to allocate a tensor writer.\n");
+        free(writer);
+        free(copy);
+        return NULL;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (NULL == file) {
+        fprintf(stderr, "Failed to create tensor file %s: %s.\n", path, strerror(errno));
+        free(writer);
+        free(copy);
+        return NULL;
+    }
+
+    writer->file    = file;
+    writer->path    = strcpy(copy, path);
+    writer->size    = size;
+    writer->written = 0;
+    writer->failed  = false;
+
+    // Zeros pad the header up to the data
+    static const unsigned char padding[TENSOR_FILE_DATA_OFFSET - sizeof(tensor_file_header_t)];
+    if (1 != fwrite(&header, sizeof(header), 1, file)
+        || sizeof(padding) != fwrite(padding, 1, sizeof(padding), file)) {
+        fprintf(stderr, "Failed to write tensor file %s: %s.\n", path, strerror(errno));
+        writer->failed = true;
+        tensor_writer_close(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+bool tensor_writer_write(tensor_writer_t* writer, const float* elements, size_t count) {
+    if (NULL == writer || writer->failed) {
+        return false;
+    }
+
+    if (count > writer->size - writer->written) {
+        fprintf(
+            stderr,
+            "Writing %zu elements after %zu overflows the %zu of tensor file %s.\n",
+            count,
+            writer->written,
+            writer->size,
+            writer->path
+        );
+        writer->failed = true;
+        return false;
+    }
+
+    if (count > 0 && count != fwrite(elements, sizeof(float), count, writer->file)) {
+        fprintf(stderr, "Failed to write tensor file %s: %s.\n", writer->path, strerror(errno));
+        writer->failed = true;
+        return false;
+    }
+
+    writer->written += count;
+    return true;
+}
+
+bool tensor_writer_close(tensor_writer_t* writer) {
+    if (NULL == writer) {
+        return false;
+    }
+
+    bool ok = !writer->failed;
+    if (ok && writer->written != writer->size) {
+        fprintf(
+            stderr,
+            "Tensor file %s was closed after %zu of its %zu elements.\n",
+            writer->path,
+            writer->written,
+            writer->size
+        );
+        ok = false;
+    }
+
+    // Closing flushes the last buffer, which can fail too
+    if (0 != fclose(writer->file) && ok) {
+        fprintf(stderr, "Failed to write tensor file %s: %s.\n", writer->path, strerror(errno));
+        ok = false;
+    }
+
+    if (!ok) {
+        remove(writer->path);
+    }
+
+    free(writer->path);
+    free(writer);
+    return ok;
+}
+
+bool tensor_save(const tensor_t* tensor, const char* path) {
+    if (NULL == tensor) {
+        fprintf(stderr, "Cannot save a NULL tensor.\n");
+        return false;
+    }
+
+    tensor_writer_t* writer = tensor_writer_open(path, tensor->rank, tensor->shape);
+    if (NULL == writer) {
+        return false;
+    }
+
+    if (tensor_is_contiguous(tensor)) {
+        tensor_writer_write(writer, tensor->data, tensor->size);
+        return tensor_writer_close(writer);
+    }
+
+    float* buffer = (float*) malloc(TENSOR_PARALLEL_CHUNK * sizeof(float));
+    if (NULL == buffer) {
+        fprintf(stderr, "Failed to allocate a buffer to save tensor file %s.\n", path);
+        writer->failed = true;
+        return tensor_writer_close(writer);
+    }
+
+    // Gather the view in row-major order, one run at a time, and write out each full buffer
+    tensor_space_t space = {0};
+    for (size_t i = 0; i < tensor->rank; i++) {
+        const ptrdiff_t strides[TENSOR_OPERANDS] = {tensor->strides[i]};
+        tensor_space_push(&space, tensor->shape[i], strides);
+    }
+    tensor_space_finish(&space);
+
+    const ptrdiff_t stride = space.strides[0][space.rank - 1];
+    size_t          filled = 0;
+
+    tensor_cursor_t cursor;
+    tensor_cursor_start(&cursor, &space, 0);
+
+    while (cursor.position < tensor->size) {
+        const size_t room = TENSOR_PARALLEL_CHUNK - filled;
+        const size_t end  = tensor->size - cursor.position > room ? cursor.position + room
+                                                                  : tensor->size;
+        const size_t n    = tensor_cursor_run(&cursor, &space, end);
+        const float* x    = tensor->data + cursor.offsets[0];
+
+        for (size_t i = 0; i < n; i++) {
+            buffer[filled + i] = x[(ptrdiff_t) i * stride];
+        }
+        filled += n;
+        tensor_cursor_advance(&cursor, &space, n);
+
+        if (TENSOR_PARALLEL_CHUNK == filled || cursor.position == tensor->size) {
+            if (!tensor_writer_write(writer, buffer, filled)) {
+                break;
+            }
+            filled = 0;
+        }
+    }
+
+    free(buffer);
+    return tensor_writer_close(writer);
 }
@@ -14,35 +14,181 @@
 #ifndef TENSOR_H
 #define TENSOR_H
 
+#include "pool.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
-// Tensor lifecycle
+// Structures
+
+/**
+ * @brief The largest number of dimensions a tensor can have.
+ */
+#define TENSOR_MAX_RANK 8
+
+/**
+ * @brief Alignment in bytes of tensor data; one cache line.
+ */
+#define TENSOR_ALIGNMENT 64
+
+/**
+ * @brief Describes who owns the memory behind a tensor, so tensor_free() releases it correctly.
+ */
+typedef enum {
+    TENSOR_STORAGE_ALIGNED, /**< Header and data share a single aligned heap allocation */
+    TENSOR_STORAGE_VIEW,    /**< Header is a value and data borrows another tensor's memory */
+    TENSOR_STORAGE_MAPPED,  /**< Header is on the heap and data is a read-only mapping of a file */
+} tensor_storage_t;
 
 /**
- * @brief A structure representing a 3-dimensional tensor.
+ * @brief A structure representing an N-dimensional tensor.
+ *
+ * A tensor is a rectangular array of any rank up to TENSOR_MAX_RANK: a rank-3 tensor is a stack of
+ * layers of rows of columns, and may be thought of as a volume of cubic units. The element at
+ * index (i0, i1, ..., in) is data[i0 * strides[0] + i1 * strides[1] + ... + in * strides[n]].
  *
- * A tensor is a rectangular prism where each element may be thought of as a cubic unit.
- * It is a complex, multidimensional representation of vectors and/or matrices, typically used to
- * represent complex 2D and/or 3D spaces and planes.
+ * A tensor created by tensor_create_nd() is contiguous in row-major order: the last dimension has
+ * stride 1 and each stride is the product of the extents after it. The data is one
+ * TENSOR_ALIGNMENT-aligned block that directly follows the header in the same allocation, so it
+ * can be handed to SIMD kernels or written out in one piece, and creating or freeing a tensor of
+ * any size is a single allocator call.
  *
- * @param elements A three-dimensional pointer to an array of floats, representing the tensor
- * elements.
- * @param columns  The number of columns (width) of the tensor.
- * @param rows     The number of rows (height) of the tensor.
- * @param depth    The number of layers (depth) of the tensor.
+ * Strides are signed and counted in elements. Views may have any strides, including 0 to repeat
+ * an element along a dimension.
+ *
+ * @param data      The element at index (0, ..., 0).
+ * @param elements  Optional layer and row pointer view of a rank-3 tensor, NULL until
+ *                  tensor_element_view() builds it.
+ * @param rank      The number of dimensions, at most TENSOR_MAX_RANK.
+ * @param size      The number of elements, the product of the extents.
+ * @param shape     The extent of each dimension, outermost first.
+ * @param strides   The number of elements between neighbors along each dimension.
+ * @param storage   Ownership of the memory behind the tensor.
+ * @param read_only Whether the elements must not be written: set for a tensor loaded from a file
+ *                  and kept by every view of it.
  */
 typedef struct {
-    float*** elements; ///< Three-dimensional array representing the tensor elements.
-    size_t   columns;  ///< The number of columns (width) of the tensor.
-    size_t   rows;     ///< The number of rows (height) of the tensor.
-    size_t   layers;   ///< The number of layers (depth) of the tensor.
+    float*           data;                     ///< The element at index (0, ..., 0).
+    float***         elements;                 ///< Optional view, elements[layer][row][column].
+    size_t           rank;                     ///< The number of dimensions.
+    size_t           size;                     ///< The number of elements.
+    size_t           shape[TENSOR_MAX_RANK];   ///< The extent of each dimension, outermost first.
+    ptrdiff_t        strides[TENSOR_MAX_RANK]; ///< Elements between neighbors along each dimension.
+    tensor_storage_t storage;                  ///< Ownership of the memory behind the tensor.
+    bool             read_only;                ///< Elements are a read-only mapping.
 } tensor_t;
 
 /**
- * @brief Creates a new tensor with the specified dimensions.
+ * @brief The binary operations applied element by element by tensor_elementwise_operation().
+ */
+typedef enum {
+    TENSOR_ADD,      /**< a + b */
+    TENSOR_SUBTRACT, /**< a - b */
+    TENSOR_MULTIPLY, /**< a * b */
+    TENSOR_DIVIDE,   /**< a / b, with IEEE infinities and NaNs for zero divisors */
+    TENSOR_MAXIMUM,  /**< a > b ? a : b, so b if either is NaN, like the SSE maxps instruction */
+    TENSOR_MINIMUM,  /**< a < b ? a : b, so b if either is NaN, like the SSE minps instruction */
+} tensor_operator_t;
+
+/**
+ * @brief The reductions computed by tensor_reduce() over one or more axes.
+ *
+ * A NaN anywhere in the reduced elements makes the result NaN, as in NumPy.
+ */
+typedef enum {
+    TENSOR_REDUCE_SUM,      /**< Sum of the elements; 0 if there are none */
+    TENSOR_REDUCE_MEAN,     /**< Arithmetic mean; NaN if there are no elements */
+    TENSOR_REDUCE_MAX,      /**< Largest element; -INFINITY if there are none */
+    TENSOR_REDUCE_VARIANCE, /**< Population variance, from two passes; NaN if there are none */
+} tensor_reduction_t;
+
+/**
+ * @brief The bit selecting one axis in the axes mask of tensor_reduce() and tensor_argmax().
+ */
+#define TENSOR_AXIS(axis) (1u << (axis))
+
+/**
+ * @brief Version of the tensor file format written by tensor_save() and tensor_writer_open().
+ */
+#define TENSOR_FILE_VERSION 1
+
+/**
+ * @brief Element type code of 32-bit IEEE-754 floats, the only one tensor files hold so far.
+ */
+#define TENSOR_FILE_FLOAT32 1
+
+/**
+ * @brief The header at the start of a tensor file, followed by the raw elements.
+ *
+ * Every field has a fixed size and offset, with no padding, so the header is 176 bytes. Fields and
+ * elements are in the byte order of the machine that wrote the file; byte_order tells a reader
+ * from the other order to reject it instead of loading garbage. The elements sit at data_offset,
+ * a multiple of alignment, so a file mapped at a page boundary hands out aligned data as is.
+ *
+ * Strides are counted in elements from the first one and may describe a padded layout, as long
+ * as every element lies within the data_bytes that follow data_offset. Past the rank, extents are
+ * 1 and strides are 0.
+ */
+typedef struct {
+    char     magic[8];                 ///< "TENSOR" followed by two zero bytes.
+    uint32_t version;                  ///< TENSOR_FILE_VERSION of the writer.
+    uint32_t byte_order;               ///< 0x01020304, as written by the machine that wrote it.
+    uint32_t dtype;                    ///< Element type, TENSOR_FILE_FLOAT32.
+    uint32_t rank;                     ///< The number of dimensions.
+    uint64_t alignment;                ///< Power of two that data_offset is a multiple of.
+    uint64_t data_offset;              ///< Bytes from the start of the file to the elements.
+    uint64_t data_bytes;               ///< Bytes of elements from data_offset.
+    uint64_t shape[TENSOR_MAX_RANK];   ///< The extent of each dimension, outermost first.
+    int64_t  strides[TENSOR_MAX_RANK]; ///< Elements between neighbors along each dimension.
+} tensor_file_header_t;
+
+/**
+ * @brief Opaque writer streaming the elements of a tensor file.
+ */
+typedef struct tensor_writer tensor_writer_t;
+
+// Element access
+
+/**
+ * @brief Return a pointer to the element at an index of rank components.
+ */
+static inline float* tensor_at(const tensor_t* tensor, const size_t* index) {
+    ptrdiff_t offset = 0;
+    for (size_t i = 0; i < tensor->rank; i++) {
+        offset += (ptrdiff_t) index[i] * tensor->strides[i];
+    }
+    return tensor->data + offset;
+}
+
+/**
+ * @brief Return a pointer to the element at (layer, row, column) of a rank-3 tensor.
+ */
+static inline float* tensor_at3(const tensor_t* tensor, size_t layer, size_t row, size_t column) {
+    return tensor->data + (ptrdiff_t) layer * tensor->strides[0]
+           + (ptrdiff_t) row * tensor->strides[1] + (ptrdiff_t) column * tensor->strides[2];
+}
+
+// Tensor lifecycle
+
+/**
+ * @brief Creates a new contiguous tensor of the given shape. Initializes all elements to zero.
  *
- * This function allocates memory for a tensor with the given number of columns, rows, and depth.
- * The tensor elements are initialized to zero.
+ * @param rank  The number of dimensions, at most TENSOR_MAX_RANK; 0 creates a single scalar.
+ * @param shape The extent of each dimension, outermost first. Extents of 0 are allowed.
+ *
+ * @return A pointer to the newly created tensor, or NULL if the rank is too large, the size
+ *         overflows, or memory allocation fails.
+ */
+tensor_t* tensor_create_nd(size_t rank, const size_t* shape);
+
+/**
+ * @brief Creates a new rank-3 tensor with the specified dimensions.
+ *
+ * Equivalent to tensor_create_nd() with the shape {layers, rows, columns}. Code written for the
+ * former pointer-per-row layout can keep indexing elements[layer][row][column] through
+ * tensor_element_view() while it migrates to tensor_at3().
  *
  * @param columns The number of columns (width) for the tensor.
  * @param rows    The number of rows (height) for the tensor.
@@ -53,15 +199,360 @@ typedef struct {
 tensor_t* tensor_create(size_t columns, size_t rows, size_t layers);
 
 /**
- * @brief Frees the memory allocated for a tensor.
+ * @brief Frees the memory allocated for a tensor, including the element view if one was built.
  *
- * This function deallocates the memory associated with a tensor, including the memory for the
- * tensor elements and the tensor structure itself.
+ * A view's header belongs to the caller, so only its element view is released. A tensor loaded by
+ * tensor_load() also unmaps its file.
  *
  * @param tensor A pointer to the tensor to be freed. If the pointer is NULL, no action is taken.
  */
 void tensor_free(tensor_t* tensor);
 
+/**
+ * @brief Build, or return the already built, layer and row pointer view of a rank-3 tensor.
+ *
+ * The view costs one allocation of layers * (rows + 1) pointers into the data, is owned by the
+ * tensor and is released by tensor_free().
+ *
+ * @param tensor Pointer to a rank-3 tensor whose columns have stride 1.
+ * @return The layer pointers, also stored in tensor->elements, or NULL if the tensor does not have
+ *         that layout or allocation fails.
+ */
+float*** tensor_element_view(tensor_t* tensor);
+
+/**
+ * @brief Whether the elements are laid out in row-major order without gaps, as created.
+ */
+bool tensor_is_contiguous(const tensor_t* tensor);
+
+// Parallel execution
+
+/**
+ * @brief Operations producing at least this many elements are processed in chunks, in parallel
+ * when a pool is set. Smaller ones always run serially on the caller.
+ */
+#define TENSOR_PARALLEL_THRESHOLD (1 << 18)
+
+/**
+ * @brief Elements per chunk of a parallel operation; 256 KiB of floats, sized for the L2 cache.
+ */
+#define TENSOR_PARALLEL_CHUNK (1 << 16)
+
+/**
+ * @brief Set the pool used to parallelize large tensor operations.
+ *
+ * @param pool Pool to use, or NULL to run serially (the default)
+ */
+void tensor_set_pool(pool_t* pool);
+
+/**
+ * @brief Return the pool used to parallelize large tensor operations, or NULL.
+ */
+pool_t* tensor_get_pool(void);
+
 // Tensor operations
 
+/**
+ * @brief Compute the shape two tensors broadcast to, following NumPy's rules.
+ *
+ * Shapes are aligned on their last dimension and the shorter one is padded with leading extents
+ * of 1. Two aligned extents are compatible if they are equal or one of them is 1, which is then
+ * repeated to match the other. For example, {4, 1, 3} and {5, 1} broadcast to {4, 5, 3}.
+ *
+ * @param a     First operand.
+ * @param b     Second operand.
+ * @param rank  Receives the larger of the two ranks.
+ * @param shape Receives the broadcast extents; room for TENSOR_MAX_RANK of them.
+ * @return true if the shapes are compatible, false otherwise.
+ */
+bool tensor_broadcast_shape(const tensor_t* a, const tensor_t* b, size_t* rank, size_t* shape);
+
+/**
+ * @brief Apply a binary operation element by element into an existing tensor, broadcasting a and b
+ * against each other.
+ *
+ * Before iterating, dimensions of extent 1 are dropped and neighboring dimensions that are laid
+ * out back to back in all three tensors are merged, so contiguous tensors of any shape run as one
+ * flat loop and a broadcast row or column still gets a long unit-stride innermost loop. That loop
+ * has specialized versions for unit strides and for a repeated operand, and an AVX2 build is
+ * chosen at run time when the CPU supports it.
+ *
+ * @param dst       Result with exactly the broadcast shape; may be a or b itself for an in-place
+ *                  operation, but must not otherwise overlap them or repeat elements.
+ * @param a         First operand, or view.
+ * @param b         Second operand, or view.
+ * @param operation The operation to apply.
+ * @return dst on success, NULL if the shapes do not broadcast or dst does not fit.
+ */
+tensor_t* tensor_elementwise_operation_into(
+    tensor_t* dst, const tensor_t* a, const tensor_t* b, tensor_operator_t operation
+);
+
+/**
+ * @brief Apply a binary operation element by element into a new contiguous tensor of the
+ * broadcast shape.
+ *
+ * @return Pointer to the new tensor or NULL on failure.
+ */
+tensor_t*
+tensor_elementwise_operation(const tensor_t* a, const tensor_t* b, tensor_operator_t operation);
+
+/**
+ * @brief Element-wise operations into a new tensor, with broadcasting.
+ */
+tensor_t* tensor_add(const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_subtract(const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_multiply(const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_divide(const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_maximum(const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_minimum(const tensor_t* a, const tensor_t* b);
+
+/**
+ * @brief Element-wise operations into an existing tensor, with broadcasting. Pass a as dst to
+ * update it in place, as in a += b.
+ */
+tensor_t* tensor_add_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_subtract_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_multiply_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_divide_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_maximum_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+tensor_t* tensor_minimum_into(tensor_t* dst, const tensor_t* a, const tensor_t* b);
+
+// Views
+//
+// Views are returned by value and reference the parent's memory without copying or allocating:
+// each one only rewrites the shape, the strides and where the data starts. They stay valid as long
+// as the parent does, writes through a view change the parent, and views of views are allowed.
+// Every operation accepts views, so a consumer that needs unit strides calls tensor_contiguous()
+// only when tensor_is_contiguous() is false. There is nothing to free unless
+// tensor_element_view() was called on a view, in which case tensor_free(&view) releases the
+// pointers only. On failure the view has NULL data and rank 0.
+
+/**
+ * @brief The same elements in row-major order under another shape of the same size.
+ *
+ * Without copying, this is possible when each run of dimensions that is merged or split is laid
+ * out back to back in the parent, as NumPy requires: always for a contiguous tensor, never for
+ * the transpose of a matrix flattened to a vector. Copy with tensor_contiguous() first otherwise.
+ *
+ * @param tensor Tensor, or view, to reshape.
+ * @param rank   The number of dimensions of the view, at most TENSOR_MAX_RANK.
+ * @param shape  The extent of each dimension, with the same product as the shape of tensor.
+ * @return The view, or an empty view with NULL data if the sizes differ or the layout needs a copy.
+ */
+tensor_t tensor_reshape(const tensor_t* tensor, size_t rank, const size_t* shape);
+
+/**
+ * @brief Reorder the dimensions: dimension i of the view is dimension axes[i] of tensor.
+ *
+ * Turning {layers, rows, columns} into channels-last {rows, columns, layers} is
+ * tensor_permute() with the axes {1, 2, 0}.
+ *
+ * @param tensor Tensor, or view, to permute.
+ * @param axes   A permutation of 0 to rank - 1.
+ * @return The view, or an empty view with NULL data if axes is not a permutation.
+ */
+tensor_t tensor_permute(const tensor_t* tensor, const size_t* axes);
+
+/**
+ * @brief Swap two dimensions; the transpose of a matrix is tensor_transpose(tensor, 0, 1).
+ *
+ * @return The view, or an empty view with NULL data if an axis is out of range.
+ */
+tensor_t tensor_transpose(const tensor_t* tensor, size_t first, size_t second);
+
+/**
+ * @brief Every step-th element along one axis: element i of the view along axis is element
+ * start + i * step of tensor. The other dimensions are unchanged.
+ *
+ * A negative step walks backwards from start, so reversing an axis of extent n is a slice from
+ * n - 1 of n elements with a step of -1.
+ *
+ * @param tensor Tensor, or view, to slice.
+ * @param axis   The dimension to slice.
+ * @param start  Index along axis of the first element of the view.
+ * @param count  The extent of the view along axis; 0 gives an empty view.
+ * @param step   Distance between the elements taken, not 0.
+ * @return The view, or an empty view with NULL data if an element falls outside the axis.
+ */
+tensor_t tensor_slice(
+    const tensor_t* tensor, size_t axis, size_t start, size_t count, ptrdiff_t step
+);
+
+/**
+ * @brief Remove dimensions of extent 1, such as the ones tensor_reduce() keeps.
+ *
+ * @param tensor Tensor, or view, to squeeze.
+ * @param axes   TENSOR_AXIS() bits of the dimensions to remove, each of extent 1.
+ * @return The view, or an empty view with NULL data if an axis is out of range or not of extent 1.
+ */
+tensor_t tensor_squeeze(const tensor_t* tensor, unsigned axes);
+
+/**
+ * @brief Insert a dimension of extent 1 before dimension axis, or after the last one if axis is
+ * the rank, so a {columns} vector becomes a {1, columns} row or a {columns, 1} column.
+ *
+ * @return The view, or an empty view with NULL data if axis is past the rank or the rank is full.
+ */
+tensor_t tensor_unsqueeze(const tensor_t* tensor, size_t axis);
+
+/**
+ * @brief Copy the elements of src into an existing tensor, broadcasting src to the shape of dst.
+ *
+ * Both layouts are coalesced as in tensor_elementwise_operation(). When dst and src run along
+ * the same innermost dimension, the copy moves whole runs. When they do not, as for a permuted or
+ * transposed src, the two innermost dimensions are copied in small square tiles that stay in the
+ * L1 cache, so neither tensor is read or written with a large stride across the whole of it; tiles
+ * with unit strides on both sides are transposed in SIMD registers. Destinations larger than the
+ * caches are written with non-temporal stores, which skip reading each line before it is written.
+ *
+ * @param dst Result with the shape src broadcasts to; must not repeat elements or overlap src,
+ *            unless it is src itself.
+ * @param src Tensor, or view, to copy.
+ * @return dst on success, NULL if the shapes do not fit or the tensors overlap.
+ */
+tensor_t* tensor_copy_into(tensor_t* dst, const tensor_t* src);
+
+/**
+ * @brief Copy a tensor, or view, into a new contiguous tensor of the same shape.
+ *
+ * @return Pointer to the new tensor or NULL on failure.
+ */
+tensor_t* tensor_contiguous(const tensor_t* tensor);
+
+// Reductions
+
+/**
+ * @brief Reduce a tensor over a set of axes into an existing tensor.
+ *
+ * The reduced axes are kept with an extent of 1, as with NumPy's keepdims, so the result
+ * broadcasts against src: subtracting the per-layer mean from a {layers, rows, columns} tensor is
+ * tensor_reduce() over TENSOR_AXIS(1) | TENSOR_AXIS(2) followed by tensor_subtract().
+ *
+ * The kept and the reduced dimensions are each coalesced as in tensor_elementwise_operation().
+ * When the reduced elements of one result are contiguous, each result is a horizontal reduction
+ * with several SIMD accumulators. Otherwise, when neighboring results are contiguous, a block of
+ * them is accumulated at once with vertical SIMD, reading src row by row.
+ *
+ * Tensors of TENSOR_PARALLEL_THRESHOLD or more elements are split across the pool by result. A
+ * result reducing that many elements on its own is instead split into TENSOR_PARALLEL_CHUNK
+ * partial reductions, which are combined in order. The chunks only depend on the shapes, so the
+ * results are bit-identical for any thread count, and with no pool at all.
+ *
+ * @param dst       Result with the shape of src, and an extent of 1 along each reduced axis; must
+ *                  not overlap src.
+ * @param src       Tensor, or view, to reduce.
+ * @param axes      TENSOR_AXIS() bits of the axes to reduce, all below the rank of src.
+ * @param reduction The reduction to compute.
+ * @return dst on success, NULL if the axes or the shape of dst are invalid.
+ */
+tensor_t* tensor_reduce_into(
+    tensor_t* dst, const tensor_t* src, unsigned axes, tensor_reduction_t reduction
+);
+
+/**
+ * @brief Reduce a tensor over a set of axes into a new contiguous tensor.
+ *
+ * @return Pointer to the new tensor or NULL on failure.
+ */
+tensor_t* tensor_reduce(const tensor_t* src, unsigned axes, tensor_reduction_t reduction);
+
+/**
+ * @brief Reduce all the elements of a tensor to one value.
+ *
+ * @return The reduced value, or NaN if src is NULL.
+ */
+float tensor_reduce_all(const tensor_t* src, tensor_reduction_t reduction);
+
+/**
+ * @brief Find the position of the largest element over a set of axes.
+ *
+ * Each index counts the reduced elements of one result in row-major order, so for a single axis
+ * it is the index along that axis. Ties go to the first element, and a NaN counts as larger than
+ * any number, as in NumPy.
+ *
+ * @param indices One index per result, in the row-major order of the shape tensor_reduce() would
+ *                produce.
+ * @param src     Tensor, or view, to search.
+ * @param axes    TENSOR_AXIS() bits of the axes to search, all below the rank of src.
+ * @return indices on success, NULL if the axes are invalid or a reduced extent is 0.
+ */
+size_t* tensor_argmax_into(size_t* indices, const tensor_t* src, unsigned axes);
+
+/**
+ * @brief Find the position of the largest element over a set of axes into a new array.
+ *
+ * @return Array of indices to release with free(), or NULL on failure.
+ */
+size_t* tensor_argmax(const tensor_t* src, unsigned axes);
+
+/**
+ * @brief Find the row-major position of the largest element of a tensor.
+ *
+ * @return The position, or SIZE_MAX if src is NULL or empty.
+ */
+size_t tensor_argmax_all(const tensor_t* src);
+
+// Tensor files
+
+/**
+ * @brief Map a tensor file into memory as a read-only tensor, without reading or copying it.
+ *
+ * Only the header is checked up front: the shape, the strides and the size of the file must agree,
+ * and files of another version, byte order or element type are rejected. The elements are then
+ * read by the page faults of whatever touches them, so loading a large file takes as long as a
+ * few system calls, and parts of it that are never used are never read from disk.
+ *
+ * The elements are read-only: tensor_copy_into(), tensor_reduce_into() and the element-wise *_into
+ * functions reject the mapped tensor, or any view of it, as a destination, and writing to them any
+ * other way faults. The mapping stays valid if the file is later removed, but a file modified
+ * while mapped shows through.
+ *
+ * @param path File written by tensor_save() or a tensor_writer_t.
+ * @return The mapped tensor, to release with tensor_free(), or NULL if the file cannot be mapped
+ *         or is not a valid tensor file.
+ */
+tensor_t* tensor_load(const char* path);
+
+/**
+ * @brief Write a tensor to a file that tensor_load() maps back.
+ *
+ * A contiguous tensor is written straight from its data; a view is gathered in row-major order a
+ * TENSOR_PARALLEL_CHUNK of elements at a time, so the file is always contiguous.
+ *
+ * @param tensor Tensor, or view, to write.
+ * @param path   File to create or replace.
+ * @return true on success. On failure the file is removed.
+ */
+bool tensor_save(const tensor_t* tensor, const char* path);
+
+/**
+ * @brief Start a tensor file of the given shape, to fill with tensor_writer_write().
+ *
+ * The header is written immediately and the elements are appended as they are produced, so a
+ * tensor larger than memory can be written without ever being held in full.
+ *
+ * @param path  File to create or replace.
+ * @param rank  The number of dimensions, at most TENSOR_MAX_RANK.
+ * @param shape The extent of each dimension, outermost first.
+ * @return A writer to finish with tensor_writer_close(), or NULL on failure.
+ */
+tensor_writer_t* tensor_writer_open(const char* path, size_t rank, const size_t* shape);
+
+/**
+ * @brief Append the next count elements, in row-major order.
+ *
+ * @return true on success, false if the write fails or goes past the size of the shape. After a
+ *         failure, later writes are ignored and tensor_writer_close() fails.
+ */
+bool tensor_writer_write(tensor_writer_t* writer, const float* elements, size_t count);
+
+/**
+ * @brief Finish a tensor file and free the writer.
+ *
+ * @return true if every element of the shape was written and the file was flushed; otherwise the
+ *         incomplete file is removed and false is returned. NULL returns false.
+ */
+bool tensor_writer_close(tensor_writer_t* writer);
+
 #endif // TENSOR_H
@@ -0,0 +1,274 @@
+/**
+ * Copyright © 2024 Austin Berrio
+ *
+ * @file vec.h
+ *
+ * @brief Fixed-size 2D, 3D and 4D vector value types with inline math
+ *
+ * vec2_t, vec3_t and vec4_t are plain structs passed and returned by value, so they live in
+ * registers or on the stack and never touch the heap. Every function is static inline and small
+ * enough for the compiler to fold into the caller. Use them for per-vertex renderer math and
+ * convert to and from vector_t at API boundaries.
+ *
+ * Only use pure C.
+ * Only use libraries when absolutely necessary.
+ *
+ * @note Prefixing related objects, functions, etc. assists with autocomplete.
+ */
+
+#ifndef VEC_H
+#define VEC_H
+
+#include "vector.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+// Structures
+
+/**
+ * @brief A 2-dimensional vector value. Layout-compatible with SDL_FPoint.
+ */
+typedef struct {
+    float x; ///< The horizontal component.
+    float y; ///< The vertical component.
+} vec2_t;
+
+/**
+ * @brief A 3-dimensional vector value.
+ */
+typedef struct {
+    float x; ///< The horizontal component.
+    float y; ///< The vertical component.
+    float z; ///< The depth component.
+} vec3_t;
+
+/**
+ * @brief A 4-dimensional vector value, typically homogeneous coordinates.
+ */
+typedef struct {
+    float x; ///< The horizontal component.
+    float y; ///< The vertical component.
+    float z; ///< The depth component.
+    float w; ///< The homogeneous component.
+} vec4_t;
+
+// 2D operations
+
+static inline vec2_t vec2_add(vec2_t a, vec2_t b) {
+    return (vec2_t) {a.x + b.x, a.y + b.y};
+}
+
+static inline vec2_t vec2_subtract(vec2_t a, vec2_t b) {
+    return (vec2_t) {a.x - b.x, a.y - b.y};
+}
+
+static inline vec2_t vec2_scale(vec2_t a, float scalar) {
+    return (vec2_t) {a.x * scalar, a.y * scalar};
+}
+
+static inline float vec2_dot(vec2_t a, vec2_t b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+/**
+ * @brief The z component of the 3D cross product of two 2D vectors (the perp-dot product).
+ */
+static inline float vec2_cross(vec2_t a, vec2_t b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+static inline float vec2_magnitude(vec2_t a) {
+    return sqrtf(vec2_dot(a, a));
+}
+
+/**
+ * @brief Normalize a 2D vector. A zero-length vector is returned unchanged.
+ */
+static inline vec2_t vec2_normalize(vec2_t a) {
+    float magnitude = vec2_magnitude(a);
+    return magnitude > 0.0f ? vec2_scale(a, 1.0f / magnitude) : a;
+}
+
+/**
+ * @brief Linear interpolation between a (t = 0) and b (t = 1).
+ */
+static inline vec2_t vec2_lerp(vec2_t a, vec2_t b, float t) {
+    return (vec2_t) {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t};
+}
+
+// 3D operations
+
+static inline vec3_t vec3_add(vec3_t a, vec3_t b) {
+    return (vec3_t) {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+static inline vec3_t vec3_subtract(vec3_t a, vec3_t b) {
+    return (vec3_t) {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static inline vec3_t vec3_scale(vec3_t a, float scalar) {
+    return (vec3_t) {a.x * scalar, a.y * scalar, a.z * scalar};
+}
+
+static inline float vec3_dot(vec3_t a, vec3_t b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static inline vec3_t vec3_cross(vec3_t a, vec3_t b) {
+    return (vec3_t) {
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x,
+    };
+}
+
+static inline float vec3_magnitude(vec3_t a) {
+    return sqrtf(vec3_dot(a, a));
+}
+
+/**
+ * @brief Normalize a 3D vector. A zero-length vector is returned unchanged.
+ */
+static inline vec3_t vec3_normalize(vec3_t a) {
+    float magnitude = vec3_magnitude(a);
+    return magnitude > 0.0f ? vec3_scale(a, 1.0f / magnitude) : a;
+}
+
+/**
+ * @brief Linear interpolation between a (t = 0) and b (t = 1).
+ */
+static inline vec3_t vec3_lerp(vec3_t a, vec3_t b, float t) {
+    return (vec3_t) {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t};
+}
+
+// 4D operations
+
+static inline vec4_t vec4_add(vec4_t a, vec4_t b) {
+    return (vec4_t) {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+
+static inline vec4_t vec4_subtract(vec4_t a, vec4_t b) {
+    return (vec4_t) {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w};
+}
+
+static inline vec4_t vec4_scale(vec4_t a, float scalar) {
+    return (vec4_t) {a.x * scalar, a.y * scalar, a.z * scalar, a.w * scalar};
+}
+
+static inline float vec4_dot(vec4_t a, vec4_t b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+static inline float vec4_magnitude(vec4_t a) {
+    return sqrtf(vec4_dot(a, a));
+}
+
+/**
+ * @brief Normalize a 4D vector. A zero-length vector is returned unchanged.
+ */
+static inline vec4_t vec4_normalize(vec4_t a) {
+    float magnitude = vec4_magnitude(a);
+    return magnitude > 0.0f ? vec4_scale(a, 1.0f / magnitude) : a;
+}
+
+/**
+ * @brief Linear interpolation between a (t = 0) and b (t = 1).
+ */
+static inline vec4_t vec4_lerp(vec4_t a, vec4_t b, float t) {
+    return (vec4_t) {
+        a.x + (b.x - a.x) * t,
+        a.y + (b.y - a.y) * t,
+        a.z + (b.z - a.z) * t,
+        a.w + (b.w - a.w) * t,
+    };
+}
+
+// Special coordinates
+
+/**
+ * @brief Convert polar coordinates (r, θ) to a cartesian 2D vector.
+ */
+static inline vec2_t vec2_from_polar(float r, float theta) {
+    return (vec2_t) {r * cosf(theta), r * sinf(theta)};
+}
+
+/**
+ * @brief Convert a cartesian 2D vector to polar coordinates, returned as (r, θ).
+ */
+static inline vec2_t vec2_to_polar(vec2_t a) {
+    return (vec2_t) {sqrtf(a.x * a.x + a.y * a.y), atan2f(a.y, a.x)};
+}
+
+// Conversion to and from vector_t
+
+/**
+ * @brief Read the first two components of a vector_t.
+ *
+ * @param vector Input vector with at least 2 dimensions
+ * @param out Destination value
+ * @return true on success, false if the vector has too few dimensions
+ */
+static inline bool vec2_from_vector(const vector_t* vector, vec2_t* out) {
+    if (NULL == vector || vector->dimensions < 2) {
+        return false;
+    }
+    *out = (vec2_t) {vector->elements[0], vector->elements[1]};
+    return true;
+}
+
+static inline bool vec3_from_vector(const vector_t* vector, vec3_t* out) {
+    if (NULL == vector || vector->dimensions < 3) {
+        return false;
+    }
+    *out = (vec3_t) {vector->elements[0], vector->elements[1], vector->elements[2]};
+    return true;
+}
+
+static inline bool vec4_from_vector(const vector_t* vector, vec4_t* out) {
+    if (NULL == vector || vector->dimensions < 4) {
+        return false;
+    }
+    const float* e = vector->elements;
+    *out           = (vec4_t) {e[0], e[1], e[2], e[3]};
+    return true;
+}
+
+/**
+ * @brief Write a value into the first components of an existing vector_t.
+ *
+ * @param a Input value
+ * @param vector Destination vector with at least as many dimensions as the value
+ * @return vector on success, NULL if the vector has too few dimensions
+ */
+static inline vector_t* vec2_to_vector(vec2_t a, vector_t* vector) {
+    if (NULL == vector || vector->dimensions < 2) {
+        return NULL;
+    }
+    vector->elements[0] = a.x;
+    vector->elements[1] = a.y;
+    return vector;
+}
+
+static inline vector_t* vec3_to_vector(vec3_t a, vector_t* vector) {
+    if (NULL == vector || vector->dimensions < 3) {
+        return NULL;
+    }
+    vector->elements[0] = a.x;
+    vector->elements[1] = a.y;
+    vector->elements[2] = a.z;
+    return vector;
+}
+
+static inline vector_t* vec4_to_vector(vec4_t a, vector_t* vector) {
+    if (NULL == vector || vector->dimensions < 4) {
+        return NULL;
+    }
+    vector->elements[0] = a.x;
+    vector->elements[1] = a.y;
+    vector->elements[2] = a.z;
+    vector->elements[3] = a.w;
+    return vector;
+}
+
+#endif // VEC_H
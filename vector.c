@@ -12,13 +12,82 @@
  */
 
 #include "vector.h"
+#include "kernels.h"
+#include "simd.h"
+#include "stats.h"
 
 #include <math.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Shared validation for operations on two vectors
+static bool vector_dimensions_match(const vector_t* a, const vector_t* b) {
+    if (a->dimensions != b->dimensions) {
+        fprintf(
+            stderr,
+            "Vector dimensions do not match. Cannot perform operation on vectors of dimensions %zu "
+            "and %zu.\n",
+            a->dimensions,
+            b->dimensions
+        );
+        return false;
+    }
+
+    return true;
+}
+
+// Parallel execution
+static pool_t* vector_pool = NULL;
+
+void vector_set_pool(pool_t* pool) {
+    vector_pool = pool;
+}
+
+pool_t* vector_get_pool(void) {
+    return vector_pool;
+}
+
+// Operands of a reduction over one or two arrays
+typedef struct {
+    const float* a;
+    const float* b;
+} vector_reduction_t;
+
+static float vector_sum_chunk(void* context, size_t begin, size_t end) {
+    const vector_reduction_t* job = (const vector_reduction_t*) context;
+    return stats_sum(job->a + begin, end - begin, SUMMATION_PAIRWISE);
+}
+
+static float vector_sum_squares_chunk(void* context, size_t begin, size_t end) {
+    const vector_reduction_t* job = (const vector_reduction_t*) context;
+    return simd_sum_squares(job->a + begin, end - begin);
+}
+
+static float vector_dot_chunk(void* context, size_t begin, size_t end) {
+    const vector_reduction_t* job = (const vector_reduction_t*) context;
+    return simd_dot(job->a + begin, job->b + begin, end - begin);
+}
+
+static float vector_distance_squared_chunk(void* context, size_t begin, size_t end) {
+    const vector_reduction_t* job = (const vector_reduction_t*) context;
+    return simd_distance_squared(job->a + begin, job->b + begin, end - begin);
+}
+
+// Reduce small vectors in one call, large ones per chunk on the pool
+static float vector_reduce(pool_reduce_t reduce, const float* a, const float* b, size_t n) {
+    vector_reduction_t job = {a, b};
+
+    if (n < VECTOR_PARALLEL_THRESHOLD) {
+        return reduce(&job, 0, n);
+    }
+
+    return pool_reduce(vector_pool, n, VECTOR_PARALLEL_CHUNK, reduce, &job);
+}
+
 // Vector lifecycle management
 vector_t* vector_create(size_t dimensions) {
     vector_t* vector = (vector_t*) malloc(sizeof(vector_t));
@@ -38,31 +107,95 @@ vector_t* vector_create(size_t dimensions) {
     memset(vector->elements, 0, dimensions * sizeof(float));
 
     vector->dimensions = dimensions; // track the dimensions of the vector to prevent decay.
+    vector->storage    = VECTOR_STORAGE_HEAP;
+
+    return vector;
+}
+
+vector_t* vector_create_aligned(size_t dimensions) {
+    // The header occupies the first cache line; the elements start on the next boundary
+    _Static_assert(sizeof(vector_t) <= VECTOR_ALIGNMENT, "vector_t must fit in one cache line");
+
+    // The header and the rounding up to the alignment each add at most one cache line
+    if (dimensions > (SIZE_MAX - 2 * VECTOR_ALIGNMENT) / sizeof(float)) {
+        fprintf(stderr, "Vector of %zu elements is too large.\n", dimensions);
+        return NULL;
+    }
+
+    size_t size = VECTOR_ALIGNMENT + dimensions * sizeof(float);
+    size        = (size + VECTOR_ALIGNMENT - 1) & ~((size_t) VECTOR_ALIGNMENT - 1);
+
+    unsigned char* block = (unsigned char*) aligned_alloc(VECTOR_ALIGNMENT, size);
+    if (NULL == block) { // If no memory was allocated
+        fprintf(stderr, "Failed to allocate %zu bytes to aligned vector_t.\n", size);
+        return NULL; // Early return if vector creation failed
+    }
+
+    vector_t* vector   = (vector_t*) block;
+    vector->elements   = (float*) (block + VECTOR_ALIGNMENT);
+    vector->dimensions = dimensions;
+    vector->storage    = VECTOR_STORAGE_ALIGNED;
+
+    memset(vector->elements, 0, dimensions * sizeof(float));
+
+    return vector;
+}
+
+vector_t* vector_create_in(arena_t* arena, size_t dimensions) {
+    vector_t* vector = (vector_t*) arena_alloc(arena, sizeof(vector_t), _Alignof(vector_t));
+    if (NULL == vector) {
+        return NULL; // arena_alloc logs the error for us
+    }
+
+    vector->elements = (float*) arena_alloc(arena, dimensions * sizeof(float), VECTOR_ALIGNMENT);
+    if (NULL == vector->elements) {
+        return NULL; // the header is reclaimed with the rest of the arena
+    }
+
+    memset(vector->elements, 0, dimensions * sizeof(float));
+
+    vector->dimensions = dimensions;
+    vector->storage    = VECTOR_STORAGE_ARENA;
 
     return vector;
 }
 
 void vector_free(vector_t* vector) {
-    if (vector->elements) {
+    // Arena vectors are released all at once by arena_reset(); views own nothing at all
+    if (NULL == vector || VECTOR_STORAGE_ARENA == vector->storage
+        || VECTOR_STORAGE_VIEW == vector->storage) {
+        return;
+    }
+
+    // Aligned elements live in the header's block and aliased elements belong to another vector
+    if (VECTOR_STORAGE_HEAP == vector->storage && vector->elements) {
         free(vector->elements);
     }
 
-    if (vector) {
-        free(vector);
+    free(vector);
+}
+
+vector_t* vector_copy_into(vector_t* dst, const vector_t* src) {
+    if (NULL == dst || NULL == src || !vector_dimensions_match(dst, src)) {
+        return NULL;
+    }
+
+    if (dst->elements != src->elements) {
+        memmove(dst->elements, src->elements, src->dimensions * sizeof(float));
     }
+
+    return dst;
 }
 
 vector_t* vector_deep_copy(const vector_t* vector) {
-    vector_t* deep_copy = vector_create(vector->dimensions);
+    vector_t* deep_copy = (VECTOR_STORAGE_ALIGNED == vector->storage)
+                              ? vector_create_aligned(vector->dimensions)
+                              : vector_create(vector->dimensions);
     if (NULL == deep_copy) {
         return NULL;
     }
 
-    for (size_t i = 0; i < vector->dimensions; ++i) {
-        deep_copy->elements[i] = vector->elements[i];
-    }
-
-    return deep_copy;
+    return vector_copy_into(deep_copy, vector);
 }
 
 vector_t* vector_shallow_copy(const vector_t* vector) {
@@ -80,25 +213,26 @@ vector_t* vector_shallow_copy(const vector_t* vector) {
     // Copy all fields except elements (pointer to an array)
     new_vector->dimensions = vector->dimensions;
 
-    // Assign the existing pointer to the new Vector structure
+    // Assign the existing pointer to the new Vector structure and mark it as borrowed
     new_vector->elements = vector->elements;
+    new_vector->storage  = VECTOR_STORAGE_ALIAS;
 
     return new_vector;
 }
 
 // Vector mathematical operations
 float vector_magnitude(const vector_t* vector) {
-    float sum = 0;
-
     // sum the square of the elements for n-dimensional vectors
-    for (size_t i = 0; i < vector->dimensions; i++) {
-        sum += vector->elements[i] * vector->elements[i];
-    }
+    float sum = vector_reduce(vector_sum_squares_chunk, vector->elements, NULL, vector->dimensions);
 
-    return sqrt(sum);
+    return sqrtf(sum);
 }
 
-vector_t* vector_normalize(vector_t* vector, bool inplace) {
+vector_t* vector_normalize_into(vector_t* dst, const vector_t* vector) {
+    if (NULL == dst || NULL == vector || !vector_dimensions_match(dst, vector)) {
+        return NULL;
+    }
+
     float magnitude = vector_magnitude(vector);
 
     if (0 == magnitude) {
@@ -106,13 +240,13 @@ vector_t* vector_normalize(vector_t* vector, bool inplace) {
         return NULL;
     }
 
-    if (inplace) {
-        // scale the elements down by the magnitude to produce a unit vector
-        for (size_t i = 0; i < vector->dimensions; i++) {
-            vector->elements[i] /= magnitude;
-        }
+    // scale the elements down by the magnitude to produce a unit vector
+    return scalar_elementwise_operation_into(dst, vector, magnitude, scalar_divide);
+}
 
-        return vector;
+vector_t* vector_normalize(vector_t* vector, bool inplace) {
+    if (inplace) {
+        return vector_normalize_into(vector, vector);
     }
 
     vector_t* unit = vector_create(vector->dimensions);
@@ -121,44 +255,40 @@ vector_t* vector_normalize(vector_t* vector, bool inplace) {
         return NULL;
     }
 
-    for (size_t i = 0; i < vector->dimensions; i++) {
-        unit->elements[i] = vector->elements[i] / magnitude;
+    if (NULL == vector_normalize_into(unit, vector)) {
+        vector_free(unit);
+        return NULL;
     }
 
     return unit;
 }
 
 float vector_distance(const vector_t* a, const vector_t* b) {
-    float distance_squared = 0.0f;
-
-    if (a->dimensions != b->dimensions) {
-        fprintf(
-            stderr,
-            "Vector dimensions do not match. Cannot perform operation on vectors of dimensions %zu "
-            "and %zu.\n",
-            a->dimensions,
-            b->dimensions
-        );
+    if (!vector_dimensions_match(a, b)) {
         return NAN;
     }
 
-    for (size_t i = 0; i < a->dimensions; ++i) {
-        distance_squared += (a->elements[i] - b->elements[i]) * (a->elements[i] - b->elements[i]);
-    }
+    float distance_squared
+        = vector_reduce(vector_distance_squared_chunk, a->elements, b->elements, a->dimensions);
 
     return sqrtf(distance_squared);
 }
 
+vector_t* vector_scale_into(vector_t* dst, const vector_t* vector, float scalar) {
+    if (NULL == dst || NULL == vector || !vector_dimensions_match(dst, vector)) {
+        return NULL;
+    }
+
+    return scalar_elementwise_operation_into(dst, vector, scalar, scalar_multiply);
+}
+
 vector_t* vector_scale(vector_t* vector, float scalar, bool inplace) {
     if (vector == NULL) {
         return NULL;
     }
 
     if (inplace) { // block out-of-place vector scaling if in-place is true
-        for (size_t i = 0; i < vector->dimensions; ++i) {
-            vector->elements[i] *= scalar; // scale the vector in-place
-        }
-        return vector; // return the scaled vector
+        return vector_scale_into(vector, vector, scalar);
     }
 
     // perform out-of-place vector scaling
@@ -168,11 +298,7 @@ vector_t* vector_scale(vector_t* vector, float scalar, bool inplace) {
         return NULL;
     }
 
-    for (size_t i = 0; i < vector->dimensions; ++i) {
-        scaled_vector->elements[i] = vector->elements[i] * scalar;
-    }
-
-    return scaled_vector;
+    return vector_scale_into(scaled_vector, vector, scalar);
 }
 
 float vector_mean(const vector_t* vector) {
@@ -180,35 +306,85 @@ float vector_mean(const vector_t* vector) {
         return NAN; // Return NAN for invalid input
     }
 
-    float sum = 0.0f;
-    for (size_t i = 0; i < vector->dimensions; i++) {
-        if (isnan(vector->elements[i])) {
-            // Log error and return NAN if any element is NaN
-            fprintf(stderr, "NaN element found at index %zu.\n", i);
-            return NAN;
+    // Pairwise summation keeps the error at O(log n) for very long vectors
+    float sum = vector_reduce(vector_sum_chunk, vector->elements, NULL, vector->dimensions);
+
+    // NaN propagates through the sum, so only rescan to report it when the sum is NaN
+    if (isnan(sum)) {
+        for (size_t i = 0; i < vector->dimensions; i++) {
+            if (isnan(vector->elements[i])) {
+                // Log error and return NAN if any element is NaN
+                fprintf(stderr, "NaN element found at index %zu.\n", i);
+                return NAN;
+            }
         }
-        sum += vector->elements[i];
     }
 
     return sum / vector->dimensions; // Return the mean
 }
 
+float vector_low_pass_filter(const vector_t* vector, float alpha) {
+    if (NULL == vector || 0 == vector->dimensions) {
+        return NAN; // Return NAN for invalid input
+    }
+
+    if (!(alpha > 0.0f && alpha <= 1.0f)) {
+        fprintf(stderr, "Smoothing factor %f must be in (0, 1].\n", alpha);
+        return NAN;
+    }
+
+    // Only the average is returned, so skip the sum, deviation and extrema passes of stats_update()
+    return stats_ema(vector->elements, vector->dimensions, alpha);
+}
+
+typedef struct {
+    float*       dst;
+    const float* a;
+    float        min;
+    float        max;
+} vector_clip_job_t;
+
+static void vector_clip_chunk(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    const vector_clip_job_t* job = (const vector_clip_job_t*) context;
+
+    for (size_t i = begin; i < end; i++) {
+        if (job->a[i] < job->min) {
+            job->dst[i] = job->min;
+        } else if (job->a[i] > job->max) {
+            job->dst[i] = job->max;
+        } else {
+            job->dst[i] = job->a[i];
+        }
+    }
+}
+
+vector_t* vector_clip_into(vector_t* dst, const vector_t* vector, float min, float max) {
+    if (NULL == dst || NULL == vector || 0 == vector->dimensions
+        || !vector_dimensions_match(dst, vector)) {
+        return NULL;
+    }
+
+    vector_clip_job_t job = {dst->elements, vector->elements, min, max};
+    const size_t      n   = vector->dimensions;
+
+    if (n < VECTOR_PARALLEL_THRESHOLD) {
+        vector_clip_chunk(&job, 0, 0, n);
+    } else {
+        pool_for(vector_pool, n, VECTOR_PARALLEL_CHUNK, vector_clip_chunk, &job);
+    }
+
+    return dst;
+}
+
 vector_t* vector_clip(vector_t* vector, float min, float max, bool inplace) {
     if (NULL == vector || 0 == vector->dimensions) {
         return NULL;
     }
 
     if (inplace) {
-        for (size_t i = 0; i < vector->dimensions; i++) {
-            if (vector->elements[i] < min) {
-                vector->elements[i] = min;
-            }
-            if (vector->elements[i] > max) {
-                vector->elements[i] = max;
-            }
-        }
-
-        return vector; // return as soon as possible
+        return vector_clip_into(vector, vector, min, max); // return as soon as possible
     }
 
     // create a vector if !inplace
@@ -217,18 +393,8 @@ vector_t* vector_clip(vector_t* vector, float min, float max, bool inplace) {
         return NULL; // NOTE: we can return and not log because vector_create logs the error for us
     }
 
-    for (size_t i = 0; i < vector->dimensions; i++) {
-        if (vector->elements[i] < min) {
-            clipped_vector->elements[i] = min;
-        } else if (vector->elements[i] > max) {
-            clipped_vector->elements[i] = max;
-        } else {
-            clipped_vector->elements[i] = vector->elements[i];
-        }
-    }
-
     // Return the newly created clipped vector
-    return clipped_vector;
+    return vector_clip_into(clipped_vector, vector, min, max);
 }
 
 // Helper function for element-wise operations
@@ -252,7 +418,71 @@ float scalar_divide(float x, float y) {
     return x / y;
 }
 
+// Element-wise executors
+//
+// Known scalar_* helpers run through the specialized kernels in kernels.h, shared with expr.c.
+
+// One element-wise operation over a range; the vector operand b is NULL for a scalar operand
+typedef struct {
+    float*       dst;
+    const float* a;
+    const float* b;
+    float        scalar;
+    float (*operation)(float, float);
+    atomic_size_t zeros; ///< Zero divisors found by all chunks.
+} vector_elementwise_job_t;
+
+static void vector_elementwise_task(void* context, size_t chunk, size_t begin, size_t end) {
+    (void) chunk;
+
+    vector_elementwise_job_t* job = (vector_elementwise_job_t*) context;
+    size_t                    zeros;
+
+    if (NULL == job->b) {
+        zeros = scalar_elementwise_chunk(
+            job->dst + begin, job->a + begin, job->scalar, end - begin, job->operation
+        );
+    } else {
+        zeros = vector_elementwise_chunk(
+            job->dst + begin, job->a + begin, job->b + begin, end - begin, job->operation
+        );
+    }
+
+    if (zeros > 0) {
+        atomic_fetch_add_explicit(&job->zeros, zeros, memory_order_relaxed);
+    }
+}
+
+// Run small jobs directly, large ones per chunk on the pool; returns the number of zero divisors
+static size_t vector_elementwise_run(vector_elementwise_job_t* job, size_t n) {
+    if (n < VECTOR_PARALLEL_THRESHOLD) {
+        vector_elementwise_task(job, 0, 0, n);
+    } else {
+        pool_for(vector_pool, n, VECTOR_PARALLEL_CHUNK, vector_elementwise_task, job);
+    }
+
+    return atomic_load_explicit(&job->zeros, memory_order_relaxed);
+}
+
 // Function to perform element-wise operation between a vector and scalar value
+vector_t* scalar_elementwise_operation_into(
+    vector_t* dst, const vector_t* a, const float b, float (*operation)(float, float)
+) {
+    if (NULL == dst || NULL == a || !vector_dimensions_match(dst, a)) {
+        return NULL;
+    }
+
+    vector_elementwise_job_t job   = {dst->elements, a->elements, NULL, b, operation, 0};
+    size_t                   zeros = vector_elementwise_run(&job, a->dimensions);
+
+    // Division by zero is reported once per call rather than once per element
+    if (zeros > 0) {
+        fprintf(stderr, "Division by zero is undefined. Cannot divide %zu elements by 0.\n", zeros);
+    }
+
+    return dst;
+}
+
 vector_t*
 scalar_elementwise_operation(const vector_t* a, const float b, float (*operation)(float, float)) {
     vector_t* c = vector_create(a->dimensions);
@@ -261,12 +491,7 @@ scalar_elementwise_operation(const vector_t* a, const float b, float (*operation
         return NULL;
     }
 
-    // Perform element-wise operation
-    for (size_t i = 0; i < a->dimensions; i++) {
-        c->elements[i] = operation(a->elements[i], b);
-    }
-
-    return c;
+    return scalar_elementwise_operation_into(c, a, b, operation);
 }
 
 vector_t* vector_scalar_add(const vector_t* a, const float b) {
@@ -285,18 +510,47 @@ vector_t* vector_scalar_divide(const vector_t* a, const float b) {
     return scalar_elementwise_operation(a, b, scalar_divide);
 }
 
+vector_t* vector_scalar_add_into(vector_t* dst, const vector_t* a, const float b) {
+    return scalar_elementwise_operation_into(dst, a, b, scalar_add);
+}
+
+vector_t* vector_scalar_subtract_into(vector_t* dst, const vector_t* a, const float b) {
+    return scalar_elementwise_operation_into(dst, a, b, scalar_subtract);
+}
+
+vector_t* vector_scalar_multiply_into(vector_t* dst, const vector_t* a, const float b) {
+    return scalar_elementwise_operation_into(dst, a, b, scalar_multiply);
+}
+
+vector_t* vector_scalar_divide_into(vector_t* dst, const vector_t* a, const float b) {
+    return scalar_elementwise_operation_into(dst, a, b, scalar_divide);
+}
+
 // Function to perform element-wise operation on two vectors
+vector_t* vector_elementwise_operation_into(
+    vector_t* dst, const vector_t* a, const vector_t* b, float (*operation)(float, float)
+) {
+    if (NULL == dst || NULL == a || NULL == b || !vector_dimensions_match(a, b)
+        || !vector_dimensions_match(dst, a)) {
+        return NULL;
+    }
+
+    const size_t             n     = a->dimensions;
+    vector_elementwise_job_t job   = {dst->elements, a->elements, b->elements, 0.0f, operation, 0};
+    size_t                   zeros = vector_elementwise_run(&job, n);
+
+    // Division by zero is reported once per call rather than once per element
+    if (zeros > 0) {
+        fprintf(stderr, "Division by zero is undefined. %zu of %zu divisors are zero.\n", zeros, n);
+    }
+
+    return dst;
+}
+
 vector_t* vector_elementwise_operation(
     const vector_t* a, const vector_t* b, float (*operation)(float, float)
 ) {
-    if (a->dimensions != b->dimensions) {
-        fprintf(
-            stderr,
-            "Vector dimensions do not match. Cannot perform operation on vectors of dimensions %zu "
-            "and %zu.\n",
-            a->dimensions,
-            b->dimensions
-        );
+    if (!vector_dimensions_match(a, b)) {
         return NULL;
     }
 
@@ -306,12 +560,7 @@ vector_t* vector_elementwise_operation(
         return NULL;
     }
 
-    // Perform element-wise operation
-    for (size_t i = 0; i < a->dimensions; i++) {
-        c->elements[i] = operation(a->elements[i], b->elements[i]);
-    }
-
-    return c;
+    return vector_elementwise_operation_into(c, a, b, operation);
 }
 
 // Updated functions using the new helper function
@@ -331,29 +580,51 @@ vector_t* vector_vector_divide(const vector_t* a, const vector_t* b) {
     return vector_elementwise_operation(a, b, scalar_divide);
 }
 
+vector_t* vector_vector_add_into(vector_t* dst, const vector_t* a, const vector_t* b) {
+    return vector_elementwise_operation_into(dst, a, b, scalar_add);
+}
+
+vector_t* vector_vector_subtract_into(vector_t* dst, const vector_t* a, const vector_t* b) {
+    return vector_elementwise_operation_into(dst, a, b, scalar_subtract);
+}
+
+vector_t* vector_vector_multiply_into(vector_t* dst, const vector_t* a, const vector_t* b) {
+    return vector_elementwise_operation_into(dst, a, b, scalar_multiply);
+}
+
+vector_t* vector_vector_divide_into(vector_t* dst, const vector_t* a, const vector_t* b) {
+    return vector_elementwise_operation_into(dst, a, b, scalar_divide);
+}
+
 // dot product is n-dimensional
 float vector_dot_product(const vector_t* a, const vector_t* b) {
-    if (a->dimensions != b->dimensions) {
-        fprintf(
-            stderr,
-            "Vector dimensions do not match. Cannot perform operation on vectors of dimensions %zu "
-            "and %zu.\n",
-            a->dimensions,
-            b->dimensions
-        );
+    if (!vector_dimensions_match(a, b)) {
         return NAN;
     }
 
-    float product = 0.0f;
+    return vector_reduce(vector_dot_chunk, a->elements, b->elements, a->dimensions);
+}
 
-    for (size_t i = 0; i < a->dimensions; i++) {
-        product += a->elements[i] * b->elements[i];
+// cross product is 3-dimensional
+vector_t* vector_cross_product_into(vector_t* dst, const vector_t* a, const vector_t* b) {
+    // Ensure all vectors are 3-dimensional.
+    if (NULL == dst || a->dimensions != 3 || b->dimensions != 3 || dst->dimensions != 3) {
+        fprintf(stderr, "Cross product is only defined for 3-dimensional vectors.\n");
+        return NULL;
     }
 
-    return product;
+    // Calculate the components first so dst may alias a or b.
+    float x = a->elements[1] * b->elements[2] - a->elements[2] * b->elements[1];
+    float y = a->elements[2] * b->elements[0] - a->elements[0] * b->elements[2];
+    float z = a->elements[0] * b->elements[1] - a->elements[1] * b->elements[0];
+
+    dst->elements[0] = x;
+    dst->elements[1] = y;
+    dst->elements[2] = z;
+
+    return dst;
 }
 
-// cross product is 3-dimensional
 vector_t* vector_cross_product(const vector_t* a, const vector_t* b) {
     // Ensure both vectors are 3-dimensional.
     if (a->dimensions != 3 || b->dimensions != 3) {
@@ -367,12 +638,7 @@ vector_t* vector_cross_product(const vector_t* a, const vector_t* b) {
         return NULL;
     }
 
-    // Calculate the components of the cross product vector.
-    result->elements[0] = a->elements[1] * b->elements[2] - a->elements[2] * b->elements[1];
-    result->elements[1] = a->elements[2] * b->elements[0] - a->elements[0] * b->elements[2];
-    result->elements[2] = a->elements[0] * b->elements[1] - a->elements[1] * b->elements[0];
-
-    return result;
+    return vector_cross_product_into(result, a, b);
 }
 
 // Polar coordinates are defined as the ordered pair (r, θ) names a point r units from origin along
@@ -396,6 +662,23 @@ vector_t* vector_cross_product(const vector_t* a, const vector_t* b) {
 // TODO: Triple check the conversions between coordinate systems
 
 // x = r cos θ and y = r sin θ
+vector_t* vector_polar_to_cartesian_into(vector_t* dst, const vector_t* polar_vector) {
+    if (NULL == dst || NULL == polar_vector || polar_vector->dimensions != 2
+        || dst->dimensions != 2) {
+        return NULL; // Return NULL if input is invalid
+    }
+
+    // radii/radius/ray all seem equivalently apropos
+    // perhaps ray is best suited?
+    float r     = polar_vector->elements[0];
+    float theta = polar_vector->elements[1];
+
+    dst->elements[0] = r * cosf(theta); // x = r * cos(θ)
+    dst->elements[1] = r * sinf(theta); // y = r * sin(θ)
+
+    return dst;
+}
+
 vector_t* vector_polar_to_cartesian(const vector_t* polar_vector) {
     if (NULL == polar_vector || polar_vector->dimensions != 2) {
         return NULL; // Return NULL if input is invalid
@@ -406,18 +689,25 @@ vector_t* vector_polar_to_cartesian(const vector_t* polar_vector) {
         return NULL; // Return NULL if memory allocation fails
     }
 
-    // radii/radius/ray all seem equivalently apropos
-    // perhaps ray is best suited?
-    float r     = polar_vector->elements[0];
-    float theta = polar_vector->elements[1];
+    return vector_polar_to_cartesian_into(cartesian_vector, polar_vector);
+}
+
+// r = ± √(x^2 + y^2) and tan θ = y / x
+vector_t* vector_cartesian_to_polar_into(vector_t* dst, const vector_t* cartesian_vector) {
+    if (NULL == dst || NULL == cartesian_vector || cartesian_vector->dimensions != 2
+        || dst->dimensions != 2) {
+        return NULL; // Return NULL if input is invalid
+    }
+
+    float x = cartesian_vector->elements[0];
+    float y = cartesian_vector->elements[1];
 
-    cartesian_vector->elements[0] = r * cosf(theta); // x = r * cos(θ)
-    cartesian_vector->elements[1] = r * sinf(theta); // y = r * sin(θ)
+    dst->elements[0] = sqrtf(x * x + y * y); // r = √(x^2 + y^2)
+    dst->elements[1] = atan2f(y, x);         // θ = atan (y, x)
 
-    return cartesian_vector;
+    return dst;
 }
 
-// r = ± √(x^2 + y^2) and tan θ = y / x
 vector_t* vector_cartesian_to_polar(const vector_t* cartesian_vector) {
     if (NULL == cartesian_vector || cartesian_vector->dimensions != 2) {
         return NULL; // Return NULL if input is invalid
@@ -428,11 +718,37 @@ vector_t* vector_cartesian_to_polar(const vector_t* cartesian_vector) {
         return NULL; // Return NULL if memory allocation fails
     }
 
-    float x = cartesian_vector->elements[0];
-    float y = cartesian_vector->elements[1];
+    return vector_cartesian_to_polar_into(polar_vector, cartesian_vector);
+}
 
-    polar_vector->elements[0] = sqrtf(x * x + y * y); // r = √(x^2 + y^2)
-    polar_vector->elements[1] = atan2f(y, x);         // θ = atan (y, x)
+void vector_polar_to_cartesian_array(
+    const float* radii, const float* angles, float* xs, float* ys, size_t count, bool approximate
+) {
+    if (approximate) {
+        simd_polar_to_cartesian(radii, angles, xs, ys, count);
+        return;
+    }
 
-    return polar_vector;
+    for (size_t i = 0; i < count; i++) {
+        float r     = radii[i];
+        float theta = angles[i];
+        xs[i]       = r * cosf(theta); // x = r * cos(θ)
+        ys[i]       = r * sinf(theta); // y = r * sin(θ)
+    }
+}
+
+void vector_cartesian_to_polar_array(
+    const float* xs, const float* ys, float* radii, float* angles, size_t count, bool approximate
+) {
+    if (approximate) {
+        simd_cartesian_to_polar(xs, ys, radii, angles, count);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        float x   = xs[i];
+        float y   = ys[i];
+        radii[i]  = sqrtf(x * x + y * y); // r = √(x^2 + y^2)
+        angles[i] = atan2f(y, x);         // θ = atan (y, x)
+    }
 }
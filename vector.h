@@ -16,11 +16,32 @@
 #ifndef VECTORS_H
 #define VECTORS_H
 
+#include "arena.h"
+#include "pool.h"
+
 #include <stdbool.h>
 #include <stdlib.h>
 
 // Vector lifecycle management
 
+/**
+ * @brief Alignment in bytes of the elements of vectors created by vector_create_aligned().
+ *
+ * One cache line, which is also wide enough for any SIMD register up to AVX-512.
+ */
+#define VECTOR_ALIGNMENT 64
+
+/**
+ * @brief Describes who owns the memory behind a vector, so vector_free() releases it correctly.
+ */
+typedef enum {
+    VECTOR_STORAGE_HEAP,    /**< Header and elements are separate heap allocations */
+    VECTOR_STORAGE_ALIGNED, /**< Header and aligned elements share a single heap allocation */
+    VECTOR_STORAGE_ALIAS,   /**< Header is owned; elements borrow another vector's memory */
+    VECTOR_STORAGE_ARENA,   /**< Header and elements belong to an arena */
+    VECTOR_STORAGE_VIEW,    /**< Header is a value and elements borrow another object's memory */
+} vector_storage_t;
+
 /**
  * @brief A structure representing an N-dimensional vector.
  *
@@ -29,10 +50,12 @@
  *
  * @param elements   One-dimensional array of elements representing a vector.
  * @param dimensions The number of dimensions for the vector.
+ * @param storage    How the elements were allocated.
  */
 typedef struct {
-    float* elements;   ///< One-dimensional array of elements representing a vector.
-    size_t dimensions; ///< The number of dimensions for the vector.
+    float*           elements;   ///< One-dimensional array of elements representing a vector.
+    size_t           dimensions; ///< The number of dimensions for the vector.
+    vector_storage_t storage;    ///< How the elements were allocated.
 } vector_t;
 
 /**
@@ -46,16 +69,73 @@ typedef struct {
  */
 vector_t* vector_create(size_t dimensions);
 
+/**
+ * @brief Create a new N-dimensional vector in a single, cache-line-aligned allocation
+ *
+ * The header and the elements are carved out of one block, with the elements starting on a
+ * VECTOR_ALIGNMENT boundary. This halves the allocator traffic of vector_create(), keeps the header
+ * and data adjacent in memory, and allows aligned SIMD loads. The values are set to zero.
+ *
+ * @param dimensions Number of dimensions for the vector
+ * @return A pointer to the newly created vector
+ */
+vector_t* vector_create_aligned(size_t dimensions);
+
+/**
+ * @brief Create a new N-dimensional vector inside an arena
+ *
+ * The header and the VECTOR_ALIGNMENT-aligned elements are bump-allocated from the arena, so the
+ * call never touches malloc. The vector is released by arena_reset(); vector_free() on it is a
+ * no-op. The values are set to zero.
+ *
+ * @param arena Arena to allocate from
+ * @param dimensions Number of dimensions for the vector
+ * @return A pointer to the newly created vector, or NULL if the arena is exhausted
+ */
+vector_t* vector_create_in(arena_t* arena, size_t dimensions);
+
 /**
  * @brief Free an allocated N-dimensional vector
  *
  * This function deallocates memory associated with a given vector, releasing any resources used
- * during its creation.
+ * during its creation. Shallow copies only release their own header, never the shared elements.
  *
  * @param vector A pointer to the vector to be freed
  */
 void vector_free(vector_t* vector);
 
+// Parallel execution
+
+/**
+ * @brief Vectors with at least this many dimensions are processed in chunks, in parallel when a
+ * pool is set. Smaller vectors always run serially on the caller.
+ */
+#define VECTOR_PARALLEL_THRESHOLD (1 << 18)
+
+/**
+ * @brief Elements per chunk of a parallel operation; 256 KiB of floats, sized for the L2 cache.
+ */
+#define VECTOR_PARALLEL_CHUNK (1 << 16)
+
+/**
+ * @brief Set the pool used to parallelize large vector operations.
+ *
+ * Element-wise operations, scale, normalize, clip, dot product, magnitude, distance and mean split
+ * vectors of VECTOR_PARALLEL_THRESHOLD or more dimensions into VECTOR_PARALLEL_CHUNK chunks. Chunk
+ * boundaries do not depend on the pool, so reductions return bit-identical results for any thread
+ * count, and with no pool at all.
+ *
+ * With a pool set, user-defined element-wise operations may run on several threads at once.
+ *
+ * @param pool Pool to use, or NULL to run serially (the default)
+ */
+void vector_set_pool(pool_t* pool);
+
+/**
+ * @brief Return the pool used to parallelize large vector operations, or NULL.
+ */
+pool_t* vector_get_pool(void);
+
 // Element-wise operations
 
 /**
@@ -79,6 +159,9 @@ float scalar_divide(float x, float y);
  * This function applies a given operation to each corresponding pair of elements in two vectors and
  * returns the resulting vector.
  *
+ * @note The scalar_* helpers are recognized and executed by specialized, vectorizable loops rather
+ * than one indirect call per element. Division by zero is reported once per call.
+ *
  * @param a First input vector
  * @param b Second input scalar
  * @param operation A pointer to the function performing the element-wise operation
@@ -87,6 +170,22 @@ float scalar_divide(float x, float y);
 vector_t*
 scalar_elementwise_operation(const vector_t* a, const float b, float (*operation)(float, float));
 
+/**
+ * @brief Executor for element-wise vector-to-scalar functions into a destination vector
+ *
+ * Identical to scalar_elementwise_operation(), but writes the result into a caller-supplied vector
+ * instead of allocating one. The destination may alias the input (dst == a).
+ *
+ * @param dst Destination vector with the same dimensions as a
+ * @param a First input vector
+ * @param b Second input scalar
+ * @param operation A pointer to the function performing the element-wise operation
+ * @return dst on success, NULL if the dimensions do not match
+ */
+vector_t* scalar_elementwise_operation_into(
+    vector_t* dst, const vector_t* a, const float b, float (*operation)(float, float)
+);
+
 // Scalar based vector operations
 
 /**
@@ -131,6 +230,9 @@ vector_t* vector_scalar_divide(const vector_t* a, const float b);
  * This function applies a given operation to each corresponding pair of elements in two vectors and
  * returns the resulting vector.
  *
+ * @note The scalar_* helpers are recognized and executed by specialized, vectorizable loops rather
+ * than one indirect call per element. Division by zero is reported once per call.
+ *
  * @param a First input vector
  * @param b Second input vector
  * @param operation A pointer to the function performing the element-wise operation
@@ -140,6 +242,22 @@ vector_t* vector_elementwise_operation(
     const vector_t* a, const vector_t* b, float (*operation)(float, float)
 );
 
+/**
+ * @brief Executor for element-wise vector-to-vector functions into a destination vector
+ *
+ * Identical to vector_elementwise_operation(), but writes the result into a caller-supplied vector
+ * instead of allocating one. The destination may alias either input (dst == a or dst == b).
+ *
+ * @param dst Destination vector with the same dimensions as a and b
+ * @param a First input vector
+ * @param b Second input vector
+ * @param operation A pointer to the function performing the element-wise operation
+ * @return dst on success, NULL if the dimensions do not match
+ */
+vector_t* vector_elementwise_operation_into(
+    vector_t* dst, const vector_t* a, const vector_t* b, float (*operation)(float, float)
+);
+
 // Vector based operations
 
 /**
@@ -184,7 +302,7 @@ vector_t* vector_vector_divide(const vector_t* a, const vector_t* b);
  * @brief Copy a given N-dimensional vector
  *
  * @note This function creates a deep copy of the input vector by allocating new memory and
- * duplicating its contents.
+ * duplicating its contents. Aligned vectors produce aligned copies.
  *
  * @param vector Input vector
  * @return A pointer to the deep copied vector
@@ -195,7 +313,8 @@ vector_t* vector_deep_copy(const vector_t* vector);
  * @brief Create a shallow copy of an N-dimensional vector
  *
  * @note This function returns a pointer to the same allocated memory as the input vector,
- * effectively creating a reference (shallow) copy.
+ * effectively creating a reference (shallow) copy. The copy is marked VECTOR_STORAGE_ALIAS: freeing
+ * it releases only its header, and it must not outlive the vector it was copied from.
  *
  * @param vector Input vector
  * @return A pointer to the shallow copied vector
@@ -238,8 +357,10 @@ float vector_mean(const vector_t* vector);
  * m(n + 1) = (1 - α) m(n) + α x(n + 1)
  *
  * @param vector Input vector
- * @param alpha Smoothing factor for the low-pass filter
- * @return The low-pass filtered mean of the vector
+ * @param alpha Smoothing factor for the low-pass filter, in (0, 1]
+ * @return The low-pass filtered mean of the vector, or NaN for invalid input
+ *
+ * @note Use stats_t from stats.h to filter a stream fed in chunks.
  *
  * References:
  * https://www.cs.princeton.edu/courses/archive/fall08/cos436/Duda/PR_learn/mean.htm
@@ -315,4 +436,81 @@ vector_t* vector_polar_to_cartesian(const vector_t* polar_vector);
  */
 vector_t* vector_cartesian_to_polar(const vector_t* cartesian_vector);
 
+/**
+ * @brief Convert arrays of polar coordinates to cartesian coordinates
+ *
+ * Converts count points stored as separate arrays, such as the axes of a vector_batch_t, in one
+ * pass. With approximate set, sin and cos are evaluated by SIMD polynomials selected at runtime
+ * (maximum absolute error 1e-7 for |θ| ≤ 1000, see simd.h). Otherwise libm cosf and sinf are used
+ * and the results match vector_polar_to_cartesian() exactly.
+ *
+ * @param radii Input radii r
+ * @param angles Input angles θ in radians
+ * @param xs Output x = r cos θ
+ * @param ys Output y = r sin θ
+ * @param count Number of points
+ * @param approximate Boolean flag selecting the SIMD polynomial path
+ */
+void vector_polar_to_cartesian_array(
+    const float* radii, const float* angles, float* xs, float* ys, size_t count, bool approximate
+);
+
+/**
+ * @brief Convert arrays of cartesian coordinates to polar coordinates
+ *
+ * With approximate set, atan2 is evaluated by a SIMD polynomial selected at runtime (maximum
+ * absolute error 3e-7 radians, see simd.h). Otherwise libm atan2f is used and the results match
+ * vector_cartesian_to_polar() exactly.
+ *
+ * @param xs Input x coordinates
+ * @param ys Input y coordinates
+ * @param radii Output radii r = √(x^2 + y^2)
+ * @param angles Output angles θ = atan2(y, x)
+ * @param count Number of points
+ * @param approximate Boolean flag selecting the SIMD polynomial path
+ */
+void vector_cartesian_to_polar_array(
+    const float* xs, const float* ys, float* radii, float* angles, size_t count, bool approximate
+);
+
+// Out-parameter vector operations
+
+/**
+ * @brief Allocation-free variants of the vector operations
+ *
+ * Each function mirrors the allocating operation of the same name, but writes its result into a
+ * caller-supplied destination vector instead of calling vector_create(). The destination must have
+ * the expected number of dimensions and may alias any input, so passing the same vector as both
+ * destination and input performs the operation in place. A chain of these calls over preallocated
+ * vectors never touches the heap.
+ *
+ * @return dst on success, NULL if an input is invalid or the dimensions do not match
+ */
+vector_t* vector_copy_into(vector_t* dst, const vector_t* src);
+
+vector_t* vector_scalar_add_into(vector_t* dst, const vector_t* a, const float b);
+vector_t* vector_scalar_subtract_into(vector_t* dst, const vector_t* a, const float b);
+vector_t* vector_scalar_multiply_into(vector_t* dst, const vector_t* a, const float b);
+vector_t* vector_scalar_divide_into(vector_t* dst, const vector_t* a, const float b);
+
+vector_t* vector_vector_add_into(vector_t* dst, const vector_t* a, const vector_t* b);
+vector_t* vector_vector_subtract_into(vector_t* dst, const vector_t* a, const vector_t* b);
+vector_t* vector_vector_multiply_into(vector_t* dst, const vector_t* a, const vector_t* b);
+vector_t* vector_vector_divide_into(vector_t* dst, const vector_t* a, const vector_t* b);
+
+vector_t* vector_normalize_into(vector_t* dst, const vector_t* vector);
+vector_t* vector_scale_into(vector_t* dst, const vector_t* vector, float scalar);
+vector_t* vector_clip_into(vector_t* dst, const vector_t* vector, float min, float max);
+
+/**
+ * @note dst must be 3-dimensional; it may alias a or b.
+ */
+vector_t* vector_cross_product_into(vector_t* dst, const vector_t* a, const vector_t* b);
+
+/**
+ * @note dst must be 2-dimensional; it may alias the input vector.
+ */
+vector_t* vector_polar_to_cartesian_into(vector_t* dst, const vector_t* polar_vector);
+vector_t* vector_cartesian_to_polar_into(vector_t* dst, const vector_t* cartesian_vector);
+
 #endif // VECTORS_H